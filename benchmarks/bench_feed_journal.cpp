@@ -0,0 +1,131 @@
+// Cost of recording the feed: append latency of the journal on its own (back to back and
+// paced at 100k messages/s, the rate a busy session peaks at) and the added per-message
+// cost inside the orderbook manager with raw recording on.
+#include "feed_journal.hpp"
+#include "orderbook.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace polymarket;
+
+namespace
+{
+    constexpr int MESSAGES = 500000;
+    constexpr int PACED_MESSAGES = 200000;
+    constexpr int RATE_PER_SEC = 100000;
+
+    std::string make_message(const std::string &token, int i)
+    {
+        std::string asks;
+        for (int level = 0; level < 10; level++)
+        {
+            asks += (level ? "," : "") + std::string("{\"price\":\"0.") + std::to_string(45 + (i + level) % 50) +
+                    "\",\"size\":\"" + std::to_string(50 + level * 10) + "\"}";
+        }
+        return "{\"event_type\":\"book\",\"market\":\"0xbench\",\"asset_id\":\"" + token +
+               "\",\"bids\":[{\"price\":\"0.40\",\"size\":\"100\"}],\"asks\":[" + asks + "]}";
+    }
+
+    void print_percentiles(const char *label, std::vector<uint64_t> &samples)
+    {
+        std::sort(samples.begin(), samples.end());
+        auto at = [&samples](double q)
+        { return samples[std::min(samples.size() - 1, static_cast<size_t>(q * samples.size()))]; };
+        std::cout << std::left << std::setw(28) << label << " p50=" << at(0.50) << "ns p99=" << at(0.99)
+                  << "ns p99.9=" << at(0.999) << "ns max=" << samples.back() << "ns" << std::endl;
+    }
+} // namespace
+
+int main()
+{
+    auto directory = (std::filesystem::temp_directory_path() / ("bench_feed_journal_" + std::to_string(getpid()))).string();
+    std::vector<std::string> messages;
+    for (int i = 0; i < 1000; i++)
+    {
+        messages.push_back(make_message(i % 2 ? "yes-token" : "no-token", i));
+    }
+
+    Config config;
+    config.journal_segment_bytes = 256 * 1024 * 1024;
+
+    // Back to back: throughput bound
+    {
+        std::filesystem::remove_all(directory);
+        FeedJournal journal(config);
+        journal.open(directory);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < MESSAGES; i++)
+        {
+            journal.append_raw(FeedSource::CLOB, 0, now_ns(), messages[i % messages.size()]);
+        }
+        double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        journal.close();
+        auto stats = journal.stats();
+        std::cout << "back-to-back append: " << std::fixed << std::setprecision(1) << elapsed / MESSAGES << " ns/msg, "
+                  << stats.bytes / (elapsed / 1e9) / 1e6 << " MB/s, dropped " << stats.dropped
+                  << ", segments " << stats.segments << std::endl;
+    }
+
+    // Paced at 100k/s: latency the feed thread sees per message
+    {
+        std::filesystem::remove_all(directory);
+        FeedJournal journal(config);
+        journal.open(directory);
+        std::vector<uint64_t> samples;
+        samples.reserve(PACED_MESSAGES);
+        auto interval = std::chrono::nanoseconds(1000000000 / RATE_PER_SEC);
+        auto next = std::chrono::steady_clock::now();
+        for (int i = 0; i < PACED_MESSAGES; i++)
+        {
+            while (std::chrono::steady_clock::now() < next)
+            {
+            }
+            next += interval;
+            uint64_t t0 = now_ns();
+            journal.append_raw(FeedSource::CLOB, 0, t0, messages[i % messages.size()]);
+            samples.push_back(now_ns() - t0);
+        }
+        journal.close();
+        print_percentiles("paced append (100k/s):", samples);
+    }
+
+    // Inside the manager: decode + store + publish, with and without recording
+    {
+        MarketState market;
+        market.condition_id = "0xbench";
+        market.token_yes = "yes-token";
+        market.token_no = "no-token";
+        config.strategy_threads = 0; // Callbacks (none) inline on the injecting thread
+        for (bool record : {false, true})
+        {
+            std::filesystem::remove_all(directory);
+            FeedJournal journal(config);
+            journal.open(directory);
+            OrderbookManager manager(config);
+            if (record)
+            {
+                manager.set_journal(&journal);
+            }
+            manager.subscribe(market);
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < MESSAGES; i++)
+            {
+                manager.inject_message(FeedSource::CLOB, messages[i % messages.size()]);
+            }
+            double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            journal.close();
+            std::cout << "inject_message " << (record ? "recording:" : "plain:    ") << " " << std::fixed
+                      << std::setprecision(1) << elapsed / MESSAGES << " ns/msg" << std::endl;
+        }
+    }
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
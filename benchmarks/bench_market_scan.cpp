@@ -0,0 +1,122 @@
+// Full-table arb scan over 10k synthetic markets: per-market LiveMarketState checks against
+// the structure-of-arrays MarketTable with each available kernel.
+#include "market_table.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+using namespace polymarket;
+
+namespace
+{
+    constexpr size_t MARKETS = 10000;
+    constexpr int ITERATIONS = 2000;
+
+    template <typename Fn>
+    double time_per_scan_ns(Fn &&scan)
+    {
+        size_t sink = 0;
+        for (int i = 0; i < ITERATIONS / 10; i++)
+        {
+            sink += scan(); // Warm caches and branch predictors
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; i++)
+        {
+            sink += scan();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        if (sink == 0)
+        {
+            std::cerr << "[Bench] No hits; filter is too strict" << std::endl;
+        }
+        return std::chrono::duration<double, std::nano>(elapsed).count() / ITERATIONS;
+    }
+
+    void report(const char *name, double ns, size_t hits)
+    {
+        std::cout << "  " << std::left << std::setw(24) << name
+                  << std::right << std::fixed << std::setprecision(1) << std::setw(10) << ns / 1000.0 << " us/scan"
+                  << std::setprecision(2) << std::setw(8) << ns / MARKETS << " ns/market"
+                  << "  hits=" << hits << std::endl;
+    }
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> price(0.40, 0.60);
+    std::uniform_real_distribution<double> size(0.0, 200.0);
+    std::uniform_int_distribution<uint64_t> age_ns(0, 2000000000ULL);
+    const uint64_t now = 10000000000ULL;
+
+    MarketScanFilter filter;
+    filter.max_combined = 0.92;
+    filter.min_size = 10.0;
+    filter.max_age_ns = 1000000000ULL;
+    filter.now_ns = now;
+
+    // Same data in both layouts
+    MarketTable table(MARKETS);
+    std::unordered_map<std::string, std::unique_ptr<LiveMarketState>> markets;
+    for (size_t i = 0; i < MARKETS; i++)
+    {
+        MarketState state;
+        state.condition_id = "0x" + std::to_string(i);
+        auto live = std::make_unique<LiveMarketState>(state);
+        live->table_id = table.assign(state.condition_id);
+
+        double ask_yes = price(rng), ask_no = price(rng);
+        double size_yes = size(rng), size_no = size(rng);
+        uint64_t updated = now - age_ns(rng); // One time for both legs: the quote keeps only the latest
+        live->quote.store(true, ask_yes, size_yes, updated);
+        live->quote.store(false, ask_no, size_no, updated);
+        table.store(live->table_id, true, ask_yes, size_yes, updated);
+        table.store(live->table_id, false, ask_no, size_no, updated);
+        markets.emplace(state.condition_id, std::move(live));
+    }
+
+    std::cout << "[Bench] " << MARKETS << " markets, " << ITERATIONS << " scans, filter combined < "
+              << filter.max_combined << ", size >= " << filter.min_size << ", age <= 1s" << std::endl;
+
+    // Baseline: the per-market check the callbacks do, applied to every market
+    size_t hits = 0;
+    const uint64_t cutoff = now - filter.max_age_ns;
+    double ns = time_per_scan_ns([&]()
+                                 {
+        hits = 0;
+        for (const auto &[condition_id, market] : markets)
+        {
+            auto quote = market->quote.load();
+            if (quote.complete() && quote.combined() < filter.max_combined &&
+                quote.ask_yes_size >= filter.min_size && quote.ask_no_size >= filter.min_size &&
+                quote.last_update_ns >= cutoff)
+            {
+                hits++;
+            }
+        }
+        return hits; });
+    report("per-market (seqlock)", ns, hits);
+
+    std::vector<uint32_t> found;
+    found.reserve(MARKETS);
+    for (auto kernel : {ScanKernel::SCALAR, ScanKernel::AVX2, ScanKernel::AVX512})
+    {
+        if (!MarketTable::kernel_supported(kernel))
+        {
+            std::cout << "  " << MarketTable::kernel_name(kernel) << ": not supported on this CPU" << std::endl;
+            continue;
+        }
+        ns = time_per_scan_ns([&]()
+                              {
+            found.clear();
+            return table.scan(filter, found, kernel); });
+        report((std::string("table (") + MarketTable::kernel_name(kernel) + ")").c_str(), ns, found.size());
+    }
+
+    return 0;
+}
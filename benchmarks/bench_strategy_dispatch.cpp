@@ -0,0 +1,181 @@
+// Per-message cost of the strategy hooks: the same CLOB book stream decoded by an
+// OrderbookManager with std::function callbacks and by a BasicOrderbookManager whose
+// strategy hooks are resolved (and inlined) at compile time.
+#include "orderbook_impl.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace polymarket;
+
+namespace
+{
+    constexpr int MESSAGES = 200000;
+    constexpr int ROUNDS = 5;
+
+    struct Counters
+    {
+        uint64_t books = 0;
+        uint64_t tops = 0;
+        uint64_t arbs = 0;
+        volatile double sink = 0.0; // Every hook stores here, so inlined hook loops cannot fold away
+    };
+
+    // Same work as the callbacks below, but visible to the compiler
+    struct CountingStrategy
+    {
+        Counters *counters = nullptr;
+
+        void on_book(const std::string &, const Orderbook &book)
+        {
+            counters->books++;
+            counters->sink = book.best_ask();
+        }
+        void on_top_of_book_change(const std::string &, const QuoteSnapshot &top)
+        {
+            counters->tops++;
+            counters->sink = top.ask_yes;
+        }
+        void on_arb(const ArbSignal &signal)
+        {
+            counters->arbs++;
+            counters->sink = signal.combined;
+        }
+    };
+
+    // Alternating YES/NO snapshots; the best ask walks so tops change and some pairs clear
+    std::vector<std::string> make_messages(const MarketState &market)
+    {
+        std::vector<std::string> messages;
+        messages.reserve(MESSAGES);
+        for (int i = 0; i < MESSAGES; i++)
+        {
+            bool yes = i % 2 == 0;
+            int best = 45 + (i / 2) % 8; // 0.45 .. 0.52
+            std::string asks;
+            for (int level = 0; level < 10; level++)
+            {
+                asks += (level ? "," : "") + std::string("{\"price\":\"0.") + std::to_string(best + level) +
+                        "\",\"size\":\"" + std::to_string(50 + level * 10) + "\"}";
+            }
+            messages.push_back("{\"event_type\":\"book\",\"market\":\"" + market.condition_id + "\",\"asset_id\":\"" +
+                               (yes ? market.token_yes : market.token_no) + "\",\"bids\":[{\"price\":\"0.40\",\"size\":\"100\"}]" +
+                               ",\"asks\":[" + asks + "]}");
+        }
+        return messages;
+    }
+
+    template <typename Manager>
+    double ns_per_message(Manager &manager, const std::vector<std::string> &messages)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (const auto &message : messages)
+        {
+            manager.inject_message(FeedSource::CLOB, message);
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / messages.size();
+    }
+
+    // The hooks alone on already decoded books: the indirection without decode noise
+    template <typename Hooks>
+    double ns_per_hook_pair(Hooks &hooks, const std::vector<Orderbook> &books, const std::string &condition_id)
+    {
+        QuoteSnapshot top;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < MESSAGES; i++)
+        {
+            const auto &book = books[i % books.size()];
+            hooks.on_book(book.asset_id, book);
+            top.ask_yes = book.asks[0].price;
+            hooks.on_top_of_book_change(condition_id, top);
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / MESSAGES;
+    }
+
+    void report(const char *name, double ns, const Counters &counters)
+    {
+        std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(9) << ns << " ns/message  (books=" << counters.books << " tops=" << counters.tops
+                  << " arbs=" << counters.arbs << ")" << std::endl;
+    }
+} // namespace
+
+int main()
+{
+    Config config;
+    config.strategy_threads = 0; // Hooks run inline on the injecting thread
+    config.trigger_combined = 0.98;
+
+    MarketState market;
+    market.condition_id = "0xbench";
+    market.slug = "bench";
+    market.token_yes = "1001";
+    market.token_no = "1002";
+    auto messages = make_messages(market);
+
+    Counters callback_counters;
+    OrderbookManager callbacks(config);
+    callbacks.on_orderbook_update([&callback_counters](const std::string &, const Orderbook &book)
+                                  { callback_counters.books++; callback_counters.sink = book.best_ask(); });
+    callbacks.on_top_of_book_change([&callback_counters](const std::string &, const QuoteSnapshot &top)
+                                    { callback_counters.tops++; callback_counters.sink = top.ask_yes; });
+    callbacks.on_arb_opportunity([&callback_counters](const ArbSignal &signal)
+                                 { callback_counters.arbs++; callback_counters.sink = signal.combined; });
+    callbacks.subscribe(market);
+
+    Counters static_counters;
+    BasicOrderbookManager<CountingStrategy> inlined(config, CountingStrategy{&static_counters});
+    inlined.subscribe(market);
+
+    std::cout << "[Bench] " << MESSAGES << " CLOB book messages (10 ask levels), best of " << ROUNDS
+              << " rounds, decode + book + arb check" << std::endl;
+    // Interleaved rounds so drift in machine state hits both alike; keep each side's best
+    double dynamic_ns = 0.0;
+    double static_ns = 0.0;
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        double ns = ns_per_message(callbacks, messages);
+        dynamic_ns = round == 0 ? ns : std::min(dynamic_ns, ns);
+        ns = ns_per_message(inlined, messages);
+        static_ns = round == 0 ? ns : std::min(static_ns, ns);
+    }
+    report("std::function callbacks", dynamic_ns, callback_counters);
+    report("compile-time strategy", static_ns, static_counters);
+    std::cout << "  difference: " << std::setprecision(1) << dynamic_ns - static_ns << " ns/message" << std::endl;
+
+    std::vector<Orderbook> books;
+    for (size_t i = 0; i < 16; i++)
+    {
+        Orderbook book{};
+        book.asset_id = i % 2 ? market.token_no : market.token_yes;
+        for (int level = 0; level < 10; level++)
+        {
+            book.asks.push_back({0.45 + 0.01 * ((i / 2) % 8 + level), 50.0 + level * 10});
+        }
+        books.push_back(std::move(book));
+    }
+
+    Counters hook_callback_counters;
+    CallbackStrategy callback_hooks;
+    callback_hooks.book = [&hook_callback_counters](const std::string &, const Orderbook &book)
+    { hook_callback_counters.books++; hook_callback_counters.sink = book.best_ask(); };
+    callback_hooks.top_of_book = [&hook_callback_counters](const std::string &, const QuoteSnapshot &top)
+    { hook_callback_counters.tops++; hook_callback_counters.sink = top.ask_yes; };
+    Counters hook_static_counters;
+    CountingStrategy static_hooks{&hook_static_counters};
+
+    dynamic_ns = static_ns = 0.0;
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        double ns = ns_per_hook_pair(callback_hooks, books, market.condition_id);
+        dynamic_ns = round == 0 ? ns : std::min(dynamic_ns, ns);
+        ns = ns_per_hook_pair(static_hooks, books, market.condition_id);
+        static_ns = round == 0 ? ns : std::min(static_ns, ns);
+    }
+    std::cout << "[Bench] on_book + on_top_of_book_change alone, " << MESSAGES << " decoded books" << std::endl;
+    report("std::function callbacks", dynamic_ns, hook_callback_counters);
+    report("compile-time strategy", static_ns, hook_static_counters);
+    return 0;
+}
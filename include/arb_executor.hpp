@@ -0,0 +1,83 @@
+#pragma once
+
+#include "types.hpp"
+#include "mpsc_queue.hpp"
+#include "thread_parker.hpp"
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+namespace polymarket
+{
+
+    using ArbSignalHandler = std::function<void(const ArbSignal &signal)>;
+
+    // The order pair a signal turns into: equal shares on both legs (floored to 0.01), limits
+    // at the deepest ask the sweep touched, rounded up to the tick, plus slippage_ticks of
+    // room for the book to move while the orders are in flight (capped at 1 - tick)
+    struct ArbOrderPlan
+    {
+        double shares = 0.0;
+        double yes_price = 0.0;
+        double no_price = 0.0;
+    };
+
+    ArbOrderPlan plan_arb_orders(const ExecutableEdge &executable, double tick_size = 0.01, int slippage_ticks = 0);
+
+    // Execution statistics
+    struct ExecutorStats
+    {
+        uint64_t posted = 0;   // Accepted into the ring
+        uint64_t dropped = 0;  // Refused because the ring was full
+        uint64_t expired = 0;  // Older than executor_max_signal_age_ms when dequeued
+        uint64_t executed = 0; // Handed to the handler
+        double avg_queue_latency_us = 0.0; // Detection -> handler start
+        double max_queue_latency_us = 0.0;
+    };
+
+    // Owns order execution for arb signals. Feed/strategy threads post() a snapshot into a
+    // lock-free ring and return immediately; one (optionally pinned) thread runs the handler,
+    // which is where signing, HTTP submission and logging belong. The thread spins briefly
+    // on an empty ring, then sleeps until the next post().
+    class ArbExecutor
+    {
+    public:
+        explicit ArbExecutor(const Config &config);
+        ~ArbExecutor();
+
+        // Disable copy
+        ArbExecutor(const ArbExecutor &) = delete;
+        ArbExecutor &operator=(const ArbExecutor &) = delete;
+
+        // Runs on the executor thread; set before start()
+        void on_signal(ArbSignalHandler handler);
+
+        void start();
+        void stop(); // Signals still queued are discarded
+
+        // Any thread, never blocks: false if the ring is full and the signal was dropped
+        bool post(const ArbSignal &signal);
+
+        ExecutorStats stats() const;
+
+    private:
+        Config config_;
+        MpscQueue<ArbSignal> queue_; // Posted to from every feed thread
+        ArbSignalHandler handler_;
+
+        std::thread thread_;
+        ThreadParker parker_; // The executor thread sleeps here while the ring is empty
+        std::atomic<bool> running_{false};
+
+        std::atomic<uint64_t> posted_{0};
+        std::atomic<uint64_t> dropped_{0};
+        std::atomic<uint64_t> expired_{0};
+        std::atomic<uint64_t> executed_{0};
+        std::atomic<uint64_t> latency_ns_total_{0};
+        std::atomic<uint64_t> latency_ns_max_{0};
+
+        void run_loop();
+    };
+
+} // namespace polymarket
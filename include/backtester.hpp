@@ -0,0 +1,118 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace polymarket
+{
+
+    // One point of a parameter sweep
+    struct BacktestParams
+    {
+        double trigger_combined = 0.98;
+        double size_usdc = 5.0;
+        int slippage_ticks = 0;
+        double tick_size = 0.01;
+
+        // Latency: signal -> orders at the exchange, latency_ms plus a uniform [0, jitter_ms)
+        double latency_ms = 50.0;
+        double jitter_ms = 0.0;
+
+        // Partial fills: each ask level at arrival offers fill_ratio of its displayed size
+        // (the rest is taken by faster traders); what is left of an order is cancelled
+        double fill_ratio = 1.0;
+
+        // Per market: no new order pair within cooldown_ms of the last one
+        double cooldown_ms = 1000.0;
+
+        std::string label() const;
+    };
+
+    // One worker's share of the data: one market on one UTC day of one recording
+    struct BacktestUnit
+    {
+        std::string recording;
+        MarketState market;
+        size_t shards = 1;         // As recorded, so the market lands on the same shard
+        FeedMode feed_mode = FeedMode::CLOB;
+        uint64_t day_start_ns = 0; // Signals from [day_start_ns, day_end_ns) are traded; earlier
+        uint64_t day_end_ns = 0;   // events of the market only warm the books up
+    };
+
+    struct BacktestTrade
+    {
+        std::string condition_id;
+        uint64_t signal_ns = 0;  // Receive time of the book that triggered it
+        uint64_t arrival_ns = 0; // When the orders met the book
+        double shares = 0.0;     // Requested per leg
+        double yes_limit = 0.0, no_limit = 0.0;
+        double expected_edge = 0.0; // Executable edge at signal time for those shares
+        double yes_shares = 0.0, yes_cost = 0.0;
+        double no_shares = 0.0, no_cost = 0.0;
+        double pnl = 0.0;        // Matched pairs pay 1; an unmatched excess is marked at the last bid
+
+        double capture() const { return expected_edge > 0.0 ? pnl / expected_edge : 0.0; }
+    };
+
+    struct BacktestResult
+    {
+        uint64_t units = 0;
+        uint64_t signals = 0;       // Arb signals in range
+        uint64_t trades = 0;        // Order pairs sent (after cooldown and rounding)
+        uint64_t full_fills = 0;    // Both legs completely filled
+        uint64_t missed = 0;        // Nothing filled on either leg
+        double requested_shares = 0.0; // Both legs
+        double filled_shares = 0.0;
+        double pairs = 0.0;         // Matched YES + NO shares
+        double cost = 0.0;
+        double locked_pnl = 0.0;    // From matched pairs
+        double residual_pnl = 0.0;  // Unmatched excess marked at the last bid
+        std::vector<double> captures; // Realized / expected edge per trade
+        std::vector<BacktestTrade> trade_log; // Only with BacktestOptions::keep_trades
+
+        double pnl() const { return locked_pnl + residual_pnl; }
+        double fill_rate() const { return requested_shares > 0.0 ? filled_shares / requested_shares : 0.0; }
+        double capture_quantile(double q) const;
+
+        void merge(const BacktestResult &other);
+    };
+
+    struct BacktestOptions
+    {
+        int workers = 0;          // 0 = hardware concurrency
+        bool keep_trades = false; // Fill BacktestResult::trade_log
+    };
+
+    // Event-driven backtest of the binary arb: recorded streams go through the same
+    // OrderbookManager decode, book and arb detection as the live bot, signals through the
+    // same order pricing (plan_arb_orders), and the orders fill against the recorded ask
+    // depth as it stood when they would have arrived. Units run on a pool of workers, each
+    // replaying its market once for every parameter set.
+    class Backtester
+    {
+    public:
+        using ProgressHook = std::function<void(size_t done, size_t total)>;
+
+        Backtester(std::vector<BacktestParams> sweep, BacktestOptions options = {});
+
+        // One unit per market and UTC day it has feed events on, across the recordings
+        static std::vector<BacktestUnit> plan(const std::vector<std::string> &recordings);
+
+        // One aggregated result per parameter set, in sweep order
+        std::vector<BacktestResult> run(const std::vector<BacktestUnit> &units);
+
+        // Every parameter set over one unit (what a worker does)
+        std::vector<BacktestResult> run_unit(const BacktestUnit &unit) const;
+
+        void on_progress(ProgressHook hook) { progress_ = std::move(hook); }
+
+    private:
+        std::vector<BacktestParams> sweep_;
+        BacktestOptions options_;
+        ProgressHook progress_;
+    };
+
+} // namespace polymarket
@@ -12,6 +12,8 @@
 namespace polymarket
 {
 
+    class OrderStore;
+
     // Order types supported by Polymarket
     enum class OrderType
     {
@@ -249,7 +251,10 @@ namespace polymarket
 
         // Order queries
         std::optional<OpenOrder> get_order(const std::string &order_id);
-        std::vector<OpenOrder> get_open_orders(const std::string &market = "");
+        std::vector<OpenOrder> get_open_orders(const std::string &market = ""); // One page; empty on failure
+        // Every page (follows next_cursor); nullopt if any page fails, so an empty result means
+        // no open orders
+        std::optional<std::vector<OpenOrder>> get_all_open_orders(const std::string &market = "");
         std::vector<Trade> get_trades(const std::string &next_cursor = "");
 
         // Balance and allowance
@@ -327,6 +332,9 @@ namespace polymarket
         // TCP keepalive probe interval
         void set_keepalive_interval(long seconds) { http_.set_keepalive_interval(seconds); }
 
+        // Record post and cancel results in a local order store (must outlive the client)
+        void set_order_store(OrderStore *store) { order_store_ = store; }
+
         // ============================================================
         // CONNECTION WARMING (for low-latency trading)
         // ============================================================
@@ -400,6 +408,8 @@ namespace polymarket
         std::unique_ptr<OrderSigner> order_signer_;
         std::unique_ptr<ApiCredentials> api_creds_;
 
+        OrderStore *order_store_ = nullptr;
+
         // Helper methods
         std::map<std::string, std::string> get_l2_headers(const std::string &method,
                                                           const std::string &path,
@@ -414,6 +424,7 @@ namespace polymarket
         OrderResponse parse_order_response(const std::string &json);
         std::vector<OpenOrder> parse_open_orders(const std::string &json);
         std::vector<Trade> parse_trades(const std::string &json);
+        std::vector<std::string> parse_canceled_ids(const std::string &json);
     };
 
 } // namespace polymarket
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "types.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace polymarket
+{
+
+    // On-disk layout of one journal segment (little-endian, fixed-size file while open):
+    //   JournalSegmentHeader                  64 bytes
+    //   records                               JournalRecordHeader + payload, padded to 8
+    //   JournalIndexEntry[index_count]        at index_offset, written when the segment is sealed
+    // A record's size word is stored last (release), so a zero size marks the end of what
+    // has been committed; a segment cut short by a crash still reads up to its last record.
+    struct JournalSegmentHeader
+    {
+        char magic[8];          // "PMJRNL\0\1"
+        uint32_t version;       // 1
+        uint32_t header_bytes;  // sizeof(JournalSegmentHeader)
+        uint64_t sequence;      // Segment number within the journal directory
+        uint64_t created_ns;
+        uint64_t data_end;      // Offset past the last record; 0 until sealed
+        uint64_t record_count;  // 0 until sealed
+        uint64_t index_offset;  // 0 until sealed
+        uint64_t index_count;
+    };
+    static_assert(sizeof(JournalSegmentHeader) == 64);
+
+    enum class JournalRecordKind : uint8_t
+    {
+        RAW = 1,        // WebSocket message as received
+        BOOK = 2,       // Normalized book applied from a feed (encode_journal_book)
+        RESYNC_BOOK = 3, // Normalized book from a REST resync
+        MARKET = 4       // Market subscribed (encode_journal_market): makes a recording replayable
+    };
+
+    struct JournalRecordHeader
+    {
+        uint32_t record_bytes; // Header + payload, before padding; 0 = not committed
+        uint8_t kind;          // JournalRecordKind
+        uint8_t source;        // FeedSource
+        uint16_t shard;
+        uint64_t recv_ns;      // Local receive time (now_ns clock)
+    };
+    static_assert(sizeof(JournalRecordHeader) == 16);
+
+    // One entry every journal_index_interval records: where to start reading for a time
+    struct JournalIndexEntry
+    {
+        uint64_t recv_ns;
+        uint64_t offset;
+    };
+
+    struct JournalRecord
+    {
+        JournalRecordKind kind = JournalRecordKind::RAW;
+        FeedSource source = FeedSource::RTDS;
+        uint16_t shard = 0;
+        uint64_t recv_ns = 0;
+        std::string_view payload; // Points into the mapped segment
+    };
+
+    struct JournalStats
+    {
+        uint64_t records = 0;
+        uint64_t bytes = 0;    // Record bytes including headers and padding
+        uint64_t dropped = 0;  // No room (segment rotation not ready) or record too large
+        uint64_t segments = 0; // Sealed so far
+    };
+
+    // Compact binary form of a book: exchange timestamp, asset id, then bid and ask levels
+    // as (price, size) doubles. BOOK payloads are written in place without allocating.
+    size_t journal_book_bytes(const Orderbook &book);
+    void encode_journal_book(const Orderbook &book, char *out);
+    bool decode_journal_book(std::string_view payload, Orderbook &book);
+    std::string_view journal_book_asset_id(std::string_view payload); // Without decoding levels
+
+    // Identity of a subscribed market: neg_risk flag, then condition id, tokens, slug, symbol
+    // and neg-risk event id as length-prefixed strings
+    std::string encode_journal_market(const MarketState &market);
+    bool decode_journal_market(std::string_view payload, MarketState &market);
+
+    // Append-only market-data recorder. Segments are preallocated files mapped into memory;
+    // any number of feed threads append concurrently without locks: a record reserves its
+    // bytes with one fetch_add, is copied into the mapping and committed by storing its size.
+    // A background thread maps the next segment ahead of time, seals full ones (index,
+    // header, trim) and msyncs asynchronously, so the feed path never touches the disk.
+    class FeedJournal
+    {
+    public:
+        explicit FeedJournal(const Config &config);
+        ~FeedJournal();
+
+        // Disable copy
+        FeedJournal(const FeedJournal &) = delete;
+        FeedJournal &operator=(const FeedJournal &) = delete;
+
+        // Creates the directory if needed; numbering continues after existing segments
+        bool open(const std::string &directory);
+        void close(); // Seals the active segment; call once the feed threads stopped appending
+
+        bool records_raw() const { return mode_ == JournalMode::RAW; }
+        bool records_books() const { return mode_ == JournalMode::BOOKS; }
+
+        // Any thread, never blocks; false if the record was dropped
+        bool append_raw(FeedSource source, size_t shard, uint64_t recv_ns, std::string_view message);
+        bool append_book(JournalRecordKind kind, FeedSource source, size_t shard, const Orderbook &book);
+        bool append_market(size_t shard, uint64_t recv_ns, const MarketState &market); // In either mode
+
+        JournalStats stats() const;
+        const std::string &directory() const { return directory_; }
+
+        static std::string segment_name(uint64_t sequence);
+
+    private:
+        struct Segment
+        {
+            uint64_t sequence = 0;
+            std::string path;
+            int fd = -1;
+            char *base = nullptr;
+            size_t file_bytes = 0;
+            size_t limit = 0; // Records end here; the rest is room for the index
+            alignas(64) std::atomic<uint64_t> reserve{0};
+            alignas(64) std::atomic<uint32_t> writers{0};
+            uint64_t synced = 0; // Flusher only
+        };
+
+        JournalMode mode_;
+        size_t segment_bytes_;
+        size_t index_interval_;
+        int flush_interval_ms_;
+        std::string directory_;
+        uint64_t next_sequence_ = 0;
+
+        std::atomic<Segment *> active_{nullptr};
+        std::atomic<Segment *> spare_{nullptr};
+        std::atomic<bool> rotation_pending_{false};
+        std::vector<std::unique_ptr<Segment>> segments_; // Owned; retired ones stay until close()
+
+        alignas(64) std::atomic<uint64_t> records_{0};
+        std::atomic<uint64_t> bytes_{0};
+        std::atomic<uint64_t> dropped_{0};
+        std::atomic<uint64_t> sealed_{0};
+
+        std::thread flusher_;
+        std::atomic<bool> running_{false};
+        std::mutex wake_mutex_;
+        std::condition_variable wake_;
+
+        template <typename Fill>
+        bool append(JournalRecordKind kind, FeedSource source, size_t shard, uint64_t recv_ns,
+                    size_t payload_bytes, Fill &&fill);
+        void rotate(); // By the writer whose record did not fit
+
+        Segment *create_segment(); // Flusher (and open) only
+        void seal(Segment &segment);
+        void flusher_loop();
+    };
+
+    // Sequential reader over one segment; also follows a segment that is still being written
+    class JournalReader
+    {
+    public:
+        JournalReader() = default;
+        ~JournalReader();
+
+        JournalReader(const JournalReader &) = delete;
+        JournalReader &operator=(const JournalReader &) = delete;
+
+        bool open(const std::string &path);
+        void close();
+
+        // Next committed record; false at the end (of what is committed so far)
+        bool next(JournalRecord &record);
+
+        // Position at the first record received at or after recv_ns (index assisted)
+        void seek(uint64_t recv_ns);
+        void rewind();
+
+        const JournalSegmentHeader &header() const { return header_; }
+        bool sealed() const { return header_.data_end != 0; }
+
+        // Segment files of a journal directory, in order
+        static std::vector<std::string> segments(const std::string &directory);
+
+    private:
+        JournalSegmentHeader header_{};
+        const char *base_ = nullptr;
+        size_t size_ = 0;
+        size_t offset_ = 0;
+        int fd_ = -1;
+
+        size_t end() const;
+    };
+
+} // namespace polymarket
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "types.hpp"
+#include "feed_journal.hpp"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace polymarket
+{
+
+    // One recorded event, whatever the recording format
+    struct ReplayEvent
+    {
+        JournalRecordKind kind = JournalRecordKind::RAW;
+        FeedSource source = FeedSource::CLOB;
+        uint16_t shard = 0;
+        uint64_t recv_ns = 0;     // 0 = not recorded (bare JSONL line)
+        std::string_view payload; // Valid until the next call to next()
+    };
+
+    // When a market's tokens had feed events
+    struct ReplayActivity
+    {
+        uint64_t events = 0;
+        uint64_t first_ns = 0;
+        uint64_t last_ns = 0;
+    };
+
+    // What a recording holds, from one pass over it before replaying
+    struct ReplayManifest
+    {
+        std::vector<MarketState> markets;     // Subscriptions, in recorded order
+        std::vector<ReplayActivity> activity; // Per entry of markets
+        size_t shards = 1;                // Highest recorded shard + 1
+        bool rtds = false;                // Messages of each feed present
+        bool clob = false;
+        uint64_t events = 0;
+        uint64_t first_ns = 0;
+        uint64_t last_ns = 0;
+    };
+
+    // Reads a recording as a stream of events:
+    //   - a journal directory (every segment, in order) or a single journal segment file
+    //   - a JSONL capture, one event per line:
+    //       {"recv_ns": 1700000000000000000, "source": "clob", "shard": 0, "msg": {...} or "..."}
+    //       {"recv_ns": ..., "market": {"condition_id": ..., "token_yes": ..., "token_no": ..., "slug": ...}}
+    //     or a bare WebSocket message (CLOB, no receive time)
+    class ReplaySource
+    {
+    public:
+        ReplaySource() = default;
+
+        ReplaySource(const ReplaySource &) = delete;
+        ReplaySource &operator=(const ReplaySource &) = delete;
+
+        bool open(const std::string &path);
+        void close();
+
+        // Next event; false at the end. Malformed JSONL lines are skipped and counted
+        bool next(ReplayEvent &event);
+        void rewind();
+
+        // Full pass (then rewinds): markets, shard count, time span
+        ReplayManifest scan();
+
+        uint64_t malformed() const { return malformed_; }
+
+    private:
+        std::string path_;
+        bool jsonl_ = false;
+
+        std::vector<std::string> segments_;
+        size_t segment_ = 0;
+        JournalReader reader_;
+
+        std::ifstream file_;
+        std::string line_;
+        std::string payload_; // Re-serialized message or encoded market of the current line
+        uint64_t malformed_ = 0;
+
+        bool next_jsonl(ReplayEvent &event);
+        bool parse_line(ReplayEvent &event);
+    };
+
+    enum class ReplayPacing
+    {
+        ORIGINAL, // Recorded gaps between receive times, scaled by ReplayOptions::speed
+        MAX_SPEED // Back to back
+    };
+
+    struct ReplayOptions
+    {
+        ReplayPacing pacing = ReplayPacing::MAX_SPEED;
+        double speed = 1.0;                         // ORIGINAL: 2.0 replays twice as fast
+        uint64_t from_ns = 0;                       // Skip feed events received before this (0 = start)
+        uint64_t until_ns = 0;                      // Stop at events received after this (0 = end)
+        std::vector<MarketState> markets;           // Subscribed before the first event (recordings without markets)
+        std::vector<std::string> tokens;            // Non-empty: only these tokens' events and markets are replayed
+    };
+
+    struct ReplayStats
+    {
+        uint64_t events = 0;
+        uint64_t messages = 0; // Raw messages injected
+        uint64_t books = 0;    // Decoded books injected (books journals and resyncs)
+        uint64_t markets = 0;  // Subscriptions replayed
+        uint64_t malformed = 0;
+        uint64_t first_ns = 0;
+        uint64_t last_ns = 0;
+        double wall_sec = 0.0;
+        uint64_t max_behind_ns = 0; // ORIGINAL: worst lag behind the recorded schedule
+
+        double recorded_sec() const { return last_ns > first_ns ? (last_ns - first_ns) / 1e9 : 0.0; }
+        double events_per_sec() const { return wall_sec > 0.0 ? events / wall_sec : 0.0; }
+    };
+
+    // Drives an orderbook manager from a recording on the calling thread. The manager's clock
+    // is the receive time of the event being replayed, so book timestamps, staleness and
+    // latency are those of the recording and a replay at any speed produces the same books.
+    class FeedReplay
+    {
+    public:
+        using EventHook = std::function<void(const ReplayEvent &event)>;
+
+        explicit FeedReplay(ReplayOptions options = {});
+
+        // Replay time, for BasicOrderbookManager::set_clock (run() installs it)
+        uint64_t now_ns() const { return now_ns_.load(std::memory_order_relaxed); }
+        std::function<uint64_t()> clock() const
+        {
+            return [this]()
+            { return now_ns(); };
+        }
+
+        // Called after each event is applied (before the next is paced), and before one is
+        // applied once the clock reached its receive time
+        void on_event(EventHook hook) { after_event_ = std::move(hook); }
+        void before_event(EventHook hook) { before_event_ = std::move(hook); }
+
+        // Works with any BasicOrderbookManager<Strategy>; returns when the source is drained
+        // or stop() was called
+        template <typename Manager>
+        ReplayStats run(ReplaySource &source, Manager &manager);
+
+        void stop() { running_.store(false); }
+
+    private:
+        ReplayOptions options_;
+        EventHook after_event_;
+        EventHook before_event_;
+        std::vector<std::string> token_patterns_; // "\"<token>\"" for each filtered token
+        std::atomic<uint64_t> now_ns_{0};
+        std::atomic<bool> running_{false};
+
+        uint64_t started_ns_ = 0;
+
+        // ORIGINAL pacing: wall time of the first paced event, and its receive time
+        uint64_t wall_start_ns_ = 0;
+        uint64_t recorded_start_ns_ = 0;
+
+        void begin();
+        // Moves the clock to the event, applies the time range and pacing; false = skip it
+        bool advance(const ReplayEvent &event, ReplayStats &stats);
+        bool wanted(const ReplayEvent &event) const; // Token filter
+        void finish(const ReplaySource &source, ReplayStats &stats);
+    };
+
+    template <typename Manager>
+    ReplayStats FeedReplay::run(ReplaySource &source, Manager &manager)
+    {
+        ReplayStats stats;
+        manager.set_clock(clock());
+        begin();
+        for (const auto &market : options_.markets)
+        {
+            manager.subscribe(market);
+        }
+
+        ReplayEvent event;
+        Orderbook book;
+        MarketState market;
+        while (running_.load(std::memory_order_relaxed) && source.next(event))
+        {
+            if (!wanted(event) || !advance(event, stats))
+            {
+                continue;
+            }
+            if (before_event_)
+            {
+                before_event_(event);
+            }
+
+            switch (event.kind)
+            {
+            case JournalRecordKind::RAW:
+                manager.inject_message(event.source, event.payload, event.shard);
+                stats.messages++;
+                break;
+            case JournalRecordKind::BOOK:
+            case JournalRecordKind::RESYNC_BOOK:
+                if (decode_journal_book(event.payload, book))
+                {
+                    book.timestamp_ns = event.recv_ns;
+                    manager.inject_book(event.source, book, event.shard);
+                    stats.books++;
+                }
+                break;
+            case JournalRecordKind::MARKET:
+                if (decode_journal_market(event.payload, market))
+                {
+                    manager.subscribe(market);
+                    stats.markets++;
+                }
+                break;
+            }
+            stats.events++;
+
+            if (after_event_)
+            {
+                after_event_(event);
+            }
+        }
+
+        finish(source, stats);
+        return stats;
+    }
+
+} // namespace polymarket
@@ -7,6 +7,7 @@
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <memory>
 #include <curl/curl.h>
 
 namespace polymarket
@@ -24,6 +25,9 @@ namespace polymarket
     };
 
     // High-performance HTTP client using libcurl
+    // All instances attach to a process-wide CURLSH handle, so DNS lookups, TLS
+    // sessions and idle connections are shared between clients for the same host.
+    // Requests on one instance are serialized; use separate instances for parallelism.
     class HttpClient
     {
     public:
@@ -66,6 +70,7 @@ namespace polymarket
         {
             long total_requests;
             long reused_connections;
+            long new_connections; // Requests that had to open a fresh TCP/TLS connection
             double avg_latency_ms;
             double last_latency_ms;
             bool connection_warm;
@@ -90,19 +95,27 @@ namespace polymarket
         mutable std::mutex stats_mutex_;
         long total_requests_;
         long reused_connections_;
+        long new_connections_;
         double total_latency_ms_;
         double last_latency_ms_;
         bool connection_warm_;
 
         void init();
         void cleanup();
-        HttpResponse perform(const std::string &url);
+        HttpResponse perform(const char *method, const std::string &path,
+                             const std::string *body, struct curl_slist *headers);
+        HttpResponse perform_with_headers(const char *method, const std::string &path, const std::string *body,
+                                          const std::map<std::string, std::string> &custom_headers);
 
         static size_t write_callback(char *ptr, size_t size, size_t nmemb, void *userdata);
     };
 
     // Global initialization (call once at startup)
     void http_global_init();
-    void http_global_cleanup();
+    void http_global_cleanup(); // Also releases clients held by shared_http_client()
+
+    // Process-wide client registry keyed by base URL (e.g. Gamma, Data API).
+    // The first caller for a URL decides its timeout; later callers get the same warm client.
+    std::shared_ptr<HttpClient> shared_http_client(const std::string &base_url, long timeout_ms = 10000);
 
 } // namespace polymarket
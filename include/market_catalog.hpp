@@ -0,0 +1,120 @@
+#pragma once
+
+#include "types.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+namespace polymarket
+{
+
+    // On-disk layout (native endianness, all offsets from file start):
+    //   CatalogHeader | string pool | CatalogRecord[record_count]
+    //   | uint32 index sorted by condition_id | uint32 index sorted by slug
+    // Strings are interned once in the pool and referenced by (offset, length).
+    struct CatalogStringRef
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct CatalogRecord
+    {
+        CatalogStringRef condition_id;
+        CatalogStringRef slug;
+        CatalogStringRef title;
+        CatalogStringRef symbol;
+        CatalogStringRef token_yes;
+        CatalogStringRef token_no;
+        uint32_t flags; // CATALOG_FLAG_*
+        uint32_t reserved;
+    };
+    static_assert(sizeof(CatalogRecord) == 56, "CatalogRecord must stay fixed-size");
+
+    constexpr uint32_t CATALOG_FLAG_NEG_RISK = 1u << 0;
+
+    struct CatalogHeader
+    {
+        char magic[8]; // "PMCATLG\0"
+        uint32_t version;
+        uint32_t record_count;
+        uint64_t strings_offset;
+        uint64_t strings_size;
+        uint64_t records_offset;
+        uint64_t condition_index_offset;
+        uint64_t slug_index_offset;
+    };
+
+    // Persistent market catalog for fast warm starts.
+    // The file is memory-mapped read-only; markets discovered at runtime go into an
+    // in-memory overlay that is merged into a new file by save() (or the auto-save thread).
+    class MarketCatalog
+    {
+    public:
+        MarketCatalog() = default;
+        ~MarketCatalog();
+
+        // Disable copy
+        MarketCatalog(const MarketCatalog &) = delete;
+        MarketCatalog &operator=(const MarketCatalog &) = delete;
+
+        // Map an existing catalog file; returns false if missing or corrupt (catalog stays usable)
+        bool load(const std::string &path);
+
+        // Merge overlay with the mapped file, write atomically (tmp + rename) and remap
+        bool save(const std::string &path);
+
+        // Lookups (overlay first, then binary search over the mapped index)
+        std::optional<MarketState> find_by_condition(const std::string &condition_id) const;
+        std::optional<MarketState> find_by_slug(const std::string &slug) const;
+
+        // Record a newly discovered market (no-op if already known)
+        void upsert(const MarketState &market);
+
+        std::vector<MarketState> all() const;
+        size_t size() const;
+        bool dirty() const { return dirty_.load(); }
+
+        // Background incremental refresh: periodically persist newly discovered markets
+        void start_auto_save(const std::string &path, long interval_seconds = 30);
+        void stop_auto_save();
+
+    private:
+        // Mapped file
+        const char *map_ = nullptr;
+        size_t map_size_ = 0;
+        const CatalogHeader *header_ = nullptr;
+        const CatalogRecord *records_ = nullptr;
+        const uint32_t *condition_index_ = nullptr;
+        const uint32_t *slug_index_ = nullptr;
+
+        // Markets not yet persisted, keyed by condition_id
+        std::unordered_map<std::string, MarketState> overlay_;
+        std::unordered_map<std::string, std::string> overlay_slugs_; // slug -> condition_id
+
+        mutable std::shared_mutex mutex_;
+        std::mutex write_mutex_; // Serializes save()
+        std::atomic<bool> dirty_{false};
+
+        // Auto-save thread
+        std::thread save_thread_;
+        std::mutex save_mutex_;
+        std::condition_variable save_cv_;
+        bool save_running_ = false;
+
+        void unmap();
+        std::string_view view(const CatalogStringRef &ref) const;
+        MarketState to_market_state(const CatalogRecord &record) const;
+        const CatalogRecord *find_mapped(const uint32_t *index, CatalogStringRef CatalogRecord::*key,
+                                         std::string_view value) const;
+    };
+
+} // namespace polymarket
@@ -2,12 +2,17 @@
 
 #include "types.hpp"
 #include "http_client.hpp"
+#include "market_catalog.hpp"
 #include <vector>
 #include <optional>
+#include <functional>
 
 namespace polymarket
 {
 
+    // Catalog filter applied while a page is decoded; return false to skip the market
+    using MarketFilter = std::function<bool(const ClobMarket &)>;
+
     // Market fetcher for Polymarket REST APIs
     class MarketFetcher
     {
@@ -17,9 +22,18 @@ namespace polymarket
 
         // Fetch markets from CLOB API
         std::vector<ClobMarket> fetch_all_markets(int max_markets = 100);
+
+        // Up to max_markets, plus every other condition of the neg-risk events among them;
+        // neg_risk_outcomes is set once the whole catalog was paged
         std::vector<ClobMarket> fetch_neg_risk_markets(int max_markets = 50);
         std::optional<ClobMarket> fetch_market(const std::string &condition_id);
 
+        // Streaming catalog load: each /markets page is parsed once, the next cursor is
+        // requested while the current page is decoded, and paging stops at max_markets matches.
+        // complete (optional) is set when paging reached the last page without an error
+        std::vector<ClobMarket> stream_markets(size_t max_markets, const MarketFilter &filter = nullptr,
+                                               bool *complete = nullptr);
+
         // Fetch orderbook
         std::optional<Orderbook> fetch_orderbook(const std::string &token_id);
 
@@ -31,9 +45,24 @@ namespace polymarket
         // Convert ClobMarket to MarketState
         static MarketState to_market_state(const ClobMarket &market);
 
+        // Resolve known slugs from a persistent catalog; only unseen slugs hit Gamma
+        // and newly discovered markets are added to it (catalog must outlive the fetcher)
+        void set_catalog(MarketCatalog *catalog) { catalog_ = catalog; }
+
     private:
         Config config_;
         HttpClient http_;
+        MarketCatalog *catalog_ = nullptr;
+
+        // One Gamma /events lookup; ticker is stamped onto the resulting MarketState
+        struct SlugRequest
+        {
+            std::string slug;
+            std::string ticker;
+        };
+
+        // Resolve slugs concurrently (bounded by gamma_max_in_flight), preserving request order
+        std::vector<MarketState> fetch_gamma_slugs(const std::vector<SlugRequest> &requests);
 
         // Timestamp generation for crypto markets
         std::vector<uint64_t> get_15m_timestamps(int count);
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "types.hpp"
+#include "order_signer.hpp"
+#include "timer_wheel.hpp"
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace polymarket
+{
+
+    // Where one window is in its life:
+    //   PENDING     discovered, trading parameters not fetched yet
+    //   PREFETCHED  tick size / neg_risk known, order templates built; waiting for its
+    //               subscribe time (market_presubscribe_sec before the window starts)
+    //   SUBSCRIBED  streaming, waiting for a book on both legs
+    //   WARM        books on both legs; standby while an earlier window of its series trades
+    //   TRADING     the series' active window: signals for it may be executed
+    //   EXPIRED     inside expire_lead of its close; unsubscribed and dropped, and the next
+    //               warm window of the series takes over in the same step
+    enum class MarketPhase
+    {
+        PENDING,
+        PREFETCHED,
+        SUBSCRIBED,
+        WARM,
+        TRADING,
+        EXPIRED
+    };
+
+    const char *market_phase_name(MarketPhase phase);
+
+    struct MarketSession
+    {
+        MarketState market;
+        std::string timeframe; // "15m", "1h", "4h"; empty for markets without a window
+        std::string series;    // symbol + timeframe: consecutive windows of one series roll over
+        uint64_t start_ms = 0;  // 0 = unknown
+        uint64_t expiry_ms = 0; // 0 = never expires (computed once, at discovery)
+        MarketPhase phase = MarketPhase::PENDING;
+
+        // Filled by the prefetch hook; defaults match the crypto up/down markets
+        std::string tick_size = "0.01";
+        bool neg_risk = true;
+        std::string exchange;  // Contract orders are signed against
+        OrderData order_yes{}; // Everything but the amounts, so a signal only prices and signs
+        OrderData order_no{};
+
+        uint64_t discovered_ms = 0;
+        uint64_t trading_since_ms = 0;
+    };
+
+    struct LifecycleCounts
+    {
+        size_t pending = 0; // PENDING and PREFETCHED
+        size_t subscribed = 0;
+        size_t warm = 0;
+        size_t trading = 0;
+        uint64_t expired_total = 0;  // Since construction
+        uint64_t rollovers_total = 0; // Expiries whose successor was already warm
+    };
+
+    // Per-market state machines for every window a bot watches at once. Each window's
+    // deadlines (subscribe, look for a successor, expire) are computed once when it is added
+    // and parked on a timing wheel, so advance() pays for the timers that are due, not for
+    // every window. The successor of a series is discovered, subscribed and warmed minutes
+    // before its predecessor closes, and the switch from one to the other happens under one
+    // lock: tradable() is never true for both, nor (with a warm successor) for neither.
+    //
+    // The owner feeds it discovered markets and calls add()/advance() from one thread; the
+    // hooks do the I/O. session() and tradable() are safe from any thread.
+    class MarketLifecycle
+    {
+    public:
+        // false = retry next advance. Called from up to market_prefetch_workers threads at
+        // once, each with its own session.
+        using PrefetchHook = std::function<bool(MarketSession &session)>;
+        using SubscribeHook = std::function<void(const std::vector<MarketState> &markets)>;
+        using UnsubscribeHook = std::function<void(const std::vector<std::string> &condition_ids)>;
+        using WarmCheck = std::function<bool(const MarketSession &session)>; // Both legs have a book
+        using SuccessorHook = std::function<void(const std::string &timeframe)>; // Discover the next windows
+
+        explicit MarketLifecycle(const Config &config);
+
+        // Set before the first advance(); a missing hook makes its step immediate
+        void on_prefetch(PrefetchHook hook);
+        void on_subscribe(SubscribeHook hook);
+        void on_unsubscribe(UnsubscribeHook hook);
+        void on_warm_check(WarmCheck hook);
+        void on_successor_needed(SuccessorHook hook);
+
+        // Track windows not seen before. Windows closing within min_time_left of now_ms are
+        // skipped (too late to trade). Returns how many were added.
+        size_t add(const std::vector<MarketState> &markets, const std::string &timeframe, uint64_t now_ms);
+
+        // Fire due timers (expiry with rollover, subscribe, successor discovery), prefetch
+        // pending windows, subscribe due ones in one batch and promote warm ones
+        void advance(uint64_t now_ms);
+
+        // Startup: one pass prefetches every window, a second subscribes (in one batch) those
+        // already due, so the first connect carries them
+        void start(uint64_t now_ms);
+
+        std::optional<MarketSession> session(const std::string &condition_id) const;
+        bool tradable(const std::string &condition_id) const;
+
+        std::vector<MarketSession> sessions() const; // Ordered by expiry, then slug
+        LifecycleCounts counts() const;
+        size_t size() const;
+        size_t pending_timers() const;
+
+        // Closing time of a "<symbol>-updown-<tf>-<start unix sec>" or hourly
+        // "<name>-up-or-down-<month>-<day>-<hour>-et" window; 0 if the slug names no start
+        static uint64_t window_expiry_ms(const std::string &slug, const std::string &timeframe);
+        static uint64_t timeframe_ms(const std::string &timeframe);
+
+    private:
+        enum class TimerKind
+        {
+            SUBSCRIBE,
+            DISCOVER,
+            EXPIRE
+        };
+
+        struct Timer
+        {
+            TimerKind kind;
+            std::string condition_id;
+        };
+
+        struct Session : MarketSession
+        {
+            bool subscribe_due = false;
+            TimerWheel<Timer>::TimerId subscribe_timer = 0;
+            TimerWheel<Timer>::TimerId discover_timer = 0;
+        };
+
+        uint64_t min_time_left_ms_;
+        uint64_t expire_lead_ms_;
+        uint64_t discover_lead_ms_;
+        uint64_t discover_retry_ms_;
+        uint64_t presubscribe_ms_;
+        size_t prefetch_workers_;
+
+        PrefetchHook prefetch_;
+        SubscribeHook subscribe_;
+        UnsubscribeHook unsubscribe_;
+        WarmCheck warm_;
+        SuccessorHook successor_;
+
+        mutable std::mutex mutex_; // Guards everything below
+        std::map<std::string, Session> sessions_; // By condition_id
+        TimerWheel<Timer> timers_;
+        uint64_t expired_total_ = 0;
+        uint64_t rollovers_total_ = 0;
+
+        // Earliest-closing window of a series (nullptr if none); caller holds mutex_
+        Session *series_head(const std::string &series);
+        bool has_successor(const Session &session) const;
+        void promote(Session &session, uint64_t now_ms);
+    };
+
+} // namespace polymarket
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "types.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace polymarket
+{
+
+    // One pass over the whole table: a market is a hit when
+    //   ask_yes + ask_no < max_combined
+    //   and both legs' top-of-book size >= min_size
+    //   and both legs were updated within max_age_ns of now_ns (0 disables the check)
+    struct MarketScanFilter
+    {
+        double max_combined = 1.0;
+        double min_size = 0.0;
+        uint64_t max_age_ns = 0;
+        uint64_t now_ns = 0;
+    };
+
+    enum class ScanKernel
+    {
+        AUTO, // Widest the CPU supports
+        SCALAR,
+        AVX2,
+        AVX512
+    };
+
+    // Top of book of every subscribed market as structure-of-arrays columns indexed by a dense
+    // market id, so a scan streams contiguous prices instead of chasing one LiveMarketState per
+    // market. Columns are 64-byte aligned and padded to a multiple of 8 rows; unused and unpriced
+    // rows hold an infinite ask and never match.
+    //
+    // Writers (feed threads) store single cells; scans read without synchronisation, so a hit is
+    // a candidate: confirm it against OrderbookManager::get_market() before acting on it.
+    class MarketTable
+    {
+    public:
+        static constexpr uint32_t INVALID_ID = std::numeric_limits<uint32_t>::max();
+        static constexpr size_t ROW_ALIGN = 8; // Doubles per AVX-512 vector
+
+        explicit MarketTable(size_t capacity);
+
+        // Disable copy
+        MarketTable(const MarketTable &) = delete;
+        MarketTable &operator=(const MarketTable &) = delete;
+
+        // Dense id for a market (INVALID_ID when the table is full); released ids are reused
+        uint32_t assign(const std::string &condition_id);
+        void release(uint32_t id);
+
+        // One leg's top of book; a non-positive ask or size clears the leg
+        void store(uint32_t id, bool yes_leg, double ask, double size, uint64_t update_ns);
+
+        // Appends matching ids to hits, returns how many were appended
+        size_t scan(const MarketScanFilter &filter, std::vector<uint32_t> &hits,
+                    ScanKernel kernel = ScanKernel::AUTO) const;
+
+        std::string condition_id(uint32_t id) const; // Empty if the id is not assigned
+        size_t size() const;                         // Assigned ids
+        size_t capacity() const { return capacity_; }
+
+        static bool kernel_supported(ScanKernel kernel);
+        static ScanKernel best_kernel();
+        static const char *kernel_name(ScanKernel kernel);
+
+    private:
+        template <typename T>
+        struct AlignedDeleter
+        {
+            void operator()(T *ptr) const { ::operator delete[](ptr, std::align_val_t(CACHE_LINE_SIZE)); }
+        };
+        template <typename T>
+        using Column = std::unique_ptr<T[], AlignedDeleter<T>>;
+
+        template <typename T>
+        static Column<T> make_column(size_t rows, T fill);
+
+        size_t capacity_;
+
+        Column<double> ask_yes_;
+        Column<double> ask_no_;
+        Column<double> size_yes_;
+        Column<double> size_no_;
+        Column<uint64_t> update_ns_yes_;
+        Column<uint64_t> update_ns_no_;
+
+        std::atomic<size_t> rows_{0}; // High-water row count (multiple of ROW_ALIGN); scans stop here
+
+        mutable std::mutex ids_mutex_;
+        std::vector<std::string> condition_ids_; // By id; empty when free
+        std::unordered_map<std::string, uint32_t> id_by_condition_;
+        std::vector<uint32_t> free_ids_;
+
+        void clear_row(uint32_t id);
+    };
+
+} // namespace polymarket
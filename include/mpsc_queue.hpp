@@ -0,0 +1,117 @@
+#pragma once
+
+#include "types.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace polymarket
+{
+
+    // Bounded multi-producer/single-consumer ring with power-of-two capacity (Vyukov).
+    // try_push() may run on any number of threads at once: producers claim the head by
+    // CAS and publish through the slot's sequence number. try_pop() belongs to one
+    // consumer thread. For a ring with a single producer use SpscQueue.
+    template <typename T>
+    class MpscQueue
+    {
+    public:
+        explicit MpscQueue(size_t capacity)
+        {
+            size_t rounded = 2;
+            while (rounded < capacity)
+            {
+                rounded <<= 1;
+            }
+            mask_ = rounded - 1;
+            slots_ = std::make_unique<Slot[]>(rounded);
+            for (size_t i = 0; i < rounded; i++)
+            {
+                slots_[i].seq.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        // Disable copy
+        MpscQueue(const MpscQueue &) = delete;
+        MpscQueue &operator=(const MpscQueue &) = delete;
+
+        // Any producer thread, concurrently: false if the ring is full
+        bool try_push(T &&value)
+        {
+            size_t pos = head_.load(std::memory_order_relaxed);
+            while (true)
+            {
+                Slot &slot = slots_[pos & mask_];
+                auto diff = static_cast<intptr_t>(slot.seq.load(std::memory_order_acquire)) -
+                            static_cast<intptr_t>(pos);
+                if (diff == 0)
+                {
+                    if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        slot.value = std::move(value);
+                        slot.seq.store(pos + 1, std::memory_order_release);
+
+                        size_t tail = tail_.load(std::memory_order_relaxed);
+                        if (pos + 1 > tail && pos + 1 - tail > high_water_.load(std::memory_order_relaxed))
+                        {
+                            high_water_.store(pos + 1 - tail, std::memory_order_relaxed);
+                        }
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false; // Full
+                }
+                else
+                {
+                    pos = head_.load(std::memory_order_relaxed); // Another producer took it
+                }
+            }
+        }
+
+        // The consumer thread only: false if the ring is empty (or the oldest slot is still
+        // being written by its producer)
+        bool try_pop(T &out)
+        {
+            size_t pos = tail_.load(std::memory_order_relaxed);
+            Slot &slot = slots_[pos & mask_];
+            if (slot.seq.load(std::memory_order_acquire) != pos + 1)
+            {
+                return false;
+            }
+
+            out = std::move(slot.value);
+            slot.seq.store(pos + mask_ + 1, std::memory_order_release);
+            tail_.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Occupancy (approximate while producers are running)
+        size_t size() const
+        {
+            size_t head = head_.load(std::memory_order_acquire);
+            size_t tail = tail_.load(std::memory_order_acquire);
+            return head > tail ? head - tail : 0;
+        }
+        size_t capacity() const { return mask_ + 1; }
+        size_t high_water_mark() const { return high_water_.load(std::memory_order_relaxed); }
+
+    private:
+        struct alignas(CACHE_LINE_SIZE) Slot
+        {
+            std::atomic<size_t> seq{0};
+            T value{};
+        };
+
+        std::unique_ptr<Slot[]> slots_;
+        size_t mask_ = 0;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0}; // Claimed by CAS
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0}; // Consumer-owned
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> high_water_{0};
+    };
+
+} // namespace polymarket
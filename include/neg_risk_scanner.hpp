@@ -0,0 +1,147 @@
+#pragma once
+
+#include "types.hpp"
+#include "mpsc_queue.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace polymarket
+{
+
+    // One outcome of a basket: the YES token of one condition in the event
+    struct BasketLeg
+    {
+        std::string condition_id;
+        std::string token_id;
+        double price = 0.0; // Best ask (BUY_YES) or best bid (SELL_YES)
+        double size = 0.0;  // Shares available at that price
+    };
+
+    enum class BasketSide
+    {
+        BUY_YES, // Ask sum < 1: buy YES on every outcome, exactly one pays out 1
+        SELL_YES // Bid sum > 1: sell YES on every outcome (or buy every NO via the neg-risk adapter)
+    };
+
+    struct BasketOpportunity
+    {
+        std::string event_id; // neg_risk_market_id
+        BasketSide side = BasketSide::BUY_YES;
+        double price_sum = 0.0;      // Sum of leg prices
+        double edge_per_share = 0.0; // 1 - ask sum, or bid sum - 1
+        double shares = 0.0;         // Per leg: thinnest top level, capped by size_usdc
+        std::vector<BasketLeg> legs;
+        uint64_t detected_ns = 0;
+    };
+
+    // Running sums of one event
+    struct EventQuote
+    {
+        std::string event_id;
+        size_t outcomes = 0;
+        size_t expected_outcomes = 0; // From MarketState::neg_risk_outcomes (0: unknown)
+        size_t missing_asks = 0; // Legs with no ask yet; ask_sum is partial until 0
+        size_t missing_bids = 0;
+        double ask_sum = 0.0;
+        double bid_sum = 0.0;
+    };
+
+    using BasketOpportunityCallback = std::function<void(const BasketOpportunity &opportunity)>;
+
+    // Event-level arb for neg-risk events: exactly one outcome of an event resolves YES, so a
+    // full basket of YES shares is worth exactly 1. Conditions are grouped by neg_risk_market_id
+    // and each event keeps running sums of its legs' best asks and bids; a book update adjusts
+    // the sums by the leg's delta, so the cost per tick does not grow with the outcome count.
+    // Sums are recomputed from the legs every RESYNC_INTERVAL updates to shed rounding drift.
+    // Opportunities are edge-triggered per side and delivered to the callback and, if
+    // enable_queue() was called, to a ring drained with poll().
+    class NegRiskScanner
+    {
+    public:
+        static constexpr uint64_t RESYNC_INTERVAL = 1024;
+
+        explicit NegRiskScanner(const Config &config);
+
+        // Disable copy
+        NegRiskScanner(const NegRiskScanner &) = delete;
+        NegRiskScanner &operator=(const NegRiskScanner &) = delete;
+
+        // Setup, before books arrive: markets without an event id or events with fewer
+        // than two outcomes are ignored. Every outcome of an event must be present, or the
+        // basket does not pay out 1: BUY_YES only fires once the event has as many legs as
+        // its markets' neg_risk_outcomes. SELL_YES on a subset is still bounded by 1.
+        void add_markets(const std::vector<MarketState> &markets);
+        void on_opportunity(BasketOpportunityCallback callback);
+        void enable_queue(size_t capacity = 256);
+
+        // Any feed thread; books for tokens outside a tracked event are ignored
+        void on_book(const std::string &asset_id, const Orderbook &book);
+
+        // Consumer thread: false if nothing is queued
+        bool poll(BasketOpportunity &opportunity);
+
+        std::optional<EventQuote> quote(const std::string &event_id) const;
+        size_t event_count() const { return events_.size(); }
+
+        uint64_t updates() const { return updates_.load(); }
+        uint64_t opportunities() const { return opportunities_.load(); }
+        uint64_t dropped() const { return dropped_.load(); } // Queue full
+
+    private:
+        struct Leg
+        {
+            std::string condition_id;
+            std::string token_id;
+            double ask = 0.0;
+            double ask_size = 0.0;
+            double bid = 0.0;
+            double bid_size = 0.0;
+            bool has_ask = false;
+            bool has_bid = false;
+        };
+
+        struct Event
+        {
+            std::string id;
+            mutable std::mutex mutex;
+            std::vector<Leg> legs;
+            size_t expected_outcomes = 0;
+            double ask_sum = 0.0;
+            double bid_sum = 0.0;
+            size_t missing_asks = 0;
+            size_t missing_bids = 0;
+            uint64_t since_resync = 0;
+            bool buy_armed = true; // Re-armed once the basket leaves the opportunity
+            bool sell_armed = true;
+        };
+
+        struct LegRef
+        {
+            size_t event;
+            size_t leg;
+        };
+
+        Config config_;
+        std::vector<std::unique_ptr<Event>> events_;
+        std::unordered_map<std::string, size_t> event_index_; // event id -> events_
+        std::unordered_map<std::string, LegRef> token_index_; // YES token -> leg
+
+        BasketOpportunityCallback on_opportunity_cb_;
+        std::unique_ptr<MpscQueue<BasketOpportunity>> queue_; // Pushed to from every feed thread
+
+        std::atomic<uint64_t> updates_{0};
+        std::atomic<uint64_t> opportunities_{0};
+        std::atomic<uint64_t> dropped_{0};
+
+        static void resync(Event &event);
+        BasketOpportunity make_opportunity(const Event &event, BasketSide side) const;
+        void deliver(BasketOpportunity &&opportunity);
+    };
+
+} // namespace polymarket
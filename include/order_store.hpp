@@ -0,0 +1,130 @@
+#pragma once
+
+#include "clob_client.hpp"
+#include <string>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <shared_mutex>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+
+namespace polymarket
+{
+
+    struct UserOrderEvent;
+    struct UserTradeEvent;
+
+    enum class OrderState
+    {
+        PENDING,          // Posted, not yet acknowledged as resting
+        LIVE,             // Resting, nothing matched
+        PARTIALLY_FILLED, // Resting with size_matched > 0
+        FILLED,
+        CANCELED,
+        REJECTED,
+        CLOSED // Missing from the REST open-orders snapshot; final fill unknown
+    };
+
+    inline bool is_open(OrderState state)
+    {
+        return state == OrderState::PENDING || state == OrderState::LIVE || state == OrderState::PARTIALLY_FILLED;
+    }
+
+    struct TrackedOrder
+    {
+        std::string id;
+        std::string market; // condition_id (empty until an event or snapshot names it)
+        std::string asset_id;
+        OrderSide side = OrderSide::BUY;
+        double price = 0.0;
+        double original_size = 0.0; // Shares
+        double size_matched = 0.0;
+        OrderState state = OrderState::PENDING;
+        uint64_t updated_ns = 0;
+
+        double working_size() const
+        {
+            return is_open(state) && original_size > size_matched ? original_size - size_matched : 0.0;
+        }
+    };
+
+    // Open orders and working shares per token
+    struct TokenExposure
+    {
+        double working_buy = 0.0;
+        double working_sell = 0.0;
+        size_t open_orders = 0;
+    };
+
+    // Local state of our own orders, keyed by order id and indexed by market and token.
+    // Fed by post/cancel responses (ClobClient::set_order_store), user-channel events and
+    // periodic REST reconciliation. Per-token aggregates are maintained on every update,
+    // so strategy queries are a shared lock plus a hash lookup. Terminal states are final.
+    class OrderStore
+    {
+    public:
+        OrderStore() = default;
+        ~OrderStore();
+
+        // Disable copy
+        OrderStore(const OrderStore &) = delete;
+        OrderStore &operator=(const OrderStore &) = delete;
+
+        // Updates
+        void on_post(const SignedOrder &order, const OrderResponse &response, OrderType order_type = OrderType::GTC);
+        void on_cancel(const std::vector<std::string> &order_ids);
+        void on_user_order(const UserOrderEvent &event);
+        void on_user_trade(const UserTradeEvent &event);
+
+        // Apply an authoritative open-orders snapshot (market empty = all markets). Orders we
+        // hold as open that are missing from it and older than grace become CLOSED.
+        void reconcile(const std::vector<OpenOrder> &open_orders, const std::string &market = "",
+                       std::chrono::milliseconds grace = std::chrono::seconds(5));
+
+        // Queries
+        std::optional<TrackedOrder> get(const std::string &order_id) const;
+        TokenExposure exposure(const std::string &asset_id) const;
+        double working_size(const std::string &asset_id, OrderSide side) const;
+        std::vector<TrackedOrder> open_orders(const std::string &market = "") const;
+        size_t open_count() const;
+        size_t size() const;
+
+        // Background reconciliation against get_all_open_orders(); a failed snapshot is skipped,
+        // a successful one is applied even when empty. Also drops terminal orders
+        // older than ten minutes. The client must outlive the reconciler.
+        void start_reconciler(ClobClient *client, long interval_seconds = 10);
+        void stop_reconciler();
+
+    private:
+        struct Entry
+        {
+            TrackedOrder order;
+            std::unordered_set<std::string> trades; // Trade ids already counted in size_matched
+        };
+
+        mutable std::shared_mutex mutex_;
+        std::unordered_map<std::string, Entry> orders_;                              // By order id
+        std::unordered_map<std::string, std::unordered_set<std::string>> by_market_; // condition_id -> order ids
+        std::unordered_map<std::string, TokenExposure> by_token_;                    // asset_id -> working size
+        size_t open_count_ = 0;
+
+        // Reconciler thread
+        std::thread reconcile_thread_;
+        std::mutex reconcile_mutex_;
+        std::condition_variable reconcile_cv_;
+        bool reconcile_running_ = false;
+
+        // Mutate one order (created if unknown) and keep indexes and aggregates in step.
+        // Caller holds mutex_ exclusively.
+        void update_locked(const std::string &order_id, const std::function<void(Entry &)> &mutate);
+        void add_exposure_locked(const TrackedOrder &order, int sign);
+        void prune_locked(std::chrono::minutes max_age);
+    };
+
+} // namespace polymarket
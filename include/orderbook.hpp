@@ -2,87 +2,348 @@
 
 #include "types.hpp"
 #include "websocket_client.hpp"
+#include "spsc_queue.hpp"
+#include "thread_parker.hpp"
+#include "market_table.hpp"
+#include "strategy.hpp"
+#include "feed_journal.hpp"
 #include <unordered_map>
+#include <thread>
+#include <condition_variable>
 #include <shared_mutex>
-#include <functional>
 #include <optional>
+#include <memory>
+#include <array>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace polymarket
 {
 
-    // Callback for orderbook updates
-    using OrderbookUpdateCallback = std::function<void(const std::string &asset_id, const Orderbook &book)>;
-    using ArbOpportunityCallback = std::function<void(const LiveMarketState &market, double combined)>;
+    // Per-feed arbitration statistics (FeedMode::ARBITRATED)
+    struct FeedArbitrationStats
+    {
+        uint64_t wins;       // Books this feed delivered first (applied)
+        uint64_t duplicates; // Books the other feed had already delivered (dropped)
+        uint64_t stale;      // Books older than the applied one (dropped)
+        double avg_lag_ms;   // Mean delay behind the winning feed on duplicates
+
+        double win_rate() const
+        {
+            uint64_t seen = wins + duplicates;
+            return seen > 0 ? static_cast<double>(wins) / seen : 0.0;
+        }
+    };
+
+    class ClobClient;
+
+    // Where the manager reads "now" (nanoseconds, now_ns() epoch); replay substitutes the
+    // recorded receive time so timestamps, staleness and latency follow the recording
+    using FeedClock = std::function<uint64_t()>;
 
-    // Orderbook manager - subscribes to WebSocket and maintains orderbook state
-    class OrderbookManager
+    // Occupancy of the feed -> strategy rings (Config::strategy_threads > 0)
+    struct IngressStats
+    {
+        size_t depth = 0;            // Events queued right now (all rings)
+        size_t capacity = 0;         // Total slots
+        size_t high_water = 0;       // Deepest any single ring has been
+        uint64_t enqueued = 0;
+        uint64_t dropped = 0;        // DROP_OLDEST evictions, and events refused during shutdown
+        uint64_t producer_waits = 0; // Pushes that waited for the consumer (BLOCK)
+        uint64_t delivered = 0;      // Events handed to callbacks
+        uint64_t conflated = 0;      // Intermediate books superseded before delivery (CONFLATE)
+        uint64_t withheld = 0;       // Queued for a token that went stale before delivery
+        double avg_dispatch_latency_us = 0.0; // Receive -> callback
+        double max_dispatch_latency_us = 0.0;
+    };
+
+    // Orderbook manager - subscribes to WebSocket and maintains orderbook state.
+    // Subscriptions are sharded across Config::ws_shards connections; each connection
+    // parses on its own IXWebSocket thread and owns the books for its markets.
+    // Strategy supplies the per-book hooks (see strategy.hpp); OrderbookManager is the
+    // CallbackStrategy instantiation with std::function setters. Other strategies need
+    // orderbook_impl.hpp in the translation unit that instantiates them.
+    template <BookStrategy Strategy>
+    class BasicOrderbookManager
     {
     public:
-        explicit OrderbookManager(const Config &config);
-        ~OrderbookManager();
+        explicit BasicOrderbookManager(const Config &config, Strategy strategy = Strategy());
+        ~BasicOrderbookManager();
+
+        // Disable copy
+        BasicOrderbookManager(const BasicOrderbookManager &) = delete;
+        BasicOrderbookManager &operator=(const BasicOrderbookManager &) = delete;
 
         // Subscribe to markets
         void subscribe(const std::vector<MarketState> &markets);
         void subscribe(const MarketState &market);
         void unsubscribe(const std::string &token_id);
+        void unsubscribe_market(const std::string &condition_id); // Both legs of one market
         void unsubscribe_all();
 
-        // Get current orderbook
+        // Changes are sent to live connections as incremental (un)subscribe messages;
+        // the full set is only resent on (re)connect
+        std::vector<std::string> subscribed_tokens() const;
+
+        // Get current orderbook (nullopt while the book is known to be stale)
         std::optional<Orderbook> get_orderbook(const std::string &token_id) const;
 
         // Get market state (returns empty MarketState if not found)
         MarketState get_market(const std::string &condition_id) const;
 
-        // Callbacks
-        void on_orderbook_update(OrderbookUpdateCallback callback);
-        void on_arb_opportunity(ArbOpportunityCallback callback);
+        // Every subscribed market's top of book in one SIMD pass; returns candidate condition_ids
+        // (confirm with get_market() before acting)
+        std::vector<std::string> scan_markets(const MarketScanFilter &filter) const;
+        const MarketTable &market_table() const { return table_; }
+
+        // Callbacks. With strategy_threads == 0 they run on the shard's WebSocket thread
+        // (concurrently when ws_shards > 1); otherwise on the strategy thread owning the shard.
+        // The arb callback gets a snapshot and runs with no lock held; keep it short and hand
+        // execution to an ArbExecutor.
+        void on_orderbook_update(OrderbookUpdateCallback callback)
+            requires std::same_as<Strategy, CallbackStrategy>
+        {
+            strategy_.book = std::move(callback);
+        }
+        void on_top_of_book_change(TopOfBookCallback callback)
+            requires std::same_as<Strategy, CallbackStrategy>
+        {
+            strategy_.top_of_book = std::move(callback);
+        }
+        void on_arb_opportunity(ArbOpportunityCallback callback)
+            requires std::same_as<Strategy, CallbackStrategy>
+        {
+            strategy_.arb = std::move(callback);
+        }
+
+        // Hooks of a compile-time strategy; configure before connect()
+        Strategy &strategy() { return strategy_; }
+
+        // Gap recovery: books that went stale (disconnect, parse failure, out-of-order delta,
+        // silence) are withheld and refetched in batches through this client (must outlive us)
+        void set_resync_client(ClobClient *client);
+
+        // Record every raw message (JournalMode::RAW) or every applied book (BOOKS) into an
+        // open journal (must outlive us), plus subscriptions and REST resyncs in either
+        // mode so the recording replays on its own; set before subscribe()
+        void set_journal(FeedJournal *journal);
+
+        // Replace now_ns() for every timestamp the manager takes; set before connect()
+        void set_clock(FeedClock clock);
 
         // Connection
         bool connect();
         void disconnect();
         bool is_connected() const;
+        bool wait_until_connected(std::chrono::milliseconds timeout);
 
         // Run event loop (blocking)
         void run();
 
+        // Process one raw market-data message as if it arrived on a shard's connection
+        // (replay and benchmarks); runs on the calling thread
+        void inject_message(FeedSource source, std::string_view message, size_t shard = 0);
+
+        // Apply an already decoded full book (replay of a books journal) the same way
+        void inject_book(FeedSource source, const Orderbook &book, size_t shard = 0);
+
         // Stop
         void stop();
 
         // Statistics
         uint64_t total_updates() const { return total_updates_.load(); }
         uint64_t arb_opportunities() const { return arb_opportunities_.load(); }
+        size_t shard_count() const { return shards_.size(); }
+        std::vector<uint64_t> messages_per_shard() const;
+        FeedArbitrationStats feed_stats(FeedSource source) const;
+        IngressStats ingress_stats() const;
+        uint64_t conflated_updates(const std::string &token_id) const;
+        uint64_t gaps_detected() const { return gaps_detected_.load(); }
+        uint64_t books_resynced() const { return books_resynced_.load(); }
+
+        // Stable shard assignment (FNV-1a of condition_id): both legs of a market share a connection
+        static size_t shard_for(const std::string &condition_id, size_t shard_count);
+
+        // Wire message (un)subscribing tokens on one feed: initial is the CLOB handshake sent on
+        // connect, otherwise an incremental update for a live connection
+        static std::string build_subscription_message(FeedSource source, const std::vector<std::string> &tokens,
+                                                      bool subscribe, bool initial);
+
+        // Sweep both ask ladders buying equal shares: trade size is capped by size_usdc per leg
+        // and by the average combined cost reaching trigger
+        static ExecutableEdge executable_edge(const AskLadder &yes, const AskLadder &no,
+                                              double size_usdc, double trigger);
 
     private:
-        Config config_;
-        WebSocketClient ws_;
+        // Recently applied books of one token, used to drop the slower feed's copy
+        struct RecentBooks
+        {
+            static constexpr size_t WINDOW = 8;
+            std::array<uint64_t, WINDOW> hashes{};
+            std::array<uint64_t, WINDOW> seen_ns{};
+            std::array<FeedSource, WINDOW> sources{};
+            size_t next = 0;
+            uint64_t last_exchange_timestamp_ms = 0;
+        };
+
+        // Normalized update handed from a feed thread to a strategy thread
+        struct BookEvent
+        {
+            std::string asset_id;
+            std::string condition_id;
+            Orderbook book;         // Empty when conflated
+            bool conflated = false; // Consumer takes the token's latest book from the dispatcher
+        };
+
+        // One level of a CLOB price_change delta (size 0 removes the level)
+        struct LevelChange
+        {
+            bool bid;
+            PriceLevel level;
+        };
+
+        // Whether a token's stored book can be trusted
+        struct BookHealth
+        {
+            uint64_t last_update_ns = 0; // Last full book or delta (local clock)
+            bool stale = false;          // Known wrong; withheld until a full book arrives
+        };
+
+        // Conflating dispatcher state of one token: the newest undelivered book wins
+        struct ConflatedBook
+        {
+            std::string condition_id;
+            Orderbook latest;
+            bool dirty = false;     // Queued, not yet taken by the strategy thread
+            uint64_t conflated = 0; // Intermediates overwritten while dirty
+        };
+
+        // Market-data connections for a slice of the markets, and the books they feed
+        struct FeedShard
+        {
+            std::array<std::unique_ptr<WebSocketClient>, FEED_SOURCE_COUNT> feeds; // Null if not in feed_mode
+            mutable std::shared_mutex books_mutex;
+            std::unordered_map<std::string, Orderbook> books;    // By token_id
+            std::unordered_map<std::string, RecentBooks> recent; // By token_id (arbitrated mode)
+            std::unordered_map<std::string, BookHealth> health;  // By token_id
+            mutable std::mutex conflation_mutex;
+            std::unordered_map<std::string, ConflatedBook> conflation; // By token_id (CONFLATE)
+            std::array<std::unique_ptr<SpscQueue<BookEvent>>, FEED_SOURCE_COUNT> queues; // One producer each
+            std::unique_ptr<SpscQueue<BookEvent>> resync_queue; // Producer: the resync thread
+            ThreadParker *parker = nullptr;                     // Of the strategy thread draining the rings
+            std::atomic<size_t> stale_books{0};                 // Health entries marked stale (written under books_mutex)
 
-        // Orderbooks by token_id
-        mutable std::shared_mutex orderbooks_mutex_;
-        std::unordered_map<std::string, Orderbook> orderbooks_;
+            // Every ring the shard's strategy thread drains (null entries when unused)
+            std::array<SpscQueue<BookEvent> *, FEED_SOURCE_COUNT + 1> rings() const
+            {
+                std::array<SpscQueue<BookEvent> *, FEED_SOURCE_COUNT + 1> result{};
+                for (size_t i = 0; i < FEED_SOURCE_COUNT; i++)
+                {
+                    result[i] = queues[i].get();
+                }
+                result[FEED_SOURCE_COUNT] = resync_queue.get();
+                return result;
+            }
+            mutable std::mutex tokens_mutex;
+            std::vector<std::string> tokens; // Subscribed on this shard (guarded by tokens_mutex)
+            size_t index = 0;
+        };
+
+        struct FeedCounters
+        {
+            std::atomic<uint64_t> wins{0};
+            std::atomic<uint64_t> duplicates{0};
+            std::atomic<uint64_t> stale{0};
+            std::atomic<uint64_t> lag_samples{0};
+            std::atomic<uint64_t> lag_ns_total{0};
+        };
+
+        Config config_;
+        std::vector<std::unique_ptr<FeedShard>> shards_;
 
         // Markets by condition_id (using unique_ptr for non-copyable LiveMarketState)
         mutable std::shared_mutex markets_mutex_;
         std::unordered_map<std::string, std::unique_ptr<LiveMarketState>> markets_;
 
-        // Token to condition mapping
+        // Token to condition mapping (guarded by markets_mutex_)
         std::unordered_map<std::string, std::string> token_to_condition_;
 
-        // Subscribed tokens
-        std::vector<std::string> subscribed_tokens_;
+        // Top of book by dense market id; rows are assigned/released under markets_mutex_
+        MarketTable table_;
 
-        // Callbacks
-        OrderbookUpdateCallback on_update_cb_;
-        ArbOpportunityCallback on_arb_cb_;
+        // Per-book hooks
+        Strategy strategy_;
 
         // Statistics
         std::atomic<uint64_t> total_updates_{0};
         std::atomic<uint64_t> arb_opportunities_{0};
+        std::array<FeedCounters, FEED_SOURCE_COUNT> feed_counters_;
+        std::atomic<uint64_t> ingress_enqueued_{0};
+        std::atomic<uint64_t> ingress_dropped_{0};
+        std::atomic<uint64_t> ingress_waits_{0};
+        std::atomic<uint64_t> ingress_delivered_{0};
+        std::atomic<uint64_t> ingress_conflated_{0};
+        std::atomic<uint64_t> ingress_withheld_{0};
+        std::atomic<uint64_t> dispatch_latency_ns_total_{0};
+        std::atomic<uint64_t> dispatch_latency_ns_max_{0};
+
+        FeedJournal *journal_ = nullptr;
+        FeedClock clock_; // Empty: now_ns()
+
+        uint64_t clock_ns() const { return clock_ ? clock_() : now_ns(); }
+
+        // Resync thread: batches stale tokens into ClobClient::get_order_books
+        ClobClient *resync_client_ = nullptr;
+        std::thread resync_thread_;
+        std::mutex resync_mutex_;
+        std::condition_variable resync_cv_;
+        bool resync_running_ = false;
+        std::vector<std::string> resync_pending_; // Guarded by resync_mutex_
+        std::atomic<uint64_t> gaps_detected_{0};
+        std::atomic<uint64_t> books_resynced_{0};
+
+        // Strategy threads; thread i drains the rings of shards i, i + N, ... and sleeps on
+        // strategy_parkers_[i] when they are empty
+        std::vector<std::thread> strategy_threads_;
+        std::vector<std::unique_ptr<ThreadParker>> strategy_parkers_;
+        std::atomic<bool> strategy_running_{false};
 
         // Internal methods
-        void handle_message(const std::string &message);
-        void handle_orderbook_update(const std::string &asset_id, const Orderbook &book);
-        void send_subscribe_message();
-        void check_arb_opportunity(const std::string &condition_id);
+        void handle_message(FeedShard &shard, FeedSource source, std::string_view message);
+        void handle_orderbook_update(FeedShard &shard, FeedSource source, const std::string &asset_id, const Orderbook &book);
+        bool store_book(FeedShard &shard, FeedSource source, const std::string &asset_id, const Orderbook &book);
+        bool tracks_token(const std::string &asset_id) const;
+        bool arbitrate(FeedShard &shard, FeedSource source, const Orderbook &book);
+        void send_subscribe_message(FeedShard &shard, FeedSource source);
+        void update_subscription(FeedShard &shard, const std::vector<std::string> &tokens, bool subscribe);
+        template <typename Fn>
+        void for_each_feed(Fn &&fn) const;
+        void publish_update(FeedShard &shard, SpscQueue<BookEvent> *queue, const std::string &asset_id, const Orderbook &book);
+        bool apply_price_changes(FeedShard &shard, FeedSource source, const std::string &asset_id,
+                                 const std::vector<LevelChange> &changes, uint64_t exchange_timestamp_ms);
+        // silent_before_ns != 0: only tokens whose last update is older than that
+        void mark_stale(FeedShard &shard, const std::vector<std::string> &tokens, const char *reason,
+                        uint64_t silent_before_ns = 0);
+        void mark_shard_stale(FeedShard &shard, const char *reason);
+        void start_resync_thread();
+        void stop_resync_thread();
+        void resync_loop();
+        void check_silence();
+        void apply_resync(const std::string &asset_id, Orderbook book);
+        void dispatch_update(const std::string &condition_id, const std::string &asset_id, const Orderbook &book);
+        void enqueue_event(SpscQueue<BookEvent> &queue, BookEvent &&event);
+        void start_strategy_threads();
+        void stop_strategy_threads();
+        void strategy_loop(size_t index, size_t thread_count);
+        void process_event(FeedShard &shard, BookEvent &event);
+        bool conflate_update(FeedShard &shard, const std::string &condition_id, const Orderbook &book);
+        void check_arb_opportunity(const std::string &condition_id, const std::string &asset_id, const Orderbook &book);
+        FeedShard *shard_for_token(const std::string &token_id) const;
     };
 
+    using OrderbookManager = BasicOrderbookManager<CallbackStrategy>;
+    extern template class BasicOrderbookManager<CallbackStrategy>;
+
 } // namespace polymarket
@@ -0,0 +1,1749 @@
+#pragma once
+
+// Member definitions of BasicOrderbookManager. The CallbackStrategy instantiation
+// (OrderbookManager) is compiled once in src/orderbook.cpp; include this header instead of
+// orderbook.hpp only in the translation unit that instantiates a custom strategy.
+#include "orderbook.hpp"
+#include "clob_client.hpp"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <array>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace polymarket
+{
+
+    namespace orderbook_detail
+    {
+        using json = nlohmann::json;
+
+        // Feeds send prices/sizes as strings ("0.45") or, on some channels, as numbers
+        inline double level_value(const json &v)
+        {
+            return v.is_string() ? std::stod(v.get<std::string>()) : v.get<double>();
+        }
+
+        inline uint64_t payload_timestamp_ms(const json &obj)
+        {
+            if (!obj.contains("timestamp"))
+            {
+                return 0;
+            }
+            const auto &ts = obj["timestamp"];
+            return ts.is_string() ? std::stoull(ts.get<std::string>()) : ts.get<uint64_t>();
+        }
+
+        // Best-effort token ids from a payload we failed to parse
+        inline std::vector<std::string> find_asset_ids(std::string_view message)
+        {
+            static constexpr std::string_view KEY = "\"asset_id\":\"";
+            std::vector<std::string> ids;
+            for (size_t pos = message.find(KEY); pos != std::string_view::npos; pos = message.find(KEY, pos))
+            {
+                pos += KEY.size();
+                size_t end = message.find('"', pos);
+                if (end == std::string_view::npos)
+                {
+                    break;
+                }
+                ids.emplace_back(message.substr(pos, end - pos));
+            }
+            return ids;
+        }
+
+        inline void sort_levels(Orderbook &book)
+        {
+            std::sort(book.bids.begin(), book.bids.end(),
+                      [](const PriceLevel &a, const PriceLevel &b)
+                      { return a.price > b.price; });
+            std::sort(book.asks.begin(), book.asks.end(),
+                      [](const PriceLevel &a, const PriceLevel &b)
+                      { return a.price < b.price; });
+        }
+
+        // Parse bids/asks into a normalized book: bids descending, asks ascending
+        inline void parse_levels(const json &obj, Orderbook &book)
+        {
+            if (obj.contains("bids") && obj["bids"].is_array())
+            {
+                for (const auto &bid : obj["bids"])
+                {
+                    book.bids.push_back({level_value(bid["price"]), level_value(bid["size"])});
+                }
+                std::sort(book.bids.begin(), book.bids.end(),
+                          [](const PriceLevel &a, const PriceLevel &b)
+                          { return a.price > b.price; });
+            }
+
+            if (obj.contains("asks") && obj["asks"].is_array())
+            {
+                for (const auto &ask : obj["asks"])
+                {
+                    book.asks.push_back({level_value(ask["price"]), level_value(ask["size"])});
+                }
+                std::sort(book.asks.begin(), book.asks.end(),
+                          [](const PriceLevel &a, const PriceLevel &b)
+                          { return a.price < b.price; });
+            }
+
+            book.exchange_timestamp_ms = payload_timestamp_ms(obj);
+        }
+
+        // FNV-1a over the normalized levels and exchange timestamp: the same book from either
+        // feed hashes equal, a later book that returns to earlier levels does not
+        inline uint64_t book_content_hash(const Orderbook &book)
+        {
+            uint64_t hash = 1469598103934665603ULL;
+            auto mix = [&hash](const void *data, size_t len)
+            {
+                const auto *bytes = static_cast<const unsigned char *>(data);
+                for (size_t i = 0; i < len; i++)
+                {
+                    hash ^= bytes[i];
+                    hash *= 1099511628211ULL;
+                }
+            };
+            mix(book.asset_id.data(), book.asset_id.size());
+            mix(&book.exchange_timestamp_ms, sizeof(book.exchange_timestamp_ms));
+            for (const auto *side : {&book.bids, &book.asks})
+            {
+                mix("|", 1);
+                for (const auto &level : *side)
+                {
+                    mix(&level.price, sizeof(level.price));
+                    mix(&level.size, sizeof(level.size));
+                }
+            }
+            return hash;
+        }
+
+        inline const char *feed_name(FeedSource source)
+        {
+            return source == FeedSource::RTDS ? "RTDS" : "CLOB";
+        }
+
+        // Best effort: keep a strategy thread on one core so its caches stay warm
+        inline void pin_current_thread(int cpu)
+        {
+#ifdef __linux__
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+            {
+                std::cerr << "[OrderbookManager] Could not pin strategy thread to core " << cpu << std::endl;
+            }
+#else
+            (void)cpu;
+#endif
+        }
+    } // namespace orderbook_detail
+
+    template <BookStrategy Strategy>
+    BasicOrderbookManager<Strategy>::BasicOrderbookManager(const Config &config, Strategy strategy)
+        : config_(config), table_(config.market_table_capacity), strategy_(std::move(strategy))
+    {
+        bool use_rtds = config_.feed_mode != FeedMode::CLOB;
+        bool use_clob = config_.feed_mode != FeedMode::RTDS;
+
+        size_t shard_count = static_cast<size_t>(std::max(1, config_.ws_shards));
+        for (size_t i = 0; i < shard_count; i++)
+        {
+            auto shard = std::make_unique<FeedShard>();
+            FeedShard *s = shard.get();
+            s->index = i;
+
+            for (FeedSource source : {FeedSource::RTDS, FeedSource::CLOB})
+            {
+                if ((source == FeedSource::RTDS && !use_rtds) || (source == FeedSource::CLOB && !use_clob))
+                {
+                    continue;
+                }
+
+                auto ws = std::make_unique<WebSocketClient>();
+
+                // RTDS: real-time data endpoint (same as @polymarket/real-time-data-client)
+                // CLOB: market channel of ws-subscriptions-clob
+                ws->set_url(source == FeedSource::RTDS ? config_.rtds_ws_url : config_.clob_ws_url);
+                ws->set_ping_interval_ms(config_.ws_ping_interval_ms);
+                ws->set_auto_reconnect(true);
+
+                // Set up WebSocket callbacks
+                // Parse straight out of the socket buffer; no per-message copy
+                ws->on_message_view([this, s, source](const WsMessage &msg)
+                                    { handle_message(*s, source, msg.data); });
+
+                ws->on_connect([this, s, source, i]()
+                               {
+                std::cout << "[WS] Connected to " << orderbook_detail::feed_name(source) << " orderbook stream (shard " << i << ")" << std::endl;
+                send_subscribe_message(*s, source); });
+
+                ws->on_disconnect([this, s, source, i]()
+                                  {
+                std::cout << "[WS] Disconnected from " << orderbook_detail::feed_name(source) << " orderbook stream (shard " << i << ")" << std::endl;
+
+                // Updates are lost until the snapshot after reconnect; unless another feed still covers the shard
+                bool covered = false;
+                for (const auto &feed : s->feeds)
+                {
+                    covered = covered || (feed && feed->is_connected());
+                }
+                if (!covered)
+                {
+                    mark_shard_stale(*s, "disconnect");
+                } });
+
+                ws->on_error([source](const std::string &error)
+                             { std::cerr << "[WS] " << orderbook_detail::feed_name(source) << " error: " << error << std::endl; });
+
+                s->feeds[static_cast<size_t>(source)] = std::move(ws);
+                if (config_.strategy_threads > 0)
+                {
+                    s->queues[static_cast<size_t>(source)] =
+                        std::make_unique<SpscQueue<BookEvent>>(config_.ingress_queue_capacity);
+                }
+            }
+
+            if (config_.strategy_threads > 0)
+            {
+                s->resync_queue = std::make_unique<SpscQueue<BookEvent>>(config_.ingress_queue_capacity);
+            }
+
+            shards_.push_back(std::move(shard));
+        }
+
+        // More threads than shards would leave some with nothing to drain
+        if (config_.strategy_threads > 0)
+        {
+            size_t threads = std::min(static_cast<size_t>(config_.strategy_threads), shards_.size());
+            for (size_t i = 0; i < threads; i++)
+            {
+                strategy_parkers_.push_back(std::make_unique<ThreadParker>());
+            }
+            for (auto &shard : shards_)
+            {
+                shard->parker = strategy_parkers_[shard->index % threads].get();
+            }
+        }
+    }
+
+    template <BookStrategy Strategy>
+    template <typename Fn>
+    void BasicOrderbookManager<Strategy>::for_each_feed(Fn &&fn) const
+    {
+        for (const auto &shard : shards_)
+        {
+            for (const auto &ws : shard->feeds)
+            {
+                if (ws)
+                {
+                    fn(*ws);
+                }
+            }
+        }
+    }
+
+    template <BookStrategy Strategy>
+    BasicOrderbookManager<Strategy>::~BasicOrderbookManager()
+    {
+        stop();
+    }
+
+    template <BookStrategy Strategy>
+    size_t BasicOrderbookManager<Strategy>::shard_for(const std::string &condition_id, size_t shard_count)
+    {
+        // FNV-1a: stable across runs and platforms, unlike std::hash
+        uint64_t hash = 1469598103934665603ULL;
+        for (unsigned char c : condition_id)
+        {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+        return shard_count > 0 ? static_cast<size_t>(hash % shard_count) : 0;
+    }
+
+    template <BookStrategy Strategy>
+    typename BasicOrderbookManager<Strategy>::FeedShard *BasicOrderbookManager<Strategy>::shard_for_token(const std::string &token_id) const
+    {
+        std::shared_lock<std::shared_mutex> lock(markets_mutex_);
+        auto it = token_to_condition_.find(token_id);
+        if (it == token_to_condition_.end())
+        {
+            return nullptr;
+        }
+        return shards_[shard_for(it->second, shards_.size())].get();
+    }
+
+    template <BookStrategy Strategy>
+    std::vector<uint64_t> BasicOrderbookManager<Strategy>::messages_per_shard() const
+    {
+        std::vector<uint64_t> counts;
+        for (const auto &shard : shards_)
+        {
+            uint64_t count = 0;
+            for (const auto &ws : shard->feeds)
+            {
+                count += ws ? ws->messages_received() : 0;
+            }
+            counts.push_back(count);
+        }
+        return counts;
+    }
+
+    template <BookStrategy Strategy>
+    FeedArbitrationStats BasicOrderbookManager<Strategy>::feed_stats(FeedSource source) const
+    {
+        const auto &c = feed_counters_[static_cast<size_t>(source)];
+        FeedArbitrationStats stats;
+        stats.wins = c.wins.load();
+        stats.duplicates = c.duplicates.load();
+        stats.stale = c.stale.load();
+        uint64_t samples = c.lag_samples.load();
+        stats.avg_lag_ms = samples > 0 ? c.lag_ns_total.load() / 1e6 / samples : 0.0;
+        return stats;
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::subscribe(const std::vector<MarketState> &markets)
+    {
+        for (const auto &market : markets)
+        {
+            subscribe(market);
+        }
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::subscribe(const MarketState &market)
+    {
+        {
+            std::unique_lock<std::shared_mutex> lock(markets_mutex_);
+            if (markets_.count(market.condition_id))
+            {
+                return; // Already subscribed
+            }
+            auto live = std::make_unique<LiveMarketState>(market);
+            live->table_id = table_.assign(market.condition_id);
+            markets_[market.condition_id] = std::move(live);
+
+            // Map tokens to condition
+            token_to_condition_[market.token_yes] = market.condition_id;
+            token_to_condition_[market.token_no] = market.condition_id;
+        }
+
+        // Add to the subscribed tokens of the market's shard; live connections get only the delta
+        size_t index = shard_for(market.condition_id, shards_.size());
+        update_subscription(*shards_[index], {market.token_yes, market.token_no}, true);
+
+        // Silence is measured from subscription until the first book arrives
+        {
+            std::unique_lock<std::shared_mutex> lock(shards_[index]->books_mutex);
+            for (const auto *token : {&market.token_yes, &market.token_no})
+            {
+                shards_[index]->health[*token].last_update_ns = clock_ns();
+            }
+        }
+
+        if (journal_)
+        {
+            journal_->append_market(index, clock_ns(), market);
+        }
+
+        if (config_.log_subscriptions)
+        {
+            std::cout << "[OrderbookManager] Subscribed to market: " << market.slug
+                      << " (YES: " << market.token_yes.substr(0, 16) << "..., shard " << index << ")" << std::endl;
+        }
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::unsubscribe(const std::string &token_id)
+    {
+        FeedShard *shard = shard_for_token(token_id);
+        if (!shard)
+        {
+            return;
+        }
+
+        update_subscription(*shard, {token_id}, false);
+
+        // Late messages for this token are dropped once the mapping is gone
+        {
+            std::unique_lock<std::shared_mutex> lock(markets_mutex_);
+            token_to_condition_.erase(token_id);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(shard->conflation_mutex);
+            shard->conflation.erase(token_id);
+        }
+
+        std::unique_lock<std::shared_mutex> lock(shard->books_mutex);
+        shard->books.erase(token_id);
+        shard->recent.erase(token_id);
+        auto health = shard->health.find(token_id);
+        if (health != shard->health.end())
+        {
+            if (health->second.stale)
+            {
+                shard->stale_books--;
+            }
+            shard->health.erase(health);
+        }
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::unsubscribe_market(const std::string &condition_id)
+    {
+        std::vector<std::string> tokens;
+        {
+            std::unique_lock<std::shared_mutex> lock(markets_mutex_);
+            auto it = markets_.find(condition_id);
+            if (it == markets_.end())
+            {
+                return;
+            }
+            tokens = {it->second->token_yes, it->second->token_no};
+            for (const auto &token : tokens)
+            {
+                token_to_condition_.erase(token);
+            }
+            table_.release(it->second->table_id);
+            markets_.erase(it);
+        }
+
+        auto &shard = *shards_[shard_for(condition_id, shards_.size())];
+        update_subscription(shard, tokens, false);
+
+        {
+            std::lock_guard<std::mutex> lock(shard.conflation_mutex);
+            for (const auto &token : tokens)
+            {
+                shard.conflation.erase(token);
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(shard.books_mutex);
+        for (const auto &token : tokens)
+        {
+            shard.books.erase(token);
+            shard.recent.erase(token);
+            auto health = shard.health.find(token);
+            if (health != shard.health.end())
+            {
+                if (health->second.stale)
+                {
+                    shard.stale_books--;
+                }
+                shard.health.erase(health);
+            }
+        }
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::unsubscribe_all()
+    {
+        {
+            std::unique_lock<std::shared_mutex> lock(markets_mutex_);
+            for (const auto &[condition_id, market] : markets_)
+            {
+                table_.release(market->table_id);
+            }
+            markets_.clear();
+            token_to_condition_.clear();
+        }
+
+        for (auto &shard : shards_)
+        {
+            std::vector<std::string> tokens;
+            {
+                std::lock_guard<std::mutex> lock(shard->tokens_mutex);
+                tokens = shard->tokens;
+            }
+            update_subscription(*shard, tokens, false);
+
+            {
+                std::lock_guard<std::mutex> lock(shard->conflation_mutex);
+                shard->conflation.clear();
+            }
+
+            std::unique_lock<std::shared_mutex> lock(shard->books_mutex);
+            shard->books.clear();
+            shard->recent.clear();
+            shard->health.clear();
+            shard->stale_books = 0;
+        }
+    }
+
+    template <BookStrategy Strategy>
+    std::vector<std::string> BasicOrderbookManager<Strategy>::subscribed_tokens() const
+    {
+        std::vector<std::string> tokens;
+        for (const auto &shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard->tokens_mutex);
+            tokens.insert(tokens.end(), shard->tokens.begin(), shard->tokens.end());
+        }
+        return tokens;
+    }
+
+    template <BookStrategy Strategy>
+    std::optional<Orderbook> BasicOrderbookManager<Strategy>::get_orderbook(const std::string &token_id) const
+    {
+        FeedShard *shard = shard_for_token(token_id);
+        if (!shard)
+        {
+            return std::nullopt;
+        }
+
+        std::shared_lock<std::shared_mutex> lock(shard->books_mutex);
+        auto health = shard->health.find(token_id);
+        if (health != shard->health.end() && health->second.stale)
+        {
+            return std::nullopt;
+        }
+
+        auto it = shard->books.find(token_id);
+        if (it != shard->books.end())
+        {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    template <BookStrategy Strategy>
+    MarketState BasicOrderbookManager<Strategy>::get_market(const std::string &condition_id) const
+    {
+        std::shared_lock<std::shared_mutex> lock(markets_mutex_);
+        auto it = markets_.find(condition_id);
+        if (it != markets_.end())
+        {
+            const auto &live = it->second;
+            MarketState state;
+            state.slug = live->slug;
+            state.title = live->title;
+            state.symbol = live->symbol;
+            state.condition_id = live->condition_id;
+            state.token_yes = live->token_yes;
+            state.token_no = live->token_no;
+            auto quote = live->quote.load();
+            state.best_ask_yes = quote.ask_yes;
+            state.best_ask_no = quote.ask_no;
+            state.best_ask_yes_size = quote.ask_yes_size;
+            state.best_ask_no_size = quote.ask_no_size;
+            return state;
+        }
+        return MarketState{};
+    }
+
+    template <BookStrategy Strategy>
+    std::vector<std::string> BasicOrderbookManager<Strategy>::scan_markets(const MarketScanFilter &filter) const
+    {
+        std::vector<uint32_t> hits;
+        table_.scan(filter, hits);
+
+        std::vector<std::string> result;
+        result.reserve(hits.size());
+        for (uint32_t id : hits)
+        {
+            auto condition_id = table_.condition_id(id);
+            if (!condition_id.empty())
+            {
+                result.push_back(std::move(condition_id));
+            }
+        }
+        return result;
+    }
+
+    template <BookStrategy Strategy>
+    bool BasicOrderbookManager<Strategy>::connect()
+    {
+        start_strategy_threads();
+        start_resync_thread();
+
+        bool ok = true;
+        for_each_feed([&ok](WebSocketClient &ws)
+                      { ok = ws.connect() && ok; });
+        return ok;
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::disconnect()
+    {
+        for_each_feed([](WebSocketClient &ws)
+                      { ws.disconnect(); });
+    }
+
+    template <BookStrategy Strategy>
+    bool BasicOrderbookManager<Strategy>::is_connected() const
+    {
+        bool connected = true;
+        for_each_feed([&connected](const WebSocketClient &ws)
+                      { connected = connected && ws.is_connected(); });
+        return connected;
+    }
+
+    template <BookStrategy Strategy>
+    bool BasicOrderbookManager<Strategy>::wait_until_connected(std::chrono::milliseconds timeout)
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        bool ok = true;
+        for_each_feed([&](WebSocketClient &ws)
+                      {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            ok = ws.wait_until_connected(std::max(remaining, std::chrono::milliseconds(0))) && ok; });
+        return ok;
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::run()
+    {
+        // Each connection parses on its own IXWebSocket thread; park until every one is stopped
+        for_each_feed([](WebSocketClient &ws)
+                      { ws.run(); });
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::stop()
+    {
+        for_each_feed([](WebSocketClient &ws)
+                      { ws.stop(); });
+
+        // Feeds first, so no producer is left waiting on a ring nobody drains
+        stop_resync_thread();
+        stop_strategy_threads();
+    }
+
+    template <BookStrategy Strategy>
+    std::string BasicOrderbookManager<Strategy>::build_subscription_message(FeedSource source, const std::vector<std::string> &tokens,
+                                                                            bool subscribe, bool initial)
+    {
+        orderbook_detail::json msg;
+        if (source == FeedSource::RTDS)
+        {
+            // Build subscription message for Polymarket Real-Time Data WebSocket
+            // Format matches @polymarket/real-time-data-client:
+            // {"action": "subscribe", "subscriptions": [{"topic": "clob_market", "type": "agg_orderbook", "filters": "[token1,token2]"}]}
+            // Unsubscribe uses the same shape with "action": "unsubscribe"
+            msg["action"] = subscribe ? "subscribe" : "unsubscribe";
+
+            orderbook_detail::json subscription;
+            subscription["topic"] = "clob_market";
+            subscription["type"] = "agg_orderbook";
+            subscription["filters"] = orderbook_detail::json(tokens).dump(); // JSON array as string
+
+            msg["subscriptions"] = orderbook_detail::json::array({subscription});
+        }
+        else if (initial)
+        {
+            // CLOB market channel handshake: {"type": "market", "assets_ids": [token1, token2]}
+            msg["type"] = "market";
+            msg["assets_ids"] = tokens;
+        }
+        else
+        {
+            // CLOB market channel on an open connection: {"assets_ids": [...], "operation": "subscribe"}
+            msg["assets_ids"] = tokens;
+            msg["operation"] = subscribe ? "subscribe" : "unsubscribe";
+        }
+        return msg.dump();
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::send_subscribe_message(FeedShard &shard, FeedSource source)
+    {
+        // Full resend on (re)connect; serialized with incremental updates by tokens_mutex
+        std::lock_guard<std::mutex> lock(shard.tokens_mutex);
+        if (shard.tokens.empty())
+        {
+            return;
+        }
+
+        std::cout << "[WS] Sending " << orderbook_detail::feed_name(source) << " subscribe: " << shard.tokens.size() << " tokens" << std::endl;
+        shard.feeds[static_cast<size_t>(source)]->send(build_subscription_message(source, shard.tokens, true, true));
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::update_subscription(FeedShard &shard, const std::vector<std::string> &tokens, bool subscribe)
+    {
+        std::lock_guard<std::mutex> lock(shard.tokens_mutex);
+
+        std::vector<std::string> delta;
+        for (const auto &token : tokens)
+        {
+            auto it = std::find(shard.tokens.begin(), shard.tokens.end(), token);
+            if (subscribe && it == shard.tokens.end())
+            {
+                shard.tokens.push_back(token);
+                delta.push_back(token);
+            }
+            else if (!subscribe && it != shard.tokens.end())
+            {
+                shard.tokens.erase(it);
+                delta.push_back(token);
+            }
+        }
+
+        if (delta.empty())
+        {
+            return;
+        }
+
+        // Disconnected feeds pick up the new set from send_subscribe_message on connect
+        for (size_t i = 0; i < FEED_SOURCE_COUNT; i++)
+        {
+            auto &ws = shard.feeds[i];
+            if (ws && ws->is_connected())
+            {
+                auto source = static_cast<FeedSource>(i);
+                ws->send(build_subscription_message(source, delta, subscribe, false));
+            }
+        }
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::inject_message(FeedSource source, std::string_view message, size_t shard)
+    {
+        handle_message(*shards_[shard % shards_.size()], source, message);
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::inject_book(FeedSource source, const Orderbook &book, size_t shard)
+    {
+        handle_orderbook_update(*shards_[shard % shards_.size()], source, book.asset_id, book);
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::handle_message(FeedShard &shard, FeedSource source, std::string_view message)
+    {
+        // Skip empty messages
+        if (message.empty() || message == "{}")
+        {
+            return;
+        }
+
+        if (journal_ && journal_->records_raw())
+        {
+            journal_->append_raw(source, shard.index, clock_ns(), message);
+        }
+
+        try
+        {
+            auto j = orderbook_detail::json::parse(message.begin(), message.end());
+
+            // Handle Polymarket Real-Time Data format:
+            // {"topic": "clob_market", "type": "agg_orderbook", "payload": {"asset_id": "...", "asks": [...], "bids": [...]}}
+            if (j.is_object() && j.contains("topic") && j.contains("type") && j.contains("payload"))
+            {
+                std::string topic = j["topic"].get<std::string>();
+                std::string type = j["type"].get<std::string>();
+
+                if (topic == "clob_market" && type == "agg_orderbook")
+                {
+                    auto &payload = j["payload"];
+                    if (!payload.contains("asset_id"))
+                    {
+                        return;
+                    }
+
+                    Orderbook book;
+                    book.asset_id = payload["asset_id"].get<std::string>();
+                    book.timestamp_ns = clock_ns();
+                    orderbook_detail::parse_levels(payload, book);
+
+                    handle_orderbook_update(shard, source, book.asset_id, book);
+                }
+                return;
+            }
+
+            // CLOB market channel format: {"event_type": "book", "asset_id": "...", "bids": [...], "asks": [...]}
+            // The initial snapshot arrives as an array of such events
+            auto handle_event = [&](const orderbook_detail::json &event)
+            {
+                // Current price_change format: {"event_type": "price_change", "price_changes": [{"asset_id", "price", "size", "side"}]}
+                if (event.is_object() && event.contains("price_changes") && event["price_changes"].is_array())
+                {
+                    std::unordered_map<std::string, std::vector<LevelChange>> by_asset;
+                    for (const auto &change : event["price_changes"])
+                    {
+                        by_asset[change["asset_id"].get<std::string>()].push_back(
+                            {change.value("side", "") == "BUY", {orderbook_detail::level_value(change["price"]), orderbook_detail::level_value(change["size"])}});
+                    }
+                    for (const auto &[asset_id, changes] : by_asset)
+                    {
+                        apply_price_changes(shard, source, asset_id, changes, orderbook_detail::payload_timestamp_ms(event));
+                    }
+                    return;
+                }
+
+                if (!event.is_object() || !event.contains("event_type") || !event.contains("asset_id"))
+                {
+                    return;
+                }
+
+                std::string event_type = event["event_type"].get<std::string>();
+                bool has_levels = event.contains("bids") || event.contains("asks");
+
+                // price_change deltas: {"asset_id": ..., "changes": [{"price", "size", "side"}]}
+                if (event_type == "price_change" && !has_levels && event.contains("changes"))
+                {
+                    std::vector<LevelChange> changes;
+                    for (const auto &change : event["changes"])
+                    {
+                        changes.push_back({change.value("side", "") == "BUY",
+                                           {orderbook_detail::level_value(change["price"]), orderbook_detail::level_value(change["size"])}});
+                    }
+                    apply_price_changes(shard, source, event["asset_id"].get<std::string>(), changes,
+                                        orderbook_detail::payload_timestamp_ms(event));
+                    return;
+                }
+
+                if ((event_type != "book" && event_type != "price_change") || !has_levels)
+                {
+                    return;
+                }
+
+                Orderbook book;
+                book.asset_id = event["asset_id"].get<std::string>();
+                book.timestamp_ns = clock_ns();
+                orderbook_detail::parse_levels(event, book);
+
+                handle_orderbook_update(shard, source, book.asset_id, book);
+            };
+
+            if (j.is_array())
+            {
+                for (const auto &event : j)
+                {
+                    handle_event(event);
+                }
+            }
+            else
+            {
+                handle_event(j);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "[WS] Parse error: " << e.what() << std::endl;
+
+            // An update was lost; withhold the affected books (all of the shard's if unknown)
+            auto tokens = orderbook_detail::find_asset_ids(message);
+            if (tokens.empty())
+            {
+                mark_shard_stale(shard, "parse error");
+            }
+            else
+            {
+                mark_stale(shard, tokens, "parse error");
+            }
+        }
+    }
+
+    template <BookStrategy Strategy>
+    bool BasicOrderbookManager<Strategy>::apply_price_changes(FeedShard &shard, FeedSource source, const std::string &asset_id,
+                                                              const std::vector<LevelChange> &changes, uint64_t exchange_timestamp_ms)
+    {
+        if (!tracks_token(asset_id))
+        {
+            return false;
+        }
+
+        Orderbook book;
+        bool out_of_order = false;
+        {
+            // Read, merge and store under one exclusive lock: a full book from the other feed
+            // landing in between would otherwise be overwritten with the stale base's levels
+            std::unique_lock<std::shared_mutex> lock(shard.books_mutex);
+            auto health = shard.health.find(asset_id);
+            auto it = shard.books.find(asset_id);
+            if (health == shard.health.end() || health->second.stale || it == shard.books.end())
+            {
+                return false; // No trusted base book; the resync snapshot supersedes this delta
+            }
+
+            out_of_order = exchange_timestamp_ms != 0 && exchange_timestamp_ms < it->second.exchange_timestamp_ms;
+            if (!out_of_order)
+            {
+                book = it->second;
+                for (const auto &change : changes)
+                {
+                    auto &side = change.bid ? book.bids : book.asks;
+                    auto level = std::find_if(side.begin(), side.end(), [&](const PriceLevel &existing)
+                                              { return std::abs(existing.price - change.level.price) < 1e-9; });
+                    if (change.level.size <= 0.0)
+                    {
+                        if (level != side.end())
+                        {
+                            side.erase(level);
+                        }
+                    }
+                    else if (level != side.end())
+                    {
+                        level->size = change.level.size;
+                    }
+                    else
+                    {
+                        side.push_back(change.level);
+                    }
+                }
+                orderbook_detail::sort_levels(book);
+                book.timestamp_ns = clock_ns();
+                if (exchange_timestamp_ms != 0)
+                {
+                    book.exchange_timestamp_ms = exchange_timestamp_ms;
+                }
+
+                if (!store_book(shard, source, asset_id, book))
+                {
+                    return true;
+                }
+            }
+        }
+
+        // A delta older than the book it would apply to means we cannot trust the sequence
+        if (out_of_order)
+        {
+            mark_stale(shard, {asset_id}, "out-of-order delta");
+            return false;
+        }
+
+        publish_update(shard, shard.queues[static_cast<size_t>(source)].get(), asset_id, book);
+        return true;
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::mark_stale(FeedShard &shard, const std::vector<std::string> &tokens, const char *reason,
+                                                     uint64_t silent_before_ns)
+    {
+        std::vector<std::string> newly_stale;
+        {
+            std::unique_lock<std::shared_mutex> lock(shard.books_mutex);
+            for (const auto &token : tokens)
+            {
+                auto it = shard.health.find(token);
+                if (it != shard.health.end() && !it->second.stale &&
+                    (silent_before_ns == 0 || it->second.last_update_ns < silent_before_ns))
+                {
+                    it->second.stale = true;
+                    shard.stale_books++;
+                    newly_stale.push_back(token);
+                }
+            }
+        }
+
+        if (newly_stale.empty())
+        {
+            return;
+        }
+        gaps_detected_ += newly_stale.size();
+
+        // A conflated book waiting for the strategy thread is as stale as the stored one;
+        // its queued marker finds the slot clean and is skipped
+        {
+            std::lock_guard<std::mutex> lock(shard.conflation_mutex);
+            for (const auto &token : newly_stale)
+            {
+                auto it = shard.conflation.find(token);
+                if (it != shard.conflation.end() && it->second.dirty)
+                {
+                    it->second.dirty = false;
+                    it->second.latest = Orderbook{};
+                    ingress_withheld_++;
+                }
+            }
+        }
+
+        // Strategies must not act on the last known quote of a stale leg
+        {
+            std::shared_lock<std::shared_mutex> lock(markets_mutex_);
+            for (const auto &token : newly_stale)
+            {
+                auto cond_it = token_to_condition_.find(token);
+                auto market_it = cond_it != token_to_condition_.end() ? markets_.find(cond_it->second) : markets_.end();
+                if (market_it == markets_.end())
+                {
+                    continue;
+                }
+
+                auto &market = *market_it->second;
+                market.quote.store(token == market.token_yes, 0.0, 0.0);
+                table_.store(market.table_id, token == market.token_yes, 0.0, 0.0, 0);
+                std::lock_guard<std::mutex> depth_lock(market.depth_mutex);
+                (token == market.token_yes ? market.asks_yes : market.asks_no).count = 0;
+                market.edge = ExecutableEdge{};
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(resync_mutex_);
+        if (!resync_running_)
+        {
+            return; // Shutting down, or no resync client: the next snapshot heals the book
+        }
+        resync_pending_.insert(resync_pending_.end(), newly_stale.begin(), newly_stale.end());
+        resync_cv_.notify_one();
+        std::cout << "[OrderbookManager] " << newly_stale.size() << " book(s) stale (" << reason << "), resync queued" << std::endl;
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::mark_shard_stale(FeedShard &shard, const char *reason)
+    {
+        std::vector<std::string> tokens;
+        {
+            std::lock_guard<std::mutex> lock(shard.tokens_mutex);
+            tokens = shard.tokens;
+        }
+        mark_stale(shard, tokens, reason);
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::set_resync_client(ClobClient *client)
+    {
+        resync_client_ = client;
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::set_journal(FeedJournal *journal)
+    {
+        journal_ = journal;
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::set_clock(FeedClock clock)
+    {
+        clock_ = std::move(clock);
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::start_resync_thread()
+    {
+        {
+            std::lock_guard<std::mutex> lock(resync_mutex_);
+            if (!resync_client_ || resync_running_)
+            {
+                return;
+            }
+            resync_running_ = true;
+        }
+
+        resync_thread_ = std::thread([this]()
+                                     { resync_loop(); });
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::stop_resync_thread()
+    {
+        {
+            std::lock_guard<std::mutex> lock(resync_mutex_);
+            resync_running_ = false;
+            resync_pending_.clear();
+        }
+        resync_cv_.notify_all();
+        if (resync_thread_.joinable())
+        {
+            resync_thread_.join();
+        }
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::check_silence()
+    {
+        uint64_t now = clock_ns();
+        uint64_t max_silence_ns = static_cast<uint64_t>(config_.book_max_silence_ms) * 1000000ULL;
+        if (now <= max_silence_ns)
+        {
+            return;
+        }
+        // Compared as a cutoff: a feed thread may store a timestamp later than now, and
+        // now - last_update_ns would wrap around
+        uint64_t silent_before_ns = now - max_silence_ns;
+
+        for (auto &shard : shards_)
+        {
+            std::vector<std::string> silent;
+            {
+                std::shared_lock<std::shared_mutex> lock(shard->books_mutex);
+                for (const auto &[token, health] : shard->health)
+                {
+                    if (!health.stale && health.last_update_ns < silent_before_ns)
+                    {
+                        silent.push_back(token);
+                    }
+                }
+            }
+            // Re-checked under the exclusive lock: a book updated since the scan stays live
+            mark_stale(*shard, silent, "silent", silent_before_ns);
+        }
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::resync_loop()
+    {
+        auto interval = std::chrono::milliseconds(config_.resync_interval_ms);
+        auto backoff = interval;
+        auto next_silence_check = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::mutex> lock(resync_mutex_);
+        while (resync_running_)
+        {
+            resync_cv_.wait_for(lock, interval, [this]()
+                                { return !resync_running_ || !resync_pending_.empty(); });
+            if (!resync_running_)
+            {
+                break;
+            }
+
+            if (std::chrono::steady_clock::now() >= next_silence_check)
+            {
+                next_silence_check = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+                lock.unlock();
+                check_silence();
+                lock.lock();
+            }
+
+            if (resync_pending_.empty())
+            {
+                continue;
+            }
+
+            // One batched REST call for everything that went stale since the last round
+            std::vector<std::string> tokens;
+            tokens.swap(resync_pending_);
+            std::sort(tokens.begin(), tokens.end());
+            tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+            lock.unlock();
+
+            auto books = resync_client_->get_order_books(tokens);
+            std::vector<std::string> missing;
+            for (const auto &token : tokens)
+            {
+                auto it = books.find(token);
+                if (it != books.end())
+                {
+                    apply_resync(token, std::move(it->second));
+                }
+                else
+                {
+                    missing.push_back(token);
+                }
+            }
+
+            // Rate limit: at most one batch per interval; failures retry with exponential backoff
+            if (missing.empty())
+            {
+                backoff = interval;
+            }
+            else
+            {
+                if (backoff == interval)
+                {
+                    std::cerr << "[OrderbookManager] Resync failed for " << missing.size() << " book(s), retrying" << std::endl;
+                }
+                backoff = std::min(backoff * 2, std::chrono::milliseconds(5000));
+            }
+            // New stale tokens do not cut the wait short; stop() does
+            lock.lock();
+            resync_cv_.wait_for(lock, missing.empty() ? interval : backoff, [this]()
+                                { return !resync_running_; });
+            if (resync_running_)
+            {
+                resync_pending_.insert(resync_pending_.end(), missing.begin(), missing.end());
+            }
+        }
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::apply_resync(const std::string &asset_id, Orderbook book)
+    {
+        FeedShard *shard = shard_for_token(asset_id);
+        if (!shard)
+        {
+            return; // Unsubscribed meanwhile
+        }
+
+        book.asset_id = asset_id;
+        book.timestamp_ns = clock_ns();
+        orderbook_detail::sort_levels(book);
+
+        {
+            std::unique_lock<std::shared_mutex> lock(shard->books_mutex);
+            auto health = shard->health.find(asset_id);
+            if (health == shard->health.end() || !health->second.stale)
+            {
+                return; // A feed snapshot already healed it; that one is newer
+            }
+
+            shard->books[asset_id] = book;
+            health->second.stale = false;
+            shard->stale_books--;
+            if (journal_) // Either mode: a raw recording needs them to replay across gaps
+            {
+                journal_->append_book(JournalRecordKind::RESYNC_BOOK, FeedSource::CLOB, shard->index, book);
+            }
+            health->second.last_update_ns = book.timestamp_ns;
+        }
+
+        books_resynced_++;
+        publish_update(*shard, shard->resync_queue.get(), asset_id, book);
+    }
+
+    template <BookStrategy Strategy>
+    bool BasicOrderbookManager<Strategy>::arbitrate(FeedShard &shard, FeedSource source, const Orderbook &book)
+    {
+        // Caller holds shard.books_mutex exclusively
+        auto &recent = shard.recent[book.asset_id];
+        auto &counters = feed_counters_[static_cast<size_t>(source)];
+
+        // Older than what we already applied: the other feed is ahead
+        if (book.exchange_timestamp_ms != 0 && book.exchange_timestamp_ms < recent.last_exchange_timestamp_ms)
+        {
+            counters.stale++;
+            return false;
+        }
+
+        // Without an exchange timestamp a revert to earlier levels hashes like the earlier book,
+        // so only the book applied last can be a duplicate
+        uint64_t hash = orderbook_detail::book_content_hash(book);
+        size_t latest = (recent.next + RecentBooks::WINDOW - 1) % RecentBooks::WINDOW;
+        for (size_t i = 0; i < RecentBooks::WINDOW; i++)
+        {
+            if (book.exchange_timestamp_ms == 0 && i != latest)
+            {
+                continue;
+            }
+            if (recent.seen_ns[i] != 0 && recent.hashes[i] == hash)
+            {
+                counters.duplicates++;
+                // Receive times are taken before the shard lock, so the loser can carry the
+                // earlier one; those samples say nothing about lag
+                if (recent.sources[i] != source && book.timestamp_ns >= recent.seen_ns[i])
+                {
+                    counters.lag_samples++;
+                    counters.lag_ns_total += book.timestamp_ns - recent.seen_ns[i];
+                }
+                return false;
+            }
+        }
+
+        size_t slot = recent.next++ % RecentBooks::WINDOW;
+        recent.hashes[slot] = hash;
+        recent.seen_ns[slot] = book.timestamp_ns;
+        recent.sources[slot] = source;
+        recent.last_exchange_timestamp_ms = std::max(recent.last_exchange_timestamp_ms, book.exchange_timestamp_ms);
+        counters.wins++;
+        return true;
+    }
+
+    template <BookStrategy Strategy>
+    bool BasicOrderbookManager<Strategy>::tracks_token(const std::string &asset_id) const
+    {
+        std::shared_lock<std::shared_mutex> lock(markets_mutex_);
+        return token_to_condition_.count(asset_id) != 0;
+    }
+
+    template <BookStrategy Strategy>
+    bool BasicOrderbookManager<Strategy>::store_book(FeedShard &shard, FeedSource source, const std::string &asset_id, const Orderbook &book)
+    {
+        // Caller holds shard.books_mutex exclusively
+        // Arbitrated mode: only the first copy of each book is applied
+        if (config_.feed_mode == FeedMode::ARBITRATED && !arbitrate(shard, source, book))
+        {
+            return false;
+        }
+
+        shard.books[asset_id] = book;
+        if (journal_ && journal_->records_books())
+        {
+            journal_->append_book(JournalRecordKind::BOOK, source, shard.index, book);
+        }
+
+        // Every applied update is a full book (deltas are merged before they get here)
+        auto &health = shard.health[asset_id];
+        if (health.stale)
+        {
+            health.stale = false;
+            shard.stale_books--;
+        }
+        health.last_update_ns = book.timestamp_ns;
+        return true;
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::handle_orderbook_update(FeedShard &shard, FeedSource source, const std::string &asset_id, const Orderbook &book)
+    {
+        // Drop in-flight messages for tokens that were unsubscribed
+        if (!tracks_token(asset_id))
+        {
+            return;
+        }
+
+        // Store orderbook (per-shard lock: shards never contend with each other here)
+        {
+            std::unique_lock<std::shared_mutex> lock(shard.books_mutex);
+            if (!store_book(shard, source, asset_id, book))
+            {
+                return;
+            }
+        }
+
+        publish_update(shard, shard.queues[static_cast<size_t>(source)].get(), asset_id, book);
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::publish_update(FeedShard &shard, SpscQueue<BookEvent> *queue, const std::string &asset_id, const Orderbook &book)
+    {
+        total_updates_++;
+
+        std::string condition_id;
+
+        // Update market state; fields are atomics, so a shared lock is enough and
+        // concurrent shards only exclude subscribe/unsubscribe
+        {
+            std::shared_lock<std::shared_mutex> lock(markets_mutex_);
+
+            // Find the condition this token belongs to
+            auto cond_it = token_to_condition_.find(asset_id);
+            if (cond_it == token_to_condition_.end())
+            {
+                return;
+            }
+            condition_id = cond_it->second;
+
+            auto market_it = markets_.find(condition_id);
+            if (market_it != markets_.end())
+            {
+                auto &market = *market_it->second;
+                if (asset_id == market.token_yes || asset_id == market.token_no)
+                {
+                    bool yes_leg = asset_id == market.token_yes;
+                    double ask = book.best_ask();
+                    double ask_size = book.best_ask_size();
+                    market.quote.store(yes_leg, ask, ask_size, book.timestamp_ns);
+                    table_.store(market.table_id, yes_leg, ask, ask_size, book.timestamp_ns);
+                }
+            }
+        }
+
+        // Hand decision-making to the strategy thread; decode stays on the network thread
+        if (queue)
+        {
+            if (config_.ingress_overflow != OverflowPolicy::CONFLATE)
+            {
+                enqueue_event(*queue, BookEvent{asset_id, condition_id, book, false});
+            }
+            else if (conflate_update(shard, condition_id, book))
+            {
+                enqueue_event(*queue, BookEvent{asset_id, condition_id, {}, true});
+            }
+            shard.parker->wake();
+            return;
+        }
+
+        dispatch_update(condition_id, asset_id, book);
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::dispatch_update(const std::string &condition_id, const std::string &asset_id, const Orderbook &book)
+    {
+        // Resolved at compile time; inlined for concrete strategies
+        strategy_.on_book(asset_id, book);
+
+        // Check for arb opportunity
+        check_arb_opportunity(condition_id, asset_id, book);
+    }
+
+    template <BookStrategy Strategy>
+    bool BasicOrderbookManager<Strategy>::conflate_update(FeedShard &shard, const std::string &condition_id, const Orderbook &book)
+    {
+        // Keep only the newest book per token; the ring carries at most one marker per token
+        std::lock_guard<std::mutex> lock(shard.conflation_mutex);
+        auto &slot = shard.conflation[book.asset_id];
+        slot.condition_id = condition_id;
+        slot.latest = book;
+        if (slot.dirty)
+        {
+            slot.conflated++;
+            ingress_conflated_++;
+            return false;
+        }
+        slot.dirty = true;
+        return true;
+    }
+
+    template <BookStrategy Strategy>
+    uint64_t BasicOrderbookManager<Strategy>::conflated_updates(const std::string &token_id) const
+    {
+        FeedShard *shard = shard_for_token(token_id);
+        if (!shard)
+        {
+            return 0;
+        }
+
+        std::lock_guard<std::mutex> lock(shard->conflation_mutex);
+        auto it = shard->conflation.find(token_id);
+        return it != shard->conflation.end() ? it->second.conflated : 0;
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::enqueue_event(SpscQueue<BookEvent> &queue, BookEvent &&event)
+    {
+        if (config_.ingress_overflow == OverflowPolicy::DROP_OLDEST)
+        {
+            ingress_dropped_ += queue.push_drop_oldest(std::move(event));
+            ingress_enqueued_++;
+            return;
+        }
+
+        // BLOCK, and CONFLATE with more pending tokens than slots: backpressure onto the feed
+        bool waited = false;
+        while (!queue.try_push(std::move(event)))
+        {
+            if (!strategy_running_.load(std::memory_order_acquire))
+            {
+                ingress_dropped_++;
+                return;
+            }
+            waited = true;
+            std::this_thread::yield();
+        }
+
+        if (waited)
+        {
+            ingress_waits_++;
+        }
+        ingress_enqueued_++;
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::start_strategy_threads()
+    {
+        if (config_.strategy_threads <= 0 || strategy_running_.exchange(true))
+        {
+            return;
+        }
+
+        size_t count = strategy_parkers_.size();
+        for (size_t i = 0; i < count; i++)
+        {
+            strategy_threads_.emplace_back([this, i, count]()
+                                           { strategy_loop(i, count); });
+        }
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::stop_strategy_threads()
+    {
+        strategy_running_.store(false, std::memory_order_release);
+        for (auto &parker : strategy_parkers_)
+        {
+            parker->wake();
+        }
+        for (auto &thread : strategy_threads_)
+        {
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+        strategy_threads_.clear();
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::strategy_loop(size_t index, size_t thread_count)
+    {
+        if (config_.strategy_cpu >= 0)
+        {
+            orderbook_detail::pin_current_thread(config_.strategy_cpu + static_cast<int>(index));
+        }
+
+        auto has_work = [this, index, thread_count]()
+        {
+            if (!strategy_running_.load(std::memory_order_acquire))
+            {
+                return true;
+            }
+            for (size_t s = index; s < shards_.size(); s += thread_count)
+            {
+                for (auto *queue : shards_[s]->rings())
+                {
+                    if (queue && queue->size() > 0)
+                    {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        };
+
+        BookEvent event;
+        size_t idle_spins = 0;
+        while (strategy_running_.load(std::memory_order_acquire))
+        {
+            bool worked = false;
+            for (size_t s = index; s < shards_.size(); s += thread_count)
+            {
+                auto &shard = *shards_[s];
+                for (auto *queue : shard.rings())
+                {
+                    while (queue && queue->try_pop(event))
+                    {
+                        process_event(shard, event);
+                        worked = true;
+                    }
+                }
+            }
+
+            // Spin briefly to catch bursts, then sleep until a feed pushes
+            if (worked)
+            {
+                idle_spins = 0;
+            }
+            else if (++idle_spins > 1024)
+            {
+                strategy_parkers_[index]->park(has_work);
+                idle_spins = 0;
+            }
+        }
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::process_event(FeedShard &shard, BookEvent &event)
+    {
+        if (event.conflated)
+        {
+            // Take the newest book and clear the dirty flag; later updates queue a new marker
+            std::lock_guard<std::mutex> lock(shard.conflation_mutex);
+            auto it = shard.conflation.find(event.asset_id);
+            if (it == shard.conflation.end() || !it->second.dirty)
+            {
+                return; // Unsubscribed, or went stale, while queued
+            }
+            event.book = std::move(it->second.latest);
+            event.condition_id = it->second.condition_id;
+            it->second.dirty = false;
+        }
+
+        // Queued before its token went stale: withheld, like get_orderbook() does. Only
+        // looked up while the shard has stale books at all
+        if (shard.stale_books.load(std::memory_order_relaxed) != 0)
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.books_mutex);
+            auto health = shard.health.find(event.asset_id);
+            if (health != shard.health.end() && health->second.stale)
+            {
+                ingress_withheld_++;
+                return;
+            }
+        }
+
+        // Staleness of what the strategy sees: local receive time -> now
+        uint64_t latency_ns = clock_ns() - event.book.timestamp_ns;
+        dispatch_latency_ns_total_ += latency_ns;
+        uint64_t max_ns = dispatch_latency_ns_max_.load(std::memory_order_relaxed);
+        while (latency_ns > max_ns && !dispatch_latency_ns_max_.compare_exchange_weak(max_ns, latency_ns))
+        {
+        }
+        ingress_delivered_++;
+
+        dispatch_update(event.condition_id, event.asset_id, event.book);
+    }
+
+    template <BookStrategy Strategy>
+    IngressStats BasicOrderbookManager<Strategy>::ingress_stats() const
+    {
+        IngressStats stats;
+        for (const auto &shard : shards_)
+        {
+            for (const auto *queue : shard->rings())
+            {
+                if (queue)
+                {
+                    stats.depth += queue->size();
+                    stats.capacity += queue->capacity();
+                    stats.high_water = std::max(stats.high_water, queue->high_water_mark());
+                }
+            }
+        }
+        stats.enqueued = ingress_enqueued_.load();
+        stats.dropped = ingress_dropped_.load();
+        stats.producer_waits = ingress_waits_.load();
+        stats.delivered = ingress_delivered_.load();
+        stats.conflated = ingress_conflated_.load();
+        stats.withheld = ingress_withheld_.load();
+        if (stats.delivered > 0)
+        {
+            stats.avg_dispatch_latency_us = dispatch_latency_ns_total_.load() / 1e3 / stats.delivered;
+        }
+        stats.max_dispatch_latency_us = dispatch_latency_ns_max_.load() / 1e3;
+        return stats;
+    }
+
+    template <BookStrategy Strategy>
+    ExecutableEdge BasicOrderbookManager<Strategy>::executable_edge(const AskLadder &yes, const AskLadder &no,
+                                                                    double size_usdc, double trigger)
+    {
+        constexpr double EPSILON = 1e-9;
+        ExecutableEdge result;
+
+        // Walk both ladders in price order; each step buys the pairs available at the current
+        // pair of levels. The marginal pair price only rises, so the average does too.
+        size_t i = 0, j = 0;
+        double used_yes = 0.0, used_no = 0.0; // Shares taken from levels i / j
+        double shares = 0.0, cost = 0.0, cost_yes = 0.0, cost_no = 0.0;
+        bool sized = false; // Per-leg notional reached; only max_shares still grows
+        while (i < yes.count && j < no.count)
+        {
+            const auto &level_yes = yes.levels[i];
+            const auto &level_no = no.levels[j];
+            double pair_price = level_yes.price + level_no.price;
+            double available = std::min(level_yes.size - used_yes, level_no.size - used_no);
+
+            // Largest step that keeps (cost + take * pair_price) / (shares + take) <= trigger
+            double take = std::max(0.0, available);
+            if (pair_price > trigger)
+            {
+                take = std::min(take, std::max(0.0, (trigger * shares - cost) / (pair_price - trigger)));
+            }
+
+            if (!sized)
+            {
+                double leg_room = std::min((size_usdc - cost_yes) / level_yes.price, (size_usdc - cost_no) / level_no.price);
+                double sized_take = std::min(take, std::max(0.0, leg_room));
+                if (sized_take > EPSILON)
+                {
+                    result.shares = shares + sized_take;
+                    result.cost = cost + sized_take * pair_price;
+                    result.worst_yes = level_yes.price;
+                    result.worst_no = level_no.price;
+                }
+                sized = sized_take < take - EPSILON;
+            }
+
+            shares += take;
+            cost += take * pair_price;
+            cost_yes += take * level_yes.price;
+            cost_no += take * level_no.price;
+            if (take < available - EPSILON)
+            {
+                break; // Average reached the trigger inside this step
+            }
+
+            used_yes += take;
+            used_no += take;
+            if (level_yes.size - used_yes <= EPSILON)
+            {
+                i++;
+                used_yes = 0.0;
+            }
+            if (level_no.size - used_no <= EPSILON)
+            {
+                j++;
+                used_no = 0.0;
+            }
+        }
+
+        result.max_shares = shares;
+        if (result.shares > 0)
+        {
+            result.avg_combined = result.cost / result.shares;
+            result.edge = result.shares - result.cost;
+        }
+        return result;
+    }
+
+    template <BookStrategy Strategy>
+    void BasicOrderbookManager<Strategy>::check_arb_opportunity(const std::string &condition_id, const std::string &asset_id, const Orderbook &book)
+    {
+        ArbSignal signal;
+        QuoteSnapshot top;
+        bool top_changed = false;
+        {
+            std::shared_lock<std::shared_mutex> lock(markets_mutex_);
+            auto it = markets_.find(condition_id);
+            if (it == markets_.end())
+            {
+                return;
+            }
+            auto &market = *it->second;
+            bool yes_leg = asset_id == market.token_yes;
+            if (!yes_leg && asset_id != market.token_no)
+            {
+                return;
+            }
+
+            {
+                // Keep this leg's depth current and note whether its best level moved
+                std::lock_guard<std::mutex> depth_lock(market.depth_mutex);
+                AskLadder &ladder = yes_leg ? market.asks_yes : market.asks_no;
+                PriceLevel before = ladder.count > 0 ? ladder.levels[0] : PriceLevel{0.0, 0.0};
+                ladder.assign(book.asks);
+                PriceLevel after = ladder.count > 0 ? ladder.levels[0] : PriceLevel{0.0, 0.0};
+                top_changed = before.price != after.price || before.size != after.size;
+                if (top_changed)
+                {
+                    if (market.asks_yes.count > 0)
+                    {
+                        top.ask_yes = market.asks_yes.levels[0].price;
+                        top.ask_yes_size = market.asks_yes.levels[0].size;
+                    }
+                    if (market.asks_no.count > 0)
+                    {
+                        top.ask_no = market.asks_no.levels[0].price;
+                        top.ask_no_size = market.asks_no.levels[0].size;
+                    }
+                    top.last_update_ns = book.timestamp_ns;
+                }
+
+                // Sweep only when the top of book can clear
+                bool both_legs = market.asks_yes.count > 0 && market.asks_no.count > 0;
+                if (!both_legs || market.asks_yes.levels[0].price + market.asks_no.levels[0].price >= config_.trigger_combined)
+                {
+                    market.edge = ExecutableEdge{};
+                }
+                else
+                {
+                    market.edge = executable_edge(market.asks_yes, market.asks_no, config_.size_usdc, config_.trigger_combined);
+                }
+
+                if (market.edge.shares > 0)
+                {
+                    // Top of book from the same ladders the sweep used
+                    signal.executable = market.edge;
+                    signal.ask_yes = market.asks_yes.levels[0].price;
+                    signal.ask_yes_size = market.asks_yes.levels[0].size;
+                    signal.ask_no = market.asks_no.levels[0].price;
+                    signal.ask_no_size = market.asks_no.levels[0].size;
+                    signal.combined = signal.ask_yes + signal.ask_no;
+                }
+            }
+
+            if (signal.executable.shares > 0)
+            {
+                signal.condition_id = market.condition_id;
+                signal.slug = market.slug;
+                signal.token_yes = market.token_yes;
+                signal.token_no = market.token_no;
+                signal.book_ns = book.timestamp_ns;
+            }
+        }
+
+        // Hooks run outside markets_mutex_: a slow strategy must not hold up feeds or (un)subscribe
+        if (top_changed)
+        {
+            strategy_.on_top_of_book_change(condition_id, top);
+        }
+        if (signal.executable.shares <= 0)
+        {
+            return;
+        }
+
+        signal.detected_ns = clock_ns();
+        arb_opportunities_++;
+        strategy_.on_arb(signal);
+    }
+
+} // namespace polymarket
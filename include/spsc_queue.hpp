@@ -0,0 +1,137 @@
+#pragma once
+
+#include "types.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace polymarket
+{
+
+    // Bounded single-producer/single-consumer ring with power-of-two capacity.
+    // Every slot carries a sequence number (Vyukov-style) so the producer can reclaim the
+    // oldest slot for DROP_OLDEST without racing the consumer's read of that slot.
+    // try_push() and push_drop_oldest() must only ever run on one thread; rings fed by
+    // several threads are MpscQueue. Head, tail and each slot sit on their own cache line.
+    template <typename T>
+    class SpscQueue
+    {
+    public:
+        explicit SpscQueue(size_t capacity)
+        {
+            size_t rounded = 2;
+            while (rounded < capacity)
+            {
+                rounded <<= 1;
+            }
+            mask_ = rounded - 1;
+            slots_ = std::make_unique<Slot[]>(rounded);
+            for (size_t i = 0; i < rounded; i++)
+            {
+                slots_[i].seq.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        // Disable copy
+        SpscQueue(const SpscQueue &) = delete;
+        SpscQueue &operator=(const SpscQueue &) = delete;
+
+        // Producer: false if the ring is full
+        bool try_push(T &&value)
+        {
+            size_t pos = head_.load(std::memory_order_relaxed);
+            Slot &slot = slots_[pos & mask_];
+            if (slot.seq.load(std::memory_order_acquire) != pos)
+            {
+                return false; // Not yet released by the consumer
+            }
+
+            slot.value = std::move(value);
+            slot.seq.store(pos + 1, std::memory_order_release);
+            head_.store(pos + 1, std::memory_order_release);
+
+            size_t depth = pos + 1 - tail_.load(std::memory_order_relaxed);
+            if (depth > high_water_.load(std::memory_order_relaxed))
+            {
+                high_water_.store(depth, std::memory_order_relaxed);
+            }
+            return true;
+        }
+
+        // Producer: always enqueues; returns the number of events discarded to make room
+        size_t push_drop_oldest(T &&value)
+        {
+            size_t dropped = 0;
+            while (!try_push(std::move(value)))
+            {
+                T discarded;
+                if (size() >= capacity() && try_pop(discarded))
+                {
+                    dropped++;
+                }
+                else
+                {
+                    std::this_thread::yield(); // Consumer is mid-read of the oldest slot
+                }
+            }
+            return dropped;
+        }
+
+        // Consumer (and the producer when dropping): false if the ring is empty
+        bool try_pop(T &out)
+        {
+            size_t pos = tail_.load(std::memory_order_relaxed);
+            while (true)
+            {
+                Slot &slot = slots_[pos & mask_];
+                auto diff = static_cast<intptr_t>(slot.seq.load(std::memory_order_acquire)) -
+                            static_cast<intptr_t>(pos + 1);
+                if (diff == 0)
+                {
+                    if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        out = std::move(slot.value);
+                        slot.seq.store(pos + mask_ + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false; // Empty
+                }
+                else
+                {
+                    pos = tail_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Occupancy (approximate while both sides are running)
+        size_t size() const
+        {
+            size_t head = head_.load(std::memory_order_acquire);
+            size_t tail = tail_.load(std::memory_order_acquire);
+            return head > tail ? head - tail : 0;
+        }
+        size_t capacity() const { return mask_ + 1; }
+        size_t high_water_mark() const { return high_water_.load(std::memory_order_relaxed); }
+
+    private:
+        struct alignas(CACHE_LINE_SIZE) Slot
+        {
+            std::atomic<size_t> seq{0};
+            T value{};
+        };
+
+        std::unique_ptr<Slot[]> slots_;
+        size_t mask_ = 0;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0}; // Producer-owned
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0}; // Claimed by CAS (consumer, or the producer dropping)
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> high_water_{0};
+    };
+
+} // namespace polymarket
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "types.hpp"
+#include <concepts>
+#include <functional>
+#include <string>
+
+namespace polymarket
+{
+
+    // Callback for orderbook updates
+    using OrderbookUpdateCallback = std::function<void(const std::string &asset_id, const Orderbook &book)>;
+    using TopOfBookCallback = std::function<void(const std::string &condition_id, const QuoteSnapshot &top)>;
+    using ArbOpportunityCallback = std::function<void(const ArbSignal &signal)>;
+
+    // Hooks BasicOrderbookManager calls for every delivered book. They run where callbacks run
+    // (feed or strategy threads, see OrderbookManager::on_orderbook_update) and are resolved at
+    // compile time, so a concrete strategy's hooks inline into the dispatch path.
+    //   on_book                every book, before the arb check
+    //   on_top_of_book_change  the book moved its leg's best ask or size; both legs' tops
+    //   on_arb                 the depth sweep found executable size below the trigger
+    template <typename S>
+    concept BookStrategy = requires(S &strategy, const std::string &id, const Orderbook &book,
+                                    const QuoteSnapshot &top, const ArbSignal &signal) {
+        strategy.on_book(id, book);
+        strategy.on_top_of_book_change(id, top);
+        strategy.on_arb(signal);
+    };
+
+    // No-op hooks to inherit from when a strategy needs only some of them
+    struct StrategyBase
+    {
+        void on_book(const std::string &, const Orderbook &) {}
+        void on_top_of_book_change(const std::string &, const QuoteSnapshot &) {}
+        void on_arb(const ArbSignal &) {}
+    };
+
+    // Runtime-assignable hooks (one indirect call each); the strategy behind OrderbookManager
+    struct CallbackStrategy
+    {
+        OrderbookUpdateCallback book;
+        TopOfBookCallback top_of_book;
+        ArbOpportunityCallback arb;
+
+        void on_book(const std::string &asset_id, const Orderbook &orderbook)
+        {
+            if (book)
+            {
+                book(asset_id, orderbook);
+            }
+        }
+
+        void on_top_of_book_change(const std::string &condition_id, const QuoteSnapshot &top)
+        {
+            if (top_of_book)
+            {
+                top_of_book(condition_id, top);
+            }
+        }
+
+        void on_arb(const ArbSignal &signal)
+        {
+            if (arb)
+            {
+                arb(signal);
+            }
+        }
+    };
+
+    static_assert(BookStrategy<StrategyBase> && BookStrategy<CallbackStrategy>);
+
+} // namespace polymarket
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace polymarket
+{
+
+    // Sleep/wake handshake for a thread that polls lock-free rings. The consumer spins while
+    // work arrives and calls park() once it runs dry; producers call wake() after each push,
+    // which costs one fence and one load unless the consumer is actually asleep.
+    class ThreadParker
+    {
+    public:
+        // Consumer: sleeps until ready() holds; ready() is checked under the lock after the
+        // parked flag is raised, so a push that raced with the last poll is not missed
+        template <typename Ready>
+        void park(Ready ready)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            parked_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            cv_.wait(lock, ready);
+            parked_.store(false, std::memory_order_relaxed);
+        }
+
+        // Producer, after the push (or the stop flag) is visible
+        void wake()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (parked_.load(std::memory_order_relaxed))
+            {
+                // Taking the lock orders the notify after the consumer's last ready() check
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                }
+                cv_.notify_one();
+            }
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::atomic<bool> parked_{false};
+    };
+
+} // namespace polymarket
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace polymarket
+{
+
+    // Hashed timing wheel: a timer lands in slot (deadline / tick) % slots, so scheduling and
+    // cancelling are O(1) and advance() only visits the slots the clock passed, however many
+    // timers are pending. Deadlines beyond one revolution wait in their slot until the clock
+    // reaches them. Not thread-safe; the owner serializes access.
+    template <typename T>
+    class TimerWheel
+    {
+    public:
+        using TimerId = uint64_t;
+
+        TimerWheel(uint64_t tick_ms, size_t slots, uint64_t now_ms)
+            : tick_ms_(std::max<uint64_t>(1, tick_ms)),
+              slots_(std::max<size_t>(1, slots)),
+              current_tick_(now_ms / tick_ms_)
+        {
+        }
+
+        // Fires on the first advance() at or after deadline_ms (past deadlines: the next one)
+        TimerId schedule(uint64_t deadline_ms, T payload)
+        {
+            TimerId id = next_id_++;
+            uint64_t tick = std::max(deadline_ms / tick_ms_, current_tick_);
+            size_t slot = static_cast<size_t>(tick % slots_.size());
+            slots_[slot].push_back({id, deadline_ms, std::move(payload)});
+            where_.emplace(id, slot);
+            return id;
+        }
+
+        // False if the timer already fired or was cancelled
+        bool cancel(TimerId id)
+        {
+            auto it = where_.find(id);
+            if (it == where_.end())
+                return false;
+            auto &entries = slots_[it->second];
+            for (size_t i = 0; i < entries.size(); i++)
+            {
+                if (entries[i].id == id)
+                {
+                    entries[i] = std::move(entries.back());
+                    entries.pop_back();
+                    break;
+                }
+            }
+            where_.erase(it);
+            return true;
+        }
+
+        // Move the clock to now_ms and hand every due timer to fire(payload), earliest slot
+        // first. fire may schedule or cancel timers; new ones due now fire on the next advance.
+        template <typename Fn>
+        size_t advance(uint64_t now_ms, Fn &&fire)
+        {
+            uint64_t target = now_ms / tick_ms_;
+            if (target < current_tick_)
+                return 0;
+
+            // A gap longer than a revolution visits each slot once
+            uint64_t last = std::min(target, current_tick_ + slots_.size() - 1);
+            std::vector<Entry> due;
+            for (uint64_t tick = current_tick_; tick <= last; tick++)
+            {
+                auto &entries = slots_[static_cast<size_t>(tick % slots_.size())];
+                for (size_t i = 0; i < entries.size();)
+                {
+                    if (entries[i].deadline_ms <= now_ms)
+                    {
+                        where_.erase(entries[i].id);
+                        due.push_back(std::move(entries[i]));
+                        entries[i] = std::move(entries.back());
+                        entries.pop_back();
+                    }
+                    else
+                    {
+                        i++;
+                    }
+                }
+            }
+            current_tick_ = target;
+
+            std::sort(due.begin(), due.end(), [](const Entry &a, const Entry &b)
+                      { return a.deadline_ms != b.deadline_ms ? a.deadline_ms < b.deadline_ms : a.id < b.id; });
+            for (auto &entry : due)
+            {
+                fire(entry.payload);
+            }
+            return due.size();
+        }
+
+        size_t size() const { return where_.size(); }
+
+    private:
+        struct Entry
+        {
+            TimerId id;
+            uint64_t deadline_ms;
+            T payload;
+        };
+
+        uint64_t tick_ms_;
+        std::vector<std::vector<Entry>> slots_;
+        std::unordered_map<TimerId, size_t> where_; // Pending timer -> slot
+        uint64_t current_tick_;
+        TimerId next_id_ = 1;
+    };
+
+} // namespace polymarket
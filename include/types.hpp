@@ -5,10 +5,15 @@
 #include <cstdint>
 #include <atomic>
 #include <chrono>
+#include <array>
+#include <mutex>
+#include <algorithm>
 
 namespace polymarket
 {
 
+    constexpr size_t CACHE_LINE_SIZE = 64;
+
     // Price level in orderbook
     struct PriceLevel
     {
@@ -22,7 +27,8 @@ namespace polymarket
         std::string asset_id;
         std::vector<PriceLevel> bids;
         std::vector<PriceLevel> asks;
-        uint64_t timestamp_ns;
+        uint64_t timestamp_ns;                // Local receive time
+        uint64_t exchange_timestamp_ms{0};    // Payload timestamp (0 if the feed omitted it)
 
         // Best bid = highest bid price
         double best_bid() const
@@ -101,9 +107,11 @@ namespace polymarket
         std::string question;
         std::string market_slug;
         std::vector<Token> tokens;
-        bool neg_risk;
-        bool active;
-        bool closed;
+        bool neg_risk{false};
+        std::string neg_risk_market_id; // Groups the conditions of one neg-risk event
+        size_t neg_risk_outcomes{0};    // Conditions in that event once all were fetched (0: unknown)
+        bool active{false};
+        bool closed{false};
 
         std::string token_yes() const
         {
@@ -135,6 +143,9 @@ namespace polymarket
         std::string condition_id;
         std::string token_yes;
         std::string token_no;
+        bool neg_risk{false};
+        std::string neg_risk_market_id; // Event grouping (CLOB markets only; not persisted in the catalog)
+        size_t neg_risk_outcomes{0};    // Conditions in the event (0: unknown, no BUY_YES baskets)
 
         // Orderbook state (non-atomic for copyability during fetch)
         double best_ask_yes{0.0};
@@ -157,9 +168,111 @@ namespace polymarket
         }
     };
 
+    // Best asks of one leg, ascending, in a fixed buffer so updates never allocate
+    constexpr size_t MAX_LADDER_LEVELS = 32;
+    struct AskLadder
+    {
+        std::array<PriceLevel, MAX_LADDER_LEVELS> levels{};
+        size_t count = 0;
+
+        void assign(const std::vector<PriceLevel> &asks) // asks sorted ascending
+        {
+            count = std::min(asks.size(), MAX_LADDER_LEVELS);
+            std::copy_n(asks.begin(), count, levels.begin());
+        }
+    };
+
+    // Cost of buying equal YES and NO share counts by sweeping both ask ladders
+    struct ExecutableEdge
+    {
+        double shares = 0.0;       // Pairs to buy: within the per-leg notional and the trigger
+        double cost = 0.0;         // USDC for those pairs, both legs
+        double avg_combined = 0.0; // cost / shares
+        double edge = 0.0;         // shares - cost: USDC locked in at resolution
+        double worst_yes = 0.0;    // Deepest ask touched per leg (limit price for the orders)
+        double worst_no = 0.0;
+        double max_shares = 0.0;   // Most pairs whose average combined cost stays <= trigger
+    };
+
+    // Consistent top of book of both legs
+    struct QuoteSnapshot
+    {
+        double ask_yes = 0.0;
+        double ask_yes_size = 0.0;
+        double ask_no = 0.0;
+        double ask_no_size = 0.0;
+        uint64_t last_update_ns = 0;
+        uint64_t version = 0; // Leg updates so far
+
+        double combined() const { return ask_yes + ask_no; }
+        bool complete() const { return ask_yes > 0 && ask_no > 0; }
+    };
+
+    // Seqlock over both legs' best ask, alone on its cache line. Writers (possibly two feed
+    // threads in arbitrated mode) claim the sequence by CAS to an odd value; readers retry
+    // until they see the same even sequence before and after copying, so a snapshot never
+    // mixes a new YES price with an old NO price.
+    class alignas(CACHE_LINE_SIZE) PairedQuote
+    {
+    public:
+        // One leg; update_ns == 0 keeps the previous update time
+        void store(bool yes_leg, double ask, double size, uint64_t update_ns = 0)
+        {
+            uint64_t seq = seq_.load(std::memory_order_relaxed);
+            while ((seq & 1) || !seq_.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                seq = seq_.load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+
+            (yes_leg ? ask_yes_ : ask_no_).store(ask, std::memory_order_relaxed);
+            (yes_leg ? ask_yes_size_ : ask_no_size_).store(size, std::memory_order_relaxed);
+            if (update_ns != 0)
+            {
+                last_update_ns_.store(update_ns, std::memory_order_relaxed);
+            }
+
+            seq_.store(seq + 2, std::memory_order_release);
+        }
+
+        QuoteSnapshot load() const
+        {
+            QuoteSnapshot snapshot;
+            while (true)
+            {
+                uint64_t before = seq_.load(std::memory_order_acquire);
+                if (before & 1)
+                {
+                    continue; // Write in progress
+                }
+                snapshot.ask_yes = ask_yes_.load(std::memory_order_relaxed);
+                snapshot.ask_yes_size = ask_yes_size_.load(std::memory_order_relaxed);
+                snapshot.ask_no = ask_no_.load(std::memory_order_relaxed);
+                snapshot.ask_no_size = ask_no_size_.load(std::memory_order_relaxed);
+                snapshot.last_update_ns = last_update_ns_.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq_.load(std::memory_order_relaxed) == before)
+                {
+                    snapshot.version = before / 2;
+                    return snapshot;
+                }
+            }
+        }
+
+    private:
+        std::atomic<uint64_t> seq_{0}; // Odd while a writer is inside
+        std::atomic<double> ask_yes_{0.0};
+        std::atomic<double> ask_yes_size_{0.0};
+        std::atomic<double> ask_no_{0.0};
+        std::atomic<double> ask_no_size_{0.0};
+        std::atomic<uint64_t> last_update_ns_{0};
+    };
+    static_assert(sizeof(PairedQuote) == CACHE_LINE_SIZE, "PairedQuote must fill exactly one cache line");
+
     // Thread-safe market state for live orderbook tracking
     struct LiveMarketState
     {
+        // Identity (read-only after construction)
         std::string slug;
         std::string title;
         std::string symbol;
@@ -167,15 +280,15 @@ namespace polymarket
         std::string token_yes;
         std::string token_no;
 
-        // Orderbook state (atomic for thread safety)
-        std::atomic<double> best_ask_yes{0.0};
-        std::atomic<double> best_ask_no{0.0};
-        std::atomic<double> best_ask_yes_size{0.0};
-        std::atomic<double> best_ask_no_size{0.0};
+        // Orderbook state, on its own cache line
+        PairedQuote quote;
+        uint32_t table_id = UINT32_MAX; // Row in OrderbookManager's MarketTable (UINT32_MAX if none)
 
-        // Tracking
-        std::atomic<uint64_t> last_update_ns{0};
-        std::atomic<uint32_t> update_count{0};
+        // Ask depth of both legs and the last pair sweep (off the quote's line; depth_mutex)
+        std::mutex depth_mutex;
+        AskLadder asks_yes;
+        AskLadder asks_no;
+        ExecutableEdge edge;
 
         // Constructor from MarketState
         LiveMarketState() = default;
@@ -183,16 +296,13 @@ namespace polymarket
         explicit LiveMarketState(const MarketState &m)
             : slug(m.slug), title(m.title), symbol(m.symbol), condition_id(m.condition_id), token_yes(m.token_yes), token_no(m.token_no)
         {
-            best_ask_yes.store(m.best_ask_yes);
-            best_ask_no.store(m.best_ask_no);
-            best_ask_yes_size.store(m.best_ask_yes_size);
-            best_ask_no_size.store(m.best_ask_no_size);
+            quote.store(true, m.best_ask_yes, m.best_ask_yes_size);
+            quote.store(false, m.best_ask_no, m.best_ask_no_size);
         }
 
         double combined() const
         {
-            return best_ask_yes.load(std::memory_order_relaxed) +
-                   best_ask_no.load(std::memory_order_relaxed);
+            return quote.load().combined();
         }
 
         bool is_arb_opportunity(double threshold = 0.98) const
@@ -201,6 +311,54 @@ namespace polymarket
         }
     };
 
+    // Copy of both legs taken when an opportunity is detected; safe to hand to another thread
+    struct ArbSignal
+    {
+        std::string condition_id;
+        std::string slug;
+        std::string token_yes;
+        std::string token_no;
+        double ask_yes = 0.0;
+        double ask_yes_size = 0.0;
+        double ask_no = 0.0;
+        double ask_no_size = 0.0;
+        double combined = 0.0;     // Top of book
+        ExecutableEdge executable; // Depth-aware size, cost and edge
+        uint64_t book_ns = 0;      // Receive time of the book that triggered it
+        uint64_t detected_ns = 0;  // When the opportunity was detected
+    };
+
+    // Market-data feeds carrying the same books
+    enum class FeedSource : uint8_t
+    {
+        RTDS = 0, // Real-time data service, clob_market/agg_orderbook topic
+        CLOB = 1  // ws-subscriptions-clob /ws/market channel
+    };
+    constexpr size_t FEED_SOURCE_COUNT = 2;
+
+    // Which feeds OrderbookManager subscribes to
+    enum class FeedMode
+    {
+        RTDS,
+        CLOB,
+        ARBITRATED // Both feeds; first arrival of each book wins, duplicates dropped
+    };
+
+    // What a feed thread does when its strategy ring is full
+    enum class OverflowPolicy
+    {
+        BLOCK,       // Wait for the consumer (backpressure onto the network thread)
+        DROP_OLDEST, // Discard the oldest queued event to make room
+        CONFLATE     // Queue each token at most once; the consumer reads its latest book
+    };
+
+    // What FeedJournal records
+    enum class JournalMode
+    {
+        RAW,  // Every WebSocket message as received
+        BOOKS // Every normalized book OrderbookManager applies (feeds and REST resyncs)
+    };
+
     // WebSocket message types
     enum class WsMessageType
     {
@@ -216,6 +374,7 @@ namespace polymarket
         // API endpoints
         std::string clob_rest_url = "https://clob.polymarket.com";
         std::string clob_ws_url = "wss://ws-subscriptions-clob.polymarket.com/ws/market";
+        std::string clob_user_ws_url = "wss://ws-subscriptions-clob.polymarket.com/ws/user";
         std::string gamma_api_url = "https://gamma-api.polymarket.com";
         std::string rtds_ws_url = "wss://ws-live-data.polymarket.com";
 
@@ -223,12 +382,67 @@ namespace polymarket
         double trigger_combined = 0.98;
         double max_combined = 0.99;
         double size_usdc = 5.0;
+        int arb_slippage_ticks = 0; // Order limits this many ticks above the deepest ask the sweep touched
 
         // Connection settings
         int ws_ping_interval_ms = 5000;
+        int ws_shards = 1; // Market-data connections; markets are spread across them by condition_id
+        int ws_tokens_per_shard = 100; // polymarket_arb sizes ws_shards from this unless --shards is given
+        FeedMode feed_mode = FeedMode::RTDS;
+
+        // Strategy dispatch: 0 runs callbacks on the feed threads; N > 0 hands book events
+        // to N strategy threads through one SPSC ring per feed connection
+        int strategy_threads = 0;
+        size_t ingress_queue_capacity = 4096;
+        OverflowPolicy ingress_overflow = OverflowPolicy::BLOCK;
+        int strategy_cpu = -1; // Pin strategy thread i to core strategy_cpu + i (-1 = no pinning)
+
+        // Execution thread: arb signals older than executor_max_signal_age_ms are skipped
+        size_t executor_queue_capacity = 256;
+        int executor_cpu = -1;
+        int executor_max_signal_age_ms = 250;
+
+        // Neg-risk event baskets: report when the YES ask sum is below 1 - neg_risk_min_edge
+        // or the YES bid sum above 1 + neg_risk_min_edge
+        double neg_risk_min_edge = 0.01;
+
+        // Market lifecycle: windows are only picked up with market_min_time_left_sec to go,
+        // and stop trading (and are unsubscribed) market_expire_lead_sec before they close,
+        // when their warm successor takes over. A successor is looked for
+        // market_discover_lead_sec before its predecessor closes (retried every
+        // market_discover_retry_sec) and subscribed market_presubscribe_sec before it starts.
+        // Pending windows are prefetched on up to market_prefetch_workers threads per pass.
+        int market_min_time_left_sec = 120;
+        int market_expire_lead_sec = 60;
+        int market_discover_lead_sec = 600;
+        int market_discover_retry_sec = 30;
+        int market_presubscribe_sec = 300;
+        int market_prefetch_workers = 8;
+        int market_rediscover_sec = 900; // polymarket_arb's catch-all rediscovery of every timeframe
+
+        // Market-data journal (FeedJournal): segment files of journal_segment_bytes, an index
+        // entry every journal_index_interval records, msync every journal_flush_interval_ms
+        JournalMode journal_mode = JournalMode::RAW;
+        size_t journal_segment_bytes = 64 * 1024 * 1024;
+        size_t journal_index_interval = 256;
+        int journal_flush_interval_ms = 100;
+
+        // Rows in OrderbookManager's structure-of-arrays market table (batch scans)
+        size_t market_table_capacity = 16384;
+        bool log_subscriptions = true; // One line per subscribed market (off in backtest workers)
+
+        // Book health: a token silent this long is treated as stale; stale books are refetched
+        // in one batched REST call at most every resync_interval_ms
+        int book_max_silence_ms = 60000;
+        int resync_interval_ms = 250;
+
         int http_timeout_ms = 5000;
         int max_markets = 50;
 
+        // Gamma slug discovery: concurrent requests and per-slug deadline
+        int gamma_max_in_flight = 16;
+        int gamma_slug_timeout_ms = 3000;
+
         // Crypto tickers for 15m/4h/1h markets
         std::vector<std::string> crypto_tickers = {
             "btc", "eth", "xrp", "sol", "doge", "bnb",
@@ -251,4 +465,12 @@ namespace polymarket
             .count();
     }
 
+    // Utility: get current time in milliseconds (Unix timestamp)
+    inline uint64_t now_ms()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
 } // namespace polymarket
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "types.hpp"
+#include "websocket_client.hpp"
+#include "order_signer.hpp"
+#include "spsc_queue.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <variant>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+namespace polymarket
+{
+
+    // Order lifecycle events from the user channel
+    enum class UserOrderEventType
+    {
+        PLACEMENT,
+        UPDATE, // Partially or fully matched
+        CANCELLATION,
+        UNKNOWN
+    };
+
+    // Settlement state of a trade
+    enum class TradeStatus
+    {
+        MATCHED,
+        MINED,
+        CONFIRMED,
+        RETRYING,
+        FAILED,
+        UNKNOWN
+    };
+
+    struct UserOrderEvent
+    {
+        UserOrderEventType type = UserOrderEventType::UNKNOWN;
+        std::string id;
+        std::string market; // condition_id
+        std::string asset_id;
+        std::string side; // BUY or SELL
+        std::string outcome;
+        double price = 0.0;
+        double original_size = 0.0;
+        double size_matched = 0.0;
+        std::vector<std::string> associate_trades;
+        uint64_t timestamp_ms = 0; // Exchange time
+        uint64_t received_ns = 0;  // Local receive time
+    };
+
+    // Our maker order filled by a trade
+    struct MakerFill
+    {
+        std::string order_id;
+        std::string asset_id;
+        std::string outcome;
+        double price = 0.0;
+        double matched_amount = 0.0;
+    };
+
+    struct UserTradeEvent
+    {
+        TradeStatus status = TradeStatus::UNKNOWN;
+        std::string id;
+        std::string taker_order_id;
+        std::string market; // condition_id
+        std::string asset_id;
+        std::string side;
+        std::string outcome;
+        double price = 0.0;
+        double size = 0.0;
+        std::vector<MakerFill> maker_orders;
+        uint64_t timestamp_ms = 0;
+        uint64_t received_ns = 0;
+    };
+
+    using UserEvent = std::variant<UserOrderEvent, UserTradeEvent>;
+
+    using UserOrderCallback = std::function<void(const UserOrderEvent &)>;
+    using UserTradeCallback = std::function<void(const UserTradeEvent &)>;
+
+    // Authenticated CLOB user channel (/ws/user): push-based order and fill events.
+    // Events go to callbacks on the WebSocket thread and, if enable_queue() was called,
+    // to an SPSC ring drained with poll() by one consumer thread.
+    class UserChannelClient
+    {
+    public:
+        UserChannelClient(const Config &config, const ApiCredentials &creds);
+        ~UserChannelClient();
+
+        // Disable copy
+        UserChannelClient(const UserChannelClient &) = delete;
+        UserChannelClient &operator=(const UserChannelClient &) = delete;
+
+        // Markets (condition_ids) to receive events for; empty means every market of the account.
+        // Changes on a live connection are sent incrementally.
+        void subscribe(const std::vector<std::string> &condition_ids);
+        void unsubscribe(const std::vector<std::string> &condition_ids);
+
+        void on_order(UserOrderCallback callback);
+        void on_trade(UserTradeCallback callback);
+
+        // Queue delivery; fills are never dropped, a full ring applies backpressure.
+        // Call before connect().
+        void enable_queue(size_t capacity = 1024);
+        bool poll(UserEvent &event);
+
+        bool connect();
+        void disconnect();
+        bool is_connected() const;
+        bool wait_until_connected(std::chrono::milliseconds timeout);
+        void run();
+        void stop();
+
+        uint64_t order_events() const { return order_events_.load(); }
+        uint64_t trade_events() const { return trade_events_.load(); }
+
+        // Parse one user-channel payload (object or array of events); exposed for replay/tests
+        static std::vector<UserEvent> parse_events(std::string_view message);
+
+    private:
+        Config config_;
+        ApiCredentials creds_;
+        WebSocketClient ws_;
+
+        std::mutex markets_mutex_;
+        std::vector<std::string> markets_;
+
+        UserOrderCallback on_order_cb_;
+        UserTradeCallback on_trade_cb_;
+        std::unique_ptr<SpscQueue<UserEvent>> queue_;
+        std::atomic<bool> running_{false};
+
+        std::atomic<uint64_t> order_events_{0};
+        std::atomic<uint64_t> trade_events_{0};
+
+        void handle_message(std::string_view message);
+        void send_subscribe();
+        void deliver(UserEvent &&event);
+    };
+
+} // namespace polymarket
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <functional>
 #include <atomic>
 #include <thread>
 #include <mutex>
 #include <memory>
+#include <chrono>
+#include <condition_variable>
 #include <ixwebsocket/IXWebSocket.h>
 
 namespace polymarket
@@ -22,8 +25,36 @@ namespace polymarket
         CLOSED
     };
 
+    // Ref-counted, immutable message payload that can be queued across threads
+    using MessageBuffer = std::shared_ptr<const std::string>;
+
+    // Message delivered in place from the network thread.
+    // data is only valid during the callback; retain() pins the payload for deferred
+    // processing (one copy out of the socket buffer on first call, shared afterwards).
+    class WsMessage
+    {
+    public:
+        explicit WsMessage(const std::string &payload) : data(payload), payload_(payload) {}
+
+        std::string_view data;
+
+        MessageBuffer retain() const
+        {
+            if (!buffer_)
+            {
+                buffer_ = std::make_shared<const std::string>(payload_);
+            }
+            return buffer_;
+        }
+
+    private:
+        const std::string &payload_;
+        mutable MessageBuffer buffer_;
+    };
+
     // Callbacks
     using OnMessageCallback = std::function<void(const std::string &)>;
+    using OnMessageViewCallback = std::function<void(const WsMessage &)>;
     using OnConnectCallback = std::function<void()>;
     using OnDisconnectCallback = std::function<void()>;
     using OnErrorCallback = std::function<void(const std::string &)>;
@@ -46,6 +77,7 @@ namespace polymarket
 
         // Callbacks
         void on_message(OnMessageCallback callback);
+        void on_message_view(OnMessageViewCallback callback); // Zero-copy; preferred for parsers
         void on_connect(OnConnectCallback callback);
         void on_disconnect(OnDisconnectCallback callback);
         void on_error(OnErrorCallback callback);
@@ -56,13 +88,17 @@ namespace polymarket
         bool is_connected() const;
         WsState state() const;
 
+        // Block until the connection is open (and on_connect has run), the session is stopped or timeout
+        bool wait_until_connected(std::chrono::milliseconds timeout);
+
         // Send message
         bool send(const std::string &message);
 
-        // Run event loop (blocking) - IXWebSocket runs in its own thread
+        // Run event loop (blocking) - IXWebSocket runs in its own thread; parks until stop()
         void run();
 
-        // Stop event loop
+        // Stop event loop; wakes run() and waiters immediately. Ends the session of the last
+        // connect() (also if its run() has not started yet); a later connect() starts a new one
         void stop();
 
         // Get statistics
@@ -80,10 +116,19 @@ namespace polymarket
         // State
         std::atomic<WsState> state_;
         std::atomic<bool> running_;
-        std::atomic<bool> should_stop_;
+
+        // Lifecycle signalling for run()/stop()/wait_until_connected(). stop() bumps
+        // stop_generation_; connect() starts a session at the current generation, which
+        // ends once they differ. Both guarded by lifecycle_mutex_.
+        std::mutex lifecycle_mutex_;
+        uint64_t stop_generation_ = 0;
+        uint64_t session_generation_ = 0;
+        std::condition_variable lifecycle_cv_;
+        void notify_lifecycle();
 
         // Callbacks
         OnMessageCallback on_message_cb_;
+        OnMessageViewCallback on_message_view_cb_;
         OnConnectCallback on_connect_cb_;
         OnDisconnectCallback on_disconnect_cb_;
         OnErrorCallback on_error_cb_;
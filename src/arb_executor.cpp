@@ -0,0 +1,161 @@
+#include "arb_executor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace polymarket
+{
+
+    ArbOrderPlan plan_arb_orders(const ExecutableEdge &executable, double tick_size, int slippage_ticks)
+    {
+        if (tick_size <= 0.0)
+        {
+            tick_size = 0.01;
+        }
+        auto limit = [tick_size, slippage_ticks](double worst)
+        {
+            double ticks = std::ceil(worst / tick_size - 1e-9) + std::max(slippage_ticks, 0);
+            return std::min(ticks * tick_size, 1.0 - tick_size);
+        };
+
+        ArbOrderPlan plan;
+        plan.shares = std::floor(executable.shares * 100 + 1e-9) / 100;
+        plan.yes_price = limit(executable.worst_yes);
+        plan.no_price = limit(executable.worst_no);
+        return plan;
+    }
+
+    ArbExecutor::ArbExecutor(const Config &config)
+        : config_(config), queue_(config.executor_queue_capacity)
+    {
+    }
+
+    ArbExecutor::~ArbExecutor()
+    {
+        stop();
+    }
+
+    void ArbExecutor::on_signal(ArbSignalHandler handler)
+    {
+        handler_ = std::move(handler);
+    }
+
+    void ArbExecutor::start()
+    {
+        if (running_.exchange(true))
+        {
+            return; // Already running
+        }
+        thread_ = std::thread([this]()
+                              { run_loop(); });
+    }
+
+    void ArbExecutor::stop()
+    {
+        running_.store(false, std::memory_order_release);
+        parker_.wake();
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    bool ArbExecutor::post(const ArbSignal &signal)
+    {
+        ArbSignal copy = signal;
+        if (!queue_.try_push(std::move(copy)))
+        {
+            dropped_++;
+            return false;
+        }
+        posted_++;
+        parker_.wake();
+        return true;
+    }
+
+    void ArbExecutor::run_loop()
+    {
+        if (config_.executor_cpu >= 0)
+        {
+#ifdef __linux__
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(config_.executor_cpu, &set);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+            {
+                std::cerr << "[Executor] Could not pin executor thread to core " << config_.executor_cpu << std::endl;
+            }
+#endif
+        }
+
+        const uint64_t max_age_ns = static_cast<uint64_t>(config_.executor_max_signal_age_ms) * 1000000ULL;
+        auto has_work = [this]()
+        {
+            return !running_.load(std::memory_order_acquire) || queue_.size() > 0;
+        };
+
+        ArbSignal signal;
+        size_t idle_spins = 0;
+        while (running_.load(std::memory_order_acquire))
+        {
+            if (!queue_.try_pop(signal))
+            {
+                // Spin briefly to catch bursts, then sleep until the next post()
+                if (++idle_spins > 1024)
+                {
+                    parker_.park(has_work);
+                    idle_spins = 0;
+                }
+                continue;
+            }
+            idle_spins = 0;
+
+            // The book has likely moved on; acting on an old snapshot would chase a stale price
+            uint64_t latency_ns = now_ns() - signal.detected_ns;
+            if (latency_ns > max_age_ns)
+            {
+                expired_++;
+                continue;
+            }
+
+            latency_ns_total_.fetch_add(latency_ns, std::memory_order_relaxed);
+            if (latency_ns > latency_ns_max_.load(std::memory_order_relaxed))
+            {
+                latency_ns_max_.store(latency_ns, std::memory_order_relaxed);
+            }
+            executed_++;
+
+            if (handler_)
+            {
+                try
+                {
+                    handler_(signal);
+                }
+                catch (const std::exception &e)
+                {
+                    std::cerr << "[Executor] Handler failed for " << signal.slug << ": " << e.what() << std::endl;
+                }
+            }
+        }
+    }
+
+    ExecutorStats ArbExecutor::stats() const
+    {
+        ExecutorStats stats;
+        stats.posted = posted_.load();
+        stats.dropped = dropped_.load();
+        stats.expired = expired_.load();
+        stats.executed = executed_.load();
+        if (stats.executed > 0)
+        {
+            stats.avg_queue_latency_us = latency_ns_total_.load() / 1e3 / stats.executed;
+        }
+        stats.max_queue_latency_us = latency_ns_max_.load() / 1e3;
+        return stats;
+    }
+
+} // namespace polymarket
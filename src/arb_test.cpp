@@ -237,7 +237,6 @@ int main(int argc, char *argv[])
     std::atomic<double> ws_best_ask_yes{market.best_ask_yes};
     std::atomic<double> ws_best_ask_no{market.best_ask_no};
     std::atomic<bool> opportunity_found{false};
-    std::atomic<bool> ws_connected{false};
     std::mutex price_mutex;
 
     WebSocketClient ws;
@@ -248,7 +247,6 @@ int main(int argc, char *argv[])
     ws.on_connect([&]()
                   {
         std::cout << "    WebSocket connected!\n";
-        ws_connected.store(true);
 
         // Subscribe to orderbook updates for both tokens
         json subscribe_msg;
@@ -309,19 +307,13 @@ int main(int argc, char *argv[])
     ws.on_error([](const std::string &err)
                 { std::cerr << "    WebSocket error: " << err << "\n"; });
 
-    // Start WebSocket in background thread
+    // Connect here so the wait below covers this session; run() parks in a background thread
+    ws.connect();
     std::thread ws_thread([&ws]()
-                          {
-        ws.connect();
-        ws.run(); });
+                          { ws.run(); });
 
     // Wait for connection
-    for (int i = 0; i < 50 && !ws_connected.load(); i++)
-    {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
-
-    if (!ws_connected.load())
+    if (!ws.wait_until_connected(std::chrono::seconds(5)))
     {
         std::cerr << "    Failed to connect to WebSocket, falling back to REST polling\n";
     }
@@ -406,18 +398,16 @@ int main(int argc, char *argv[])
             // Reconnect WebSocket with new tokens
             ws_best_ask_yes.store(0.5);
             ws_best_ask_no.store(0.5);
-            ws_connected.store(false);
 
             ws.set_url("wss://ws-subscriptions-clob.polymarket.com/ws/market");
+            ws.connect();
             ws_thread = std::thread([&ws]()
-                                    {
-                ws.connect();
-                ws.run(); });
+                                    { ws.run(); });
 
             // Wait for reconnection
-            for (int i = 0; i < 50 && !ws_connected.load(); i++)
+            if (!ws.wait_until_connected(std::chrono::seconds(5)))
             {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                std::cerr << "    Failed to reconnect WebSocket, falling back to REST polling\n";
             }
 
             std::cout << "\n";
@@ -0,0 +1,233 @@
+#include "types.hpp"
+#include "backtester.hpp"
+#include "feed_journal.hpp"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <numeric>
+#include <sstream>
+
+using namespace polymarket;
+
+void print_usage()
+{
+    std::cout << "Polymarket Arb Backtester\n"
+              << "=========================\n\n"
+              << "Usage: polymarket_backtest RECORDING... [options]\n\n"
+              << "RECORDING is a journal directory (polymarket_arb --record DIR), a journal segment, a\n"
+              << "JSONL capture, or a directory holding several of them (one per day, say). Every\n"
+              << "market-day is replayed through OrderbookManager on a worker of its own, once per\n"
+              << "parameter set. Options taking a list sweep every combination.\n\n"
+              << "Options:\n"
+              << "  --help             Show this help message\n"
+              << "  --trigger LIST     Trigger thresholds (default: 0.98)\n"
+              << "  --size LIST        USDC per leg (default: 5)\n"
+              << "  --slippage LIST    Ticks of room above the swept asks in order limits (default: 0)\n"
+              << "  --latency-ms LIST  Signal to exchange latency (default: 50)\n"
+              << "  --jitter-ms N      Extra uniform latency in [0, N) (default: 0)\n"
+              << "  --fill-ratio LIST  Share of each ask level we can take at arrival (default: 1)\n"
+              << "  --cooldown-ms N    Per market, no order pair within N ms of the last (default: 1000)\n"
+              << "  --tick N           Tick size for order limits (default: 0.01)\n"
+              << "  --workers N        Worker threads (default: all cores)\n"
+              << std::endl;
+}
+
+std::vector<double> parse_list(const std::string &text)
+{
+    std::vector<double> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty())
+        {
+            values.push_back(std::stod(item));
+        }
+    }
+    return values;
+}
+
+// A journal directory is one recording; any other directory holds recordings
+void collect_recordings(const std::string &path, std::vector<std::string> &recordings)
+{
+    std::error_code error;
+    if (!std::filesystem::is_directory(path, error) || !JournalReader::segments(path).empty())
+    {
+        recordings.push_back(path);
+        return;
+    }
+    std::vector<std::string> children;
+    for (const auto &entry : std::filesystem::directory_iterator(path, error))
+    {
+        auto child = entry.path().string();
+        if (entry.is_directory() ? !JournalReader::segments(child).empty() : entry.path().extension() == ".jsonl")
+        {
+            children.push_back(child);
+        }
+    }
+    std::sort(children.begin(), children.end());
+    recordings.insert(recordings.end(), children.begin(), children.end());
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> recordings;
+    std::vector<double> triggers = {0.98};
+    std::vector<double> sizes = {5.0};
+    std::vector<double> slippages = {0};
+    std::vector<double> latencies = {50.0};
+    std::vector<double> fill_ratios = {1.0};
+    double jitter_ms = 0.0;
+    double cooldown_ms = 1000.0;
+    double tick_size = 0.01;
+    BacktestOptions options;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--help")
+        {
+            print_usage();
+            return 0;
+        }
+        else if (arg == "--trigger" && i + 1 < argc)
+        {
+            triggers = parse_list(argv[++i]);
+        }
+        else if (arg == "--size" && i + 1 < argc)
+        {
+            sizes = parse_list(argv[++i]);
+        }
+        else if (arg == "--slippage" && i + 1 < argc)
+        {
+            slippages = parse_list(argv[++i]);
+        }
+        else if (arg == "--latency-ms" && i + 1 < argc)
+        {
+            latencies = parse_list(argv[++i]);
+        }
+        else if (arg == "--fill-ratio" && i + 1 < argc)
+        {
+            fill_ratios = parse_list(argv[++i]);
+        }
+        else if (arg == "--jitter-ms" && i + 1 < argc)
+        {
+            jitter_ms = std::stod(argv[++i]);
+        }
+        else if (arg == "--cooldown-ms" && i + 1 < argc)
+        {
+            cooldown_ms = std::stod(argv[++i]);
+        }
+        else if (arg == "--tick" && i + 1 < argc)
+        {
+            tick_size = std::stod(argv[++i]);
+        }
+        else if (arg == "--workers" && i + 1 < argc)
+        {
+            options.workers = std::stoi(argv[++i]);
+        }
+        else if (arg.rfind("--", 0) != 0)
+        {
+            collect_recordings(arg, recordings);
+        }
+    }
+
+    if (recordings.empty())
+    {
+        print_usage();
+        return 1;
+    }
+
+    // Cartesian product of the swept lists
+    std::vector<BacktestParams> sweep;
+    for (double trigger : triggers)
+        for (double size : sizes)
+            for (double slippage : slippages)
+                for (double latency : latencies)
+                    for (double fill_ratio : fill_ratios)
+                    {
+                        BacktestParams params;
+                        params.trigger_combined = trigger;
+                        params.size_usdc = size;
+                        params.slippage_ticks = static_cast<int>(slippage);
+                        params.latency_ms = latency;
+                        params.jitter_ms = jitter_ms;
+                        params.fill_ratio = fill_ratio;
+                        params.cooldown_ms = cooldown_ms;
+                        params.tick_size = tick_size;
+                        sweep.push_back(params);
+                    }
+
+    auto started = std::chrono::steady_clock::now();
+    auto units = Backtester::plan(recordings);
+    std::cout << "[Backtest] " << recordings.size() << " recording(s), " << units.size() << " market-day(s), "
+              << sweep.size() << " parameter set(s)" << std::endl;
+    if (units.empty())
+    {
+        std::cerr << "[Error] No market has feed events in these recordings" << std::endl;
+        return 1;
+    }
+
+    Backtester backtester(sweep, options);
+    backtester.on_progress([](size_t done, size_t total)
+                           {
+        if (done == total || done % 50 == 0)
+            std::cout << "\r[Backtest] " << done << "/" << total << " market-days" << std::flush; });
+    auto results = backtester.run(units);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::cout << "\n[Backtest] Done in " << std::fixed << std::setprecision(1) << elapsed << "s" << std::endl;
+
+    // Best PnL first
+    std::vector<size_t> order(results.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&results](size_t a, size_t b)
+                     { return results[a].pnl() > results[b].pnl(); });
+
+    std::cout << "\n"
+              << std::left << std::setw(64) << "Parameters" << std::right
+              << std::setw(9) << "Signals" << std::setw(8) << "Trades" << std::setw(8) << "Fill%"
+              << std::setw(8) << "Full" << std::setw(8) << "Missed" << std::setw(11) << "Cost"
+              << std::setw(10) << "PnL" << std::setw(10) << "Residual"
+              << std::setw(9) << "Cap p10" << std::setw(9) << "p50" << std::setw(9) << "p90" << std::endl;
+    for (size_t index : order)
+    {
+        const auto &result = results[index];
+        std::cout << std::left << std::setw(64) << sweep[index].label() << std::right
+                  << std::setw(9) << result.signals << std::setw(8) << result.trades
+                  << std::setw(8) << std::setprecision(1) << result.fill_rate() * 100
+                  << std::setw(8) << result.full_fills << std::setw(8) << result.missed
+                  << std::setw(11) << std::setprecision(2) << result.cost
+                  << std::setw(10) << result.pnl() << std::setw(10) << result.residual_pnl
+                  << std::setw(9) << result.capture_quantile(0.10)
+                  << std::setw(9) << result.capture_quantile(0.50)
+                  << std::setw(9) << result.capture_quantile(0.90) << std::endl;
+    }
+
+    // Capture distribution of the best set: realized / expected edge per trade
+    const auto &best = results[order.front()];
+    if (!best.captures.empty())
+    {
+        const std::vector<std::pair<double, const char *>> buckets = {
+            {0.0, "< 0"}, {0.25, "0-25%"}, {0.5, "25-50%"}, {0.75, "50-75%"}, {1.0 + 1e-9, "75-100%"}};
+        std::vector<size_t> counts(buckets.size() + 1, 0);
+        for (double capture : best.captures)
+        {
+            size_t bucket = 0;
+            while (bucket < buckets.size() && capture >= buckets[bucket].first)
+                bucket++;
+            counts[bucket]++;
+        }
+        std::cout << "\n[Backtest] Capture distribution (" << sweep[order.front()].label() << "):" << std::endl;
+        for (size_t bucket = 0; bucket < counts.size(); bucket++)
+        {
+            const char *name = bucket < buckets.size() ? buckets[bucket].second : "> 100%";
+            double share = 100.0 * counts[bucket] / best.captures.size();
+            std::cout << "  " << std::left << std::setw(8) << name << std::right << std::setw(7) << counts[bucket]
+                      << "  " << std::string(static_cast<size_t>(share / 2), '#') << " " << std::setprecision(1)
+                      << share << "%" << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,403 @@
+#include "backtester.hpp"
+#include "arb_executor.hpp"
+#include "feed_replay.hpp"
+#include "orderbook.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+namespace polymarket
+{
+
+    namespace
+    {
+        constexpr uint64_t DAY_NS = 86400ULL * 1000000000ULL;
+
+        // One parameter set over one unit: its own manager (trigger and size live in its
+        // config), the orders in flight and the liquidity they already took
+        class Simulation
+        {
+        public:
+            Simulation(const BacktestUnit &unit, const BacktestParams &params, const Config &config,
+                       uint64_t seed, bool keep_trades)
+                : unit_(unit), params_(params), keep_trades_(keep_trades), manager_(config), rng_(seed)
+            {
+                manager_.on_arb_opportunity([this](const ArbSignal &signal)
+                                            { on_signal(signal); });
+            }
+
+            OrderbookManager &manager() { return manager_; }
+
+            // Fill every order pair that has reached the exchange by now_ns, against the books
+            // as they stand before the event at now_ns is applied
+            void settle(uint64_t now_ns)
+            {
+                while (!in_flight_.empty())
+                {
+                    auto next = std::min_element(in_flight_.begin(), in_flight_.end(), [](const BacktestTrade &a, const BacktestTrade &b)
+                                                 { return a.arrival_ns < b.arrival_ns; });
+                    if (next->arrival_ns > now_ns)
+                    {
+                        return;
+                    }
+                    BacktestTrade trade = *next;
+                    in_flight_.erase(next);
+
+                    fill(unit_.market.token_yes, trade.yes_limit, trade.shares, trade.yes_shares, trade.yes_cost);
+                    fill(unit_.market.token_no, trade.no_limit, trade.shares, trade.no_shares, trade.no_cost);
+                    done_.push_back(trade);
+                }
+            }
+
+            BacktestResult finish()
+            {
+                settle(UINT64_MAX); // Still in flight at the end: they meet the last books
+                result_.units = 1;
+
+                double bid_yes = best_bid(unit_.market.token_yes);
+                double bid_no = best_bid(unit_.market.token_no);
+                for (auto &trade : done_)
+                {
+                    double pairs = std::min(trade.yes_shares, trade.no_shares);
+                    double avg_yes = trade.yes_shares > 0.0 ? trade.yes_cost / trade.yes_shares : 0.0;
+                    double avg_no = trade.no_shares > 0.0 ? trade.no_cost / trade.no_shares : 0.0;
+                    double locked = pairs * (1.0 - avg_yes - avg_no);
+                    double residual = (trade.yes_shares - pairs) * (bid_yes - avg_yes) +
+                                      (trade.no_shares - pairs) * (bid_no - avg_no);
+                    trade.pnl = locked + residual;
+
+                    result_.trades++;
+                    result_.requested_shares += 2 * trade.shares;
+                    result_.filled_shares += trade.yes_shares + trade.no_shares;
+                    result_.pairs += pairs;
+                    result_.cost += trade.yes_cost + trade.no_cost;
+                    result_.locked_pnl += locked;
+                    result_.residual_pnl += residual;
+                    result_.full_fills += trade.yes_shares >= trade.shares - 1e-9 && trade.no_shares >= trade.shares - 1e-9;
+                    result_.missed += trade.yes_shares == 0.0 && trade.no_shares == 0.0;
+                    result_.captures.push_back(trade.capture());
+                    if (keep_trades_)
+                    {
+                        result_.trade_log.push_back(trade);
+                    }
+                }
+                return std::move(result_);
+            }
+
+        private:
+            struct Taken
+            {
+                uint64_t book_ns = 0;                      // Book the liquidity was taken from
+                std::vector<std::pair<double, double>> at; // Price -> shares taken
+            };
+
+            const BacktestUnit &unit_;
+            BacktestParams params_;
+            bool keep_trades_;
+            OrderbookManager manager_;
+            std::mt19937_64 rng_;
+
+            std::vector<BacktestTrade> in_flight_;
+            std::vector<BacktestTrade> done_;
+            std::unordered_map<std::string, Taken> taken_; // By token
+            uint64_t last_order_ns_ = 0;
+            BacktestResult result_;
+
+            // Same pricing the live executor uses, then latency
+            void on_signal(const ArbSignal &signal)
+            {
+                if (signal.book_ns < unit_.day_start_ns || signal.book_ns >= unit_.day_end_ns)
+                {
+                    return; // Warm-up before the unit's day
+                }
+                result_.signals++;
+
+                auto cooldown_ns = static_cast<uint64_t>(params_.cooldown_ms * 1e6);
+                if (last_order_ns_ && signal.book_ns < last_order_ns_ + cooldown_ns)
+                {
+                    return;
+                }
+                auto plan = plan_arb_orders(signal.executable, params_.tick_size, params_.slippage_ticks);
+                if (plan.shares <= 0.0 || signal.executable.shares <= 0.0)
+                {
+                    return;
+                }
+                last_order_ns_ = signal.book_ns;
+
+                double latency_ms = params_.latency_ms;
+                if (params_.jitter_ms > 0.0)
+                {
+                    latency_ms += std::uniform_real_distribution<double>(0.0, params_.jitter_ms)(rng_);
+                }
+
+                BacktestTrade trade;
+                trade.condition_id = signal.condition_id;
+                trade.signal_ns = signal.book_ns;
+                trade.arrival_ns = signal.book_ns + static_cast<uint64_t>(latency_ms * 1e6);
+                trade.shares = plan.shares;
+                trade.expected_edge = signal.executable.edge * plan.shares / signal.executable.shares;
+                trade.yes_limit = plan.yes_price;
+                trade.no_limit = plan.no_price;
+                in_flight_.push_back(std::move(trade));
+            }
+
+            // Fill-and-kill against the current asks up to the limit
+            void fill(const std::string &token, double limit, double shares, double &filled, double &cost)
+            {
+                auto book = manager_.get_orderbook(token);
+                if (!book)
+                {
+                    return; // Stale: nothing trustworthy to fill against
+                }
+                auto &taken = taken_[token];
+                if (taken.book_ns != book->timestamp_ns)
+                {
+                    taken = {book->timestamp_ns, {}}; // A new book already reflects earlier fills
+                }
+
+                for (const auto &level : book->asks)
+                {
+                    if (filled >= shares - 1e-9 || level.price > limit + 1e-9)
+                    {
+                        break;
+                    }
+                    auto already = std::find_if(taken.at.begin(), taken.at.end(), [&level](const auto &entry)
+                                                { return std::abs(entry.first - level.price) < 1e-9; });
+                    double used = already != taken.at.end() ? already->second : 0.0;
+                    double take = std::min(level.size * params_.fill_ratio - used, shares - filled);
+                    if (take <= 0.0)
+                    {
+                        continue;
+                    }
+                    filled += take;
+                    cost += take * level.price;
+                    if (already != taken.at.end())
+                    {
+                        already->second += take;
+                    }
+                    else
+                    {
+                        taken.at.emplace_back(level.price, take);
+                    }
+                }
+            }
+
+            double best_bid(const std::string &token) const
+            {
+                auto book = manager_.get_orderbook(token);
+                return book && !book->bids.empty() ? book->bids.front().price : 0.0;
+            }
+        };
+
+        // Hands one replayed stream to every simulation of a unit (FeedReplay's manager interface)
+        struct SimulationFanout
+        {
+            std::vector<std::unique_ptr<Simulation>> &simulations;
+
+            void set_clock(const FeedClock &clock)
+            {
+                for (auto &simulation : simulations)
+                    simulation->manager().set_clock(clock);
+            }
+            void subscribe(const MarketState &market)
+            {
+                for (auto &simulation : simulations)
+                    simulation->manager().subscribe(market);
+            }
+            void inject_message(FeedSource source, std::string_view message, size_t shard)
+            {
+                for (auto &simulation : simulations)
+                    simulation->manager().inject_message(source, message, shard);
+            }
+            void inject_book(FeedSource source, const Orderbook &book, size_t shard)
+            {
+                for (auto &simulation : simulations)
+                    simulation->manager().inject_book(source, book, shard);
+            }
+        };
+    } // namespace
+
+    std::string BacktestParams::label() const
+    {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3) << "trigger=" << trigger_combined
+            << std::setprecision(2) << " size=$" << size_usdc << " slip=" << slippage_ticks
+            << std::setprecision(0) << " latency=" << latency_ms;
+        if (jitter_ms > 0.0)
+            out << "+" << jitter_ms;
+        out << "ms" << std::setprecision(2) << " fill=" << fill_ratio;
+        return out.str();
+    }
+
+    double BacktestResult::capture_quantile(double q) const
+    {
+        if (captures.empty())
+        {
+            return 0.0;
+        }
+        std::vector<double> sorted = captures;
+        size_t index = std::min(sorted.size() - 1, static_cast<size_t>(std::clamp(q, 0.0, 1.0) * sorted.size()));
+        std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+        return sorted[index];
+    }
+
+    void BacktestResult::merge(const BacktestResult &other)
+    {
+        units += other.units;
+        signals += other.signals;
+        trades += other.trades;
+        full_fills += other.full_fills;
+        missed += other.missed;
+        requested_shares += other.requested_shares;
+        filled_shares += other.filled_shares;
+        pairs += other.pairs;
+        cost += other.cost;
+        locked_pnl += other.locked_pnl;
+        residual_pnl += other.residual_pnl;
+        captures.insert(captures.end(), other.captures.begin(), other.captures.end());
+        trade_log.insert(trade_log.end(), other.trade_log.begin(), other.trade_log.end());
+    }
+
+    Backtester::Backtester(std::vector<BacktestParams> sweep, BacktestOptions options)
+        : sweep_(std::move(sweep)), options_(options)
+    {
+        if (sweep_.empty())
+        {
+            sweep_.emplace_back();
+        }
+    }
+
+    std::vector<BacktestUnit> Backtester::plan(const std::vector<std::string> &recordings)
+    {
+        std::vector<BacktestUnit> units;
+        for (const auto &recording : recordings)
+        {
+            ReplaySource source;
+            if (!source.open(recording))
+            {
+                continue;
+            }
+            auto manifest = source.scan();
+            FeedMode feed_mode = manifest.rtds && manifest.clob ? FeedMode::ARBITRATED
+                                 : manifest.rtds                ? FeedMode::RTDS
+                                                                : FeedMode::CLOB;
+            for (size_t i = 0; i < manifest.markets.size(); i++)
+            {
+                const auto &activity = manifest.activity[i];
+                if (activity.events == 0)
+                {
+                    continue;
+                }
+                for (uint64_t day = activity.first_ns / DAY_NS; day <= activity.last_ns / DAY_NS; day++)
+                {
+                    BacktestUnit unit;
+                    unit.recording = recording;
+                    unit.market = manifest.markets[i];
+                    unit.shards = manifest.shards;
+                    unit.feed_mode = feed_mode;
+                    unit.day_start_ns = day * DAY_NS;
+                    unit.day_end_ns = (day + 1) * DAY_NS;
+                    units.push_back(std::move(unit));
+                }
+            }
+        }
+        return units;
+    }
+
+    std::vector<BacktestResult> Backtester::run_unit(const BacktestUnit &unit) const
+    {
+        Config config;
+        config.feed_mode = unit.feed_mode;
+        config.ws_shards = static_cast<int>(unit.shards);
+        config.strategy_threads = 0;
+        config.market_table_capacity = 64;
+        config.log_subscriptions = false;
+
+        std::vector<std::unique_ptr<Simulation>> simulations;
+        uint64_t seed = std::hash<std::string>{}(unit.market.condition_id) ^ unit.day_start_ns;
+        for (size_t i = 0; i < sweep_.size(); i++)
+        {
+            config.trigger_combined = sweep_[i].trigger_combined;
+            config.size_usdc = sweep_[i].size_usdc;
+            simulations.push_back(std::make_unique<Simulation>(unit, sweep_[i], config, seed + i, options_.keep_trades));
+        }
+
+        ReplaySource source;
+        if (source.open(unit.recording))
+        {
+            ReplayOptions replay_options;
+            replay_options.tokens = {unit.market.token_yes, unit.market.token_no};
+            replay_options.until_ns = unit.day_end_ns;
+            FeedReplay replay(replay_options);
+            replay.before_event([&simulations, &replay](const ReplayEvent &)
+                                {
+                for (auto &simulation : simulations)
+                    simulation->settle(replay.now_ns()); });
+            SimulationFanout fanout{simulations};
+            replay.run(source, fanout);
+        }
+
+        std::vector<BacktestResult> results;
+        for (auto &simulation : simulations)
+        {
+            results.push_back(simulation->finish());
+        }
+        return results;
+    }
+
+    std::vector<BacktestResult> Backtester::run(const std::vector<BacktestUnit> &units)
+    {
+        std::vector<std::vector<BacktestResult>> per_unit(units.size());
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex progress_mutex;
+
+        size_t workers = options_.workers > 0 ? static_cast<size_t>(options_.workers)
+                                              : std::max(1u, std::thread::hardware_concurrency());
+        workers = std::min(workers, std::max<size_t>(units.size(), 1));
+
+        auto work = [&]()
+        {
+            for (size_t i = next++; i < units.size(); i = next++)
+            {
+                per_unit[i] = run_unit(units[i]);
+                size_t finished = ++done;
+                if (progress_)
+                {
+                    std::lock_guard<std::mutex> lock(progress_mutex);
+                    progress_(finished, units.size());
+                }
+            }
+        };
+        std::vector<std::thread> pool;
+        for (size_t i = 1; i < workers; i++)
+        {
+            pool.emplace_back(work);
+        }
+        work();
+        for (auto &thread : pool)
+        {
+            thread.join();
+        }
+
+        // Merged in unit order: the totals do not depend on scheduling
+        std::vector<BacktestResult> results(sweep_.size());
+        for (const auto &unit_results : per_unit)
+        {
+            for (size_t i = 0; i < unit_results.size(); i++)
+            {
+                results[i].merge(unit_results[i]);
+            }
+        }
+        return results;
+    }
+
+} // namespace polymarket
@@ -1,5 +1,6 @@
 #include "clob_client.hpp"
 #include "order_signer.hpp"
+#include "order_store.hpp"
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <memory>
@@ -777,7 +778,12 @@ namespace polymarket
         auto headers = get_l2_headers("POST", "/order", body_str);
         auto response = http_.post("/order", body_str, headers);
 
-        return parse_order_response(response.body);
+        auto result = parse_order_response(response.body);
+        if (order_store_)
+        {
+            order_store_->on_post(order, result, order_type);
+        }
+        return result;
     }
 
     std::vector<OrderResponse> ClobClient::post_orders(const std::vector<BatchOrderEntry> &orders)
@@ -830,6 +836,15 @@ namespace polymarket
             results.push_back(parse_order_response(response.body));
         }
 
+        // Responses come back in request order
+        if (order_store_ && results.size() == orders.size())
+        {
+            for (size_t i = 0; i < orders.size(); i++)
+            {
+                order_store_->on_post(orders[i].order, results[i], orders[i].order_type);
+            }
+        }
+
         return results;
     }
 
@@ -855,6 +870,10 @@ namespace polymarket
 
         // Use POST with body for cancel (API accepts this)
         auto response = http_.post("/order", body_str, headers);
+        if (order_store_ && response.ok())
+        {
+            order_store_->on_cancel(parse_canceled_ids(response.body));
+        }
         return response.ok();
     }
 
@@ -866,6 +885,10 @@ namespace polymarket
         auto headers = get_l2_headers("DELETE", "/orders", body_str);
 
         auto response = http_.post("/orders", body_str, headers);
+        if (order_store_ && response.ok())
+        {
+            order_store_->on_cancel(parse_canceled_ids(response.body));
+        }
         return response.ok();
     }
 
@@ -873,6 +896,10 @@ namespace polymarket
     {
         auto headers = get_l2_headers("DELETE", "/cancel-all", "");
         auto response = http_.post("/cancel-all", "{}", headers);
+        if (order_store_ && response.ok())
+        {
+            order_store_->on_cancel(parse_canceled_ids(response.body));
+        }
         return response.ok();
     }
 
@@ -885,6 +912,10 @@ namespace polymarket
         auto headers = get_l2_headers("DELETE", "/cancel-market-orders", body_str);
 
         auto response = http_.post("/cancel-market-orders", body_str, headers);
+        if (order_store_ && response.ok())
+        {
+            order_store_->on_cancel(parse_canceled_ids(response.body));
+        }
         return response.ok();
     }
 
@@ -920,6 +951,59 @@ namespace polymarket
         return parse_open_orders(response.body);
     }
 
+    std::optional<std::vector<OpenOrder>> ClobClient::get_all_open_orders(const std::string &market)
+    {
+        static const std::string END_CURSOR = "LTE=";
+        std::vector<OpenOrder> orders;
+        std::string cursor;
+        while (true)
+        {
+            std::string path = "/orders";
+            std::string separator = "?";
+            if (!market.empty())
+            {
+                path += separator + "market=" + market;
+                separator = "&";
+            }
+            if (!cursor.empty())
+            {
+                path += separator + "next_cursor=" + cursor;
+            }
+
+            auto headers = get_l2_headers("GET", path, "");
+            auto response = http_.get(path, headers);
+            if (!response.ok())
+                return std::nullopt;
+
+            std::string next;
+            try
+            {
+                // Paginated: {"data": [...], "next_cursor": "..."}; older servers return a bare array
+                auto j = json::parse(response.body);
+                if (!j.is_array())
+                {
+                    if (!j.contains("data") || !j["data"].is_array())
+                        return std::nullopt;
+                    if (j.contains("next_cursor") && j["next_cursor"].is_string())
+                        next = j["next_cursor"].get<std::string>();
+                }
+            }
+            catch (...)
+            {
+                return std::nullopt;
+            }
+
+            auto page = parse_open_orders(response.body);
+            orders.insert(orders.end(), page.begin(), page.end());
+
+            if (next.empty() || next == END_CURSOR || next == cursor)
+                break;
+            cursor = next;
+        }
+
+        return orders;
+    }
+
     std::vector<Trade> ClobClient::get_trades(const std::string &next_cursor)
     {
         std::string path = "/trades";
@@ -1241,12 +1325,10 @@ namespace polymarket
             return result;
         }
 
-        // Use a separate HTTP client for Data API
-        HttpClient data_http;
-        data_http.set_base_url(DATA_API_URL);
-        data_http.set_timeout_ms(10000);
+        // Data API lives on another host; reuse the process-wide warm client for it
+        auto data_http = shared_http_client(DATA_API_URL, 10000);
 
-        auto response = data_http.get("/positions?user=" + address);
+        auto response = data_http->get("/positions?user=" + address);
         if (!response.ok())
         {
             return result;
@@ -1420,6 +1502,11 @@ namespace polymarket
                 book.asset_id = j["asset_id"].get<std::string>();
             }
 
+            if (j.contains("timestamp") && j["timestamp"].is_string())
+            {
+                book.exchange_timestamp_ms = std::stoull(j["timestamp"].get<std::string>());
+            }
+
             if (j.contains("bids") && j["bids"].is_array())
             {
                 for (const auto &bid : j["bids"])
@@ -1573,4 +1660,27 @@ namespace polymarket
         return trades;
     }
 
+    std::vector<std::string> ClobClient::parse_canceled_ids(const std::string &json_str)
+    {
+        // {"canceled": [order_id, ...], "not_canceled": {order_id: reason}}
+        std::vector<std::string> ids;
+
+        try
+        {
+            auto j = json::parse(json_str);
+            if (j.contains("canceled") && j["canceled"].is_array())
+            {
+                for (const auto &id : j["canceled"])
+                {
+                    ids.push_back(id.get<std::string>());
+                }
+            }
+        }
+        catch (...)
+        {
+        }
+
+        return ids;
+    }
+
 } // namespace polymarket
@@ -0,0 +1,640 @@
+#include "feed_journal.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace polymarket
+{
+
+    namespace
+    {
+        constexpr char MAGIC[8] = {'P', 'M', 'J', 'R', 'N', 'L', '\0', '\1'};
+        constexpr uint32_t VERSION = 1;
+        constexpr size_t RECORD_HEADER = sizeof(JournalRecordHeader);
+
+        size_t padded(size_t bytes)
+        {
+            return (bytes + 7) & ~size_t(7);
+        }
+
+        uint32_t load_record_bytes(const char *record)
+        {
+            // Committed last by the writer; acquire makes the rest of the record visible
+            return std::atomic_ref<uint32_t>(*reinterpret_cast<uint32_t *>(const_cast<char *>(record)))
+                .load(std::memory_order_acquire);
+        }
+
+        template <typename T>
+        void put(char *&out, const T &value)
+        {
+            std::memcpy(out, &value, sizeof(T));
+            out += sizeof(T);
+        }
+
+        template <typename T>
+        bool get(std::string_view &in, T &value)
+        {
+            if (in.size() < sizeof(T))
+                return false;
+            std::memcpy(&value, in.data(), sizeof(T));
+            in.remove_prefix(sizeof(T));
+            return true;
+        }
+
+        bool get_levels(std::string_view &in, uint32_t count, std::vector<PriceLevel> &levels)
+        {
+            if (in.size() < size_t(count) * 16)
+                return false;
+            levels.resize(count);
+            for (auto &level : levels)
+            {
+                get(in, level.price);
+                get(in, level.size);
+            }
+            return true;
+        }
+    } // namespace
+
+    size_t journal_book_bytes(const Orderbook &book)
+    {
+        return 8 + 2 + book.asset_id.size() + 4 + 4 + 16 * (book.bids.size() + book.asks.size());
+    }
+
+    void encode_journal_book(const Orderbook &book, char *out)
+    {
+        put(out, book.exchange_timestamp_ms);
+        put(out, static_cast<uint16_t>(book.asset_id.size()));
+        std::memcpy(out, book.asset_id.data(), book.asset_id.size());
+        out += book.asset_id.size();
+        put(out, static_cast<uint32_t>(book.bids.size()));
+        put(out, static_cast<uint32_t>(book.asks.size()));
+        for (const auto *levels : {&book.bids, &book.asks})
+        {
+            for (const auto &level : *levels)
+            {
+                put(out, level.price);
+                put(out, level.size);
+            }
+        }
+    }
+
+    bool decode_journal_book(std::string_view payload, Orderbook &book)
+    {
+        uint16_t id_bytes = 0;
+        uint32_t bids = 0, asks = 0;
+        if (!get(payload, book.exchange_timestamp_ms) || !get(payload, id_bytes) || payload.size() < id_bytes)
+            return false;
+        book.asset_id.assign(payload.data(), id_bytes);
+        payload.remove_prefix(id_bytes);
+        return get(payload, bids) && get(payload, asks) &&
+               get_levels(payload, bids, book.bids) && get_levels(payload, asks, book.asks);
+    }
+
+    std::string_view journal_book_asset_id(std::string_view payload)
+    {
+        uint64_t exchange_timestamp_ms = 0;
+        uint16_t id_bytes = 0;
+        if (!get(payload, exchange_timestamp_ms) || !get(payload, id_bytes) || payload.size() < id_bytes)
+            return {};
+        return payload.substr(0, id_bytes);
+    }
+
+    std::string encode_journal_market(const MarketState &market)
+    {
+        std::string out(1, market.neg_risk ? '\1' : '\0');
+        for (const auto *field : {&market.condition_id, &market.token_yes, &market.token_no,
+                                  &market.slug, &market.symbol, &market.neg_risk_market_id})
+        {
+            auto bytes = static_cast<uint16_t>(std::min<size_t>(field->size(), UINT16_MAX));
+            out.append(reinterpret_cast<const char *>(&bytes), sizeof(bytes));
+            out.append(field->data(), bytes);
+        }
+        return out;
+    }
+
+    bool decode_journal_market(std::string_view payload, MarketState &market)
+    {
+        uint8_t neg_risk = 0;
+        if (!get(payload, neg_risk))
+            return false;
+        market.neg_risk = neg_risk != 0;
+        for (auto *field : {&market.condition_id, &market.token_yes, &market.token_no,
+                            &market.slug, &market.symbol, &market.neg_risk_market_id})
+        {
+            uint16_t bytes = 0;
+            if (!get(payload, bytes) || payload.size() < bytes)
+                return false;
+            field->assign(payload.data(), bytes);
+            payload.remove_prefix(bytes);
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------- FeedJournal
+
+    FeedJournal::FeedJournal(const Config &config)
+        : mode_(config.journal_mode),
+          segment_bytes_(std::max<size_t>(config.journal_segment_bytes, 64 * 1024)),
+          index_interval_(std::max<size_t>(config.journal_index_interval, 1)),
+          flush_interval_ms_(std::max(config.journal_flush_interval_ms, 1))
+    {
+    }
+
+    FeedJournal::~FeedJournal()
+    {
+        close();
+    }
+
+    std::string FeedJournal::segment_name(uint64_t sequence)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "journal-%08llu.seg", static_cast<unsigned long long>(sequence));
+        return name;
+    }
+
+    bool FeedJournal::open(const std::string &directory)
+    {
+        if (running_.load())
+        {
+            return false;
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error)
+        {
+            std::cerr << "[FeedJournal] Cannot create " << directory << ": " << error.message() << std::endl;
+            return false;
+        }
+        directory_ = directory;
+
+        // Continue numbering after what an earlier run left
+        next_sequence_ = 0;
+        for (const auto &path : JournalReader::segments(directory))
+        {
+            unsigned long long sequence = 0;
+            if (std::sscanf(std::filesystem::path(path).filename().c_str(), "journal-%llu.seg", &sequence) == 1)
+            {
+                next_sequence_ = std::max<uint64_t>(next_sequence_, sequence + 1);
+            }
+        }
+
+        Segment *first = create_segment();
+        Segment *spare = first ? create_segment() : nullptr;
+        if (!first || !spare)
+        {
+            return false;
+        }
+        active_.store(first);
+        spare_.store(spare);
+
+        running_.store(true);
+        flusher_ = std::thread([this]()
+                               { flusher_loop(); });
+        std::cout << "[FeedJournal] Recording " << (mode_ == JournalMode::RAW ? "raw messages" : "books")
+                  << " to " << directory << std::endl;
+        return true;
+    }
+
+    void FeedJournal::close()
+    {
+        if (!running_.exchange(false))
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+        }
+        wake_.notify_all();
+        if (flusher_.joinable())
+        {
+            flusher_.join();
+        }
+
+        // The flusher sealed every retired segment; the active one is last. The spare was
+        // never written and goes away.
+        Segment *active = active_.exchange(nullptr);
+        if (active)
+        {
+            while (active->writers.load() != 0)
+            {
+                std::this_thread::yield();
+            }
+            seal(*active);
+        }
+        if (Segment *spare = spare_.exchange(nullptr))
+        {
+            munmap(spare->base, spare->file_bytes);
+            ::close(spare->fd);
+            unlink(spare->path.c_str());
+            spare->base = nullptr;
+        }
+        segments_.clear();
+    }
+
+    bool FeedJournal::append_raw(FeedSource source, size_t shard, uint64_t recv_ns, std::string_view message)
+    {
+        return append(JournalRecordKind::RAW, source, shard, recv_ns, message.size(), [message](char *out)
+                      { std::memcpy(out, message.data(), message.size()); });
+    }
+
+    bool FeedJournal::append_book(JournalRecordKind kind, FeedSource source, size_t shard, const Orderbook &book)
+    {
+        return append(kind, source, shard, book.timestamp_ns, journal_book_bytes(book), [&book](char *out)
+                      { encode_journal_book(book, out); });
+    }
+
+    bool FeedJournal::append_market(size_t shard, uint64_t recv_ns, const MarketState &market)
+    {
+        // Subscriptions are rare; the encoding allocation stays off the per-message path
+        std::string payload = encode_journal_market(market);
+        return append(JournalRecordKind::MARKET, FeedSource::CLOB, shard, recv_ns, payload.size(), [&payload](char *out)
+                      { std::memcpy(out, payload.data(), payload.size()); });
+    }
+
+    template <typename Fill>
+    bool FeedJournal::append(JournalRecordKind kind, FeedSource source, size_t shard, uint64_t recv_ns,
+                             size_t payload_bytes, Fill &&fill)
+    {
+        size_t record_bytes = RECORD_HEADER + payload_bytes;
+        size_t total = padded(record_bytes);
+
+        // Twice at most: the writer that fills a segment switches to the spare and retries
+        for (int attempt = 0; attempt < 2; attempt++)
+        {
+            Segment *segment = active_.load();
+            if (!segment || total > segment->limit - sizeof(JournalSegmentHeader))
+            {
+                break;
+            }
+
+            // Announce the write before checking the segment is still current: the flusher
+            // waits for writers to drain after rotation before sealing and unmapping
+            segment->writers.fetch_add(1);
+            if (active_.load() != segment)
+            {
+                segment->writers.fetch_sub(1, std::memory_order_release);
+                continue;
+            }
+
+            uint64_t offset = segment->reserve.fetch_add(total, std::memory_order_relaxed);
+            if (offset + total <= segment->limit)
+            {
+                char *record = segment->base + offset;
+                JournalRecordHeader header{0, static_cast<uint8_t>(kind), static_cast<uint8_t>(source),
+                                           static_cast<uint16_t>(shard), recv_ns};
+                std::memcpy(record, &header, RECORD_HEADER);
+                fill(record + RECORD_HEADER);
+                std::atomic_ref<uint32_t>(*reinterpret_cast<uint32_t *>(record))
+                    .store(static_cast<uint32_t>(record_bytes), std::memory_order_release);
+                segment->writers.fetch_sub(1, std::memory_order_release);
+
+                records_.fetch_add(1, std::memory_order_relaxed);
+                bytes_.fetch_add(total, std::memory_order_relaxed);
+                return true;
+            }
+            segment->writers.fetch_sub(1, std::memory_order_release);
+
+            // The first reservation past the end starts at or before the limit (the one after
+            // the last record that fit); exactly one writer gets it and rotates
+            if (offset <= segment->limit)
+            {
+                rotate();
+            }
+        }
+
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void FeedJournal::rotate()
+    {
+        Segment *next = spare_.exchange(nullptr);
+        if (next)
+        {
+            active_.store(next);
+        }
+        else
+        {
+            rotation_pending_.store(true); // The flusher installs one as soon as it is mapped
+        }
+        wake_.notify_one();
+    }
+
+    FeedJournal::Segment *FeedJournal::create_segment()
+    {
+        auto segment = std::make_unique<Segment>();
+        segment->sequence = next_sequence_++;
+        segment->path = (std::filesystem::path(directory_) / segment_name(segment->sequence)).string();
+        segment->file_bytes = segment_bytes_;
+
+        // Room for one index entry per index_interval minimum-size records
+        size_t index_room = padded((segment_bytes_ / (RECORD_HEADER * index_interval_) + 1) * sizeof(JournalIndexEntry));
+        segment->limit = segment_bytes_ - index_room;
+
+        segment->fd = ::open(segment->path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+        if (segment->fd < 0 || ftruncate(segment->fd, static_cast<off_t>(segment_bytes_)) != 0)
+        {
+            std::cerr << "[FeedJournal] Cannot create segment " << segment->path << std::endl;
+            if (segment->fd >= 0)
+                ::close(segment->fd);
+            return nullptr;
+        }
+        void *addr = mmap(nullptr, segment_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, segment->fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            std::cerr << "[FeedJournal] Cannot map segment " << segment->path << std::endl;
+            ::close(segment->fd);
+            unlink(segment->path.c_str());
+            return nullptr;
+        }
+        segment->base = static_cast<char *>(addr);
+
+        // Touch every page now so the feed thread never takes the first-write fault
+        long page = sysconf(_SC_PAGESIZE);
+        for (size_t offset = 0; offset < segment_bytes_; offset += static_cast<size_t>(page))
+        {
+            segment->base[offset] = 0;
+        }
+
+        JournalSegmentHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.header_bytes = sizeof(JournalSegmentHeader);
+        header.sequence = segment->sequence;
+        header.created_ns = now_ns();
+        std::memcpy(segment->base, &header, sizeof(header));
+        segment->reserve.store(sizeof(JournalSegmentHeader));
+
+        Segment *raw = segment.get();
+        segments_.push_back(std::move(segment));
+        return raw;
+    }
+
+    void FeedJournal::seal(Segment &segment)
+    {
+        if (!segment.base)
+        {
+            return;
+        }
+
+        // Walk the committed records; a reservation that straddled the limit left zeros
+        JournalSegmentHeader header;
+        std::memcpy(&header, segment.base, sizeof(header));
+        std::vector<JournalIndexEntry> index;
+        uint64_t offset = sizeof(JournalSegmentHeader);
+        uint64_t count = 0;
+        while (offset + RECORD_HEADER <= segment.limit)
+        {
+            uint32_t record_bytes = load_record_bytes(segment.base + offset);
+            if (record_bytes < RECORD_HEADER)
+                break;
+            if (count % index_interval_ == 0)
+            {
+                JournalRecordHeader record;
+                std::memcpy(&record, segment.base + offset, RECORD_HEADER);
+                index.push_back({record.recv_ns, offset});
+            }
+            count++;
+            offset += padded(record_bytes);
+        }
+
+        if (!index.empty())
+        {
+            std::memcpy(segment.base + offset, index.data(), index.size() * sizeof(JournalIndexEntry));
+        }
+        header.data_end = offset;
+        header.record_count = count;
+        header.index_offset = offset;
+        header.index_count = index.size();
+        std::memcpy(segment.base, &header, sizeof(header));
+
+        size_t used = offset + index.size() * sizeof(JournalIndexEntry);
+        msync(segment.base, segment.file_bytes, MS_SYNC);
+        munmap(segment.base, segment.file_bytes);
+        segment.base = nullptr;
+        if (ftruncate(segment.fd, static_cast<off_t>(used)) != 0)
+        {
+            std::cerr << "[FeedJournal] Cannot trim " << segment.path << std::endl;
+        }
+        ::close(segment.fd);
+        segment.fd = -1;
+        sealed_.fetch_add(1);
+    }
+
+    void FeedJournal::flusher_loop()
+    {
+        Segment *current = active_.load();
+        auto retire = [this, &current]()
+        {
+            // A writer switched segments: the old one is sealed once its last writer leaves
+            Segment *active = active_.load();
+            if (active && active != current)
+            {
+                while (current->writers.load() != 0)
+                {
+                    std::this_thread::yield();
+                }
+                seal(*current);
+                current = active;
+            }
+        };
+
+        while (running_.load())
+        {
+            {
+                std::unique_lock<std::mutex> lock(wake_mutex_);
+                wake_.wait_for(lock, std::chrono::milliseconds(flush_interval_ms_));
+            }
+            retire();
+
+            // The writer that filled a segment found no spare: install one now
+            if (rotation_pending_.load())
+            {
+                Segment *next = spare_.exchange(nullptr);
+                next = next ? next : create_segment();
+                if (next)
+                {
+                    rotation_pending_.store(false);
+                    active_.store(next);
+                    retire();
+                }
+            }
+            if (!spare_.load())
+            {
+                spare_.store(create_segment());
+            }
+
+            // Hand the dirty pages to the kernel without waiting for the disk
+            uint64_t reserved = std::min<uint64_t>(current->reserve.load(std::memory_order_relaxed), current->limit);
+            if (reserved > current->synced)
+            {
+                long page = sysconf(_SC_PAGESIZE);
+                uint64_t from = current->synced & ~static_cast<uint64_t>(page - 1);
+                msync(current->base + from, reserved - from, MS_ASYNC);
+                current->synced = reserved;
+            }
+        }
+        retire(); // close() seals the active segment
+    }
+
+    JournalStats FeedJournal::stats() const
+    {
+        JournalStats stats;
+        stats.records = records_.load(std::memory_order_relaxed);
+        stats.bytes = bytes_.load(std::memory_order_relaxed);
+        stats.dropped = dropped_.load(std::memory_order_relaxed);
+        stats.segments = sealed_.load();
+        return stats;
+    }
+
+    // ---------------------------------------------------------------- JournalReader
+
+    JournalReader::~JournalReader()
+    {
+        close();
+    }
+
+    bool JournalReader::open(const std::string &path)
+    {
+        close();
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0)
+        {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(JournalSegmentHeader))
+        {
+            close();
+            return false;
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void *addr = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+        if (addr == MAP_FAILED)
+        {
+            close();
+            return false;
+        }
+        base_ = static_cast<const char *>(addr);
+        std::memcpy(&header_, base_, sizeof(header_));
+        if (std::memcmp(header_.magic, MAGIC, sizeof(MAGIC)) != 0 || header_.version != VERSION ||
+            header_.header_bytes != sizeof(JournalSegmentHeader) || header_.data_end > size_ ||
+            header_.index_offset + header_.index_count * sizeof(JournalIndexEntry) > size_)
+        {
+            std::cerr << "[JournalReader] Not a journal segment: " << path << std::endl;
+            close();
+            return false;
+        }
+        offset_ = header_.header_bytes;
+        return true;
+    }
+
+    void JournalReader::close()
+    {
+        if (base_)
+        {
+            munmap(const_cast<char *>(base_), size_);
+            base_ = nullptr;
+        }
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        size_ = 0;
+        offset_ = 0;
+        header_ = {};
+    }
+
+    size_t JournalReader::end() const
+    {
+        return header_.data_end ? header_.data_end : size_;
+    }
+
+    bool JournalReader::next(JournalRecord &record)
+    {
+        if (!base_ || offset_ + RECORD_HEADER > end())
+        {
+            return false;
+        }
+        uint32_t record_bytes = load_record_bytes(base_ + offset_);
+        if (record_bytes < RECORD_HEADER || offset_ + record_bytes > end())
+        {
+            return false; // Not committed yet (or the end of an unsealed segment)
+        }
+
+        JournalRecordHeader header;
+        std::memcpy(&header, base_ + offset_, RECORD_HEADER);
+        record.kind = static_cast<JournalRecordKind>(header.kind);
+        record.source = static_cast<FeedSource>(header.source);
+        record.shard = header.shard;
+        record.recv_ns = header.recv_ns;
+        record.payload = std::string_view(base_ + offset_ + RECORD_HEADER, record_bytes - RECORD_HEADER);
+        offset_ += padded(record_bytes);
+        return true;
+    }
+
+    void JournalReader::seek(uint64_t recv_ns)
+    {
+        rewind();
+        if (!base_)
+        {
+            return;
+        }
+
+        // Last index entry at or before recv_ns, then walk. Writers interleave, so receive
+        // times are only nearly ordered; the index narrows the walk, the walk decides.
+        if (header_.index_count > 0)
+        {
+            const auto *index = reinterpret_cast<const JournalIndexEntry *>(base_ + header_.index_offset);
+            const auto *last = index + header_.index_count;
+            const auto *it = std::upper_bound(index, last, recv_ns, [](uint64_t ns, const JournalIndexEntry &entry)
+                                              { return ns < entry.recv_ns; });
+            if (it != index)
+            {
+                offset_ = (it - 1)->offset;
+            }
+        }
+
+        size_t position = offset_;
+        JournalRecord record;
+        while (next(record))
+        {
+            if (record.recv_ns >= recv_ns)
+            {
+                offset_ = position;
+                return;
+            }
+            position = offset_;
+        }
+    }
+
+    void JournalReader::rewind()
+    {
+        offset_ = base_ ? header_.header_bytes : 0;
+    }
+
+    std::vector<std::string> JournalReader::segments(const std::string &directory)
+    {
+        std::vector<std::string> paths;
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator(directory, error))
+        {
+            auto name = entry.path().filename().string();
+            if (entry.is_regular_file() && name.rfind("journal-", 0) == 0 && entry.path().extension() == ".seg")
+            {
+                paths.push_back(entry.path().string());
+            }
+        }
+        std::sort(paths.begin(), paths.end()); // Zero-padded sequence numbers
+        return paths;
+    }
+
+} // namespace polymarket
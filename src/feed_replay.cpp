@@ -0,0 +1,378 @@
+#include "feed_replay.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+
+namespace polymarket
+{
+
+    using json = nlohmann::json;
+
+    namespace
+    {
+        // Every "asset_id":"..." value of a raw message, without parsing it
+        template <typename Fn>
+        void for_each_asset_id(std::string_view message, Fn &&fn)
+        {
+            static constexpr std::string_view KEY = "\"asset_id\":\"";
+            for (size_t pos = message.find(KEY); pos != std::string_view::npos; pos = message.find(KEY, pos))
+            {
+                pos += KEY.size();
+                size_t end = message.find('"', pos);
+                if (end == std::string_view::npos)
+                {
+                    break;
+                }
+                fn(message.substr(pos, end - pos));
+            }
+        }
+
+        struct TokenHash
+        {
+            using is_transparent = void; // Look up string_views without building strings
+            size_t operator()(std::string_view token) const { return std::hash<std::string_view>{}(token); }
+        };
+    } // namespace
+
+    // ---------------------------------------------------------------- ReplaySource
+
+    bool ReplaySource::open(const std::string &path)
+    {
+        close();
+        path_ = path;
+
+        std::error_code error;
+        if (std::filesystem::is_directory(path, error))
+        {
+            segments_ = JournalReader::segments(path);
+            if (segments_.empty())
+            {
+                std::cerr << "[Replay] No journal segments in " << path << std::endl;
+                return false;
+            }
+        }
+        else
+        {
+            // A segment starts with the journal magic; anything else is read as JSONL
+            std::ifstream probe(path, std::ios::binary);
+            if (!probe)
+            {
+                std::cerr << "[Replay] Cannot open " << path << std::endl;
+                return false;
+            }
+            char magic[6] = {};
+            probe.read(magic, sizeof(magic));
+            if (probe.gcount() == sizeof(magic) && std::memcmp(magic, "PMJRNL", sizeof(magic)) == 0)
+            {
+                segments_ = {path};
+            }
+            else
+            {
+                jsonl_ = true;
+            }
+        }
+
+        rewind();
+        return jsonl_ ? file_.is_open() : reader_.header().header_bytes != 0;
+    }
+
+    void ReplaySource::close()
+    {
+        reader_.close();
+        file_.close();
+        segments_.clear();
+        segment_ = 0;
+        jsonl_ = false;
+        malformed_ = 0;
+    }
+
+    void ReplaySource::rewind()
+    {
+        if (jsonl_)
+        {
+            file_.close();
+            file_.clear();
+            file_.open(path_);
+            malformed_ = 0;
+            return;
+        }
+        segment_ = 0;
+        reader_.open(segments_[0]);
+    }
+
+    bool ReplaySource::next(ReplayEvent &event)
+    {
+        if (jsonl_)
+        {
+            return next_jsonl(event);
+        }
+
+        JournalRecord record;
+        while (!reader_.next(record))
+        {
+            if (++segment_ >= segments_.size())
+            {
+                segment_ = segments_.size();
+                return false;
+            }
+            if (!reader_.open(segments_[segment_]))
+            {
+                continue; // Unreadable segment (logged); keep going with the next
+            }
+        }
+        event.kind = record.kind;
+        event.source = record.source;
+        event.shard = record.shard;
+        event.recv_ns = record.recv_ns;
+        event.payload = record.payload;
+        return true;
+    }
+
+    bool ReplaySource::next_jsonl(ReplayEvent &event)
+    {
+        while (std::getline(file_, line_))
+        {
+            if (line_.empty() || line_.find_first_not_of(" \t\r") == std::string::npos)
+            {
+                continue;
+            }
+            if (parse_line(event))
+            {
+                return true;
+            }
+            malformed_++;
+        }
+        return false;
+    }
+
+    bool ReplaySource::parse_line(ReplayEvent &event)
+    {
+        event = ReplayEvent{};
+        try
+        {
+            auto j = json::parse(line_);
+            bool wrapped = j.is_object() && j.contains("recv_ns") && (j.contains("msg") || j.contains("market"));
+            if (!wrapped)
+            {
+                event.payload = line_; // Bare WebSocket message
+                return true;
+            }
+
+            event.recv_ns = j["recv_ns"].get<uint64_t>();
+            event.shard = j.value("shard", uint16_t(0));
+            event.source = j.value("source", std::string("clob")) == "rtds" ? FeedSource::RTDS : FeedSource::CLOB;
+
+            if (j.contains("market"))
+            {
+                const auto &m = j["market"];
+                MarketState market;
+                market.condition_id = m.at("condition_id").get<std::string>();
+                market.token_yes = m.at("token_yes").get<std::string>();
+                market.token_no = m.at("token_no").get<std::string>();
+                market.slug = m.value("slug", "");
+                market.symbol = m.value("symbol", "");
+                market.neg_risk = m.value("neg_risk", false);
+                market.neg_risk_market_id = m.value("neg_risk_market_id", "");
+                payload_ = encode_journal_market(market);
+                event.kind = JournalRecordKind::MARKET;
+            }
+            else
+            {
+                const auto &msg = j["msg"];
+                payload_ = msg.is_string() ? msg.get<std::string>() : msg.dump();
+                event.kind = JournalRecordKind::RAW;
+            }
+            event.payload = payload_;
+            return true;
+        }
+        catch (const std::exception &)
+        {
+            return false;
+        }
+    }
+
+    ReplayManifest ReplaySource::scan()
+    {
+        ReplayManifest manifest;
+        rewind();
+
+        size_t top_shard = 0;
+        std::unordered_map<std::string, size_t, TokenHash, std::equal_to<>> token_market; // Token -> markets index
+        auto touch = [&manifest, &token_market](std::string_view token, uint64_t recv_ns)
+        {
+            auto it = token_market.find(token);
+            if (it == token_market.end())
+            {
+                return;
+            }
+            auto &activity = manifest.activity[it->second];
+            if (activity.events++ == 0 || recv_ns < activity.first_ns)
+            {
+                activity.first_ns = recv_ns;
+            }
+            activity.last_ns = std::max(activity.last_ns, recv_ns);
+        };
+
+        ReplayEvent event;
+        while (next(event))
+        {
+            manifest.events++;
+            top_shard = std::max<size_t>(top_shard, event.shard);
+            if (event.kind == JournalRecordKind::RAW || event.kind == JournalRecordKind::BOOK)
+            {
+                (event.source == FeedSource::RTDS ? manifest.rtds : manifest.clob) = true;
+            }
+            if (event.recv_ns != 0)
+            {
+                manifest.first_ns = manifest.first_ns ? std::min(manifest.first_ns, event.recv_ns) : event.recv_ns;
+                manifest.last_ns = std::max(manifest.last_ns, event.recv_ns);
+            }
+
+            MarketState market;
+            switch (event.kind)
+            {
+            case JournalRecordKind::MARKET:
+                if (decode_journal_market(event.payload, market))
+                {
+                    token_market.emplace(market.token_yes, manifest.markets.size());
+                    token_market.emplace(market.token_no, manifest.markets.size());
+                    manifest.markets.push_back(std::move(market));
+                    manifest.activity.emplace_back();
+                }
+                break;
+            case JournalRecordKind::RAW:
+                for_each_asset_id(event.payload, [&](std::string_view token)
+                                  { touch(token, event.recv_ns); });
+                break;
+            default:
+                touch(journal_book_asset_id(event.payload), event.recv_ns);
+                break;
+            }
+        }
+        manifest.shards = top_shard + 1;
+
+        rewind();
+        return manifest;
+    }
+
+    // ---------------------------------------------------------------- FeedReplay
+
+    FeedReplay::FeedReplay(ReplayOptions options)
+        : options_(std::move(options))
+    {
+        if (options_.speed <= 0.0)
+        {
+            options_.speed = 1.0;
+        }
+        for (const auto &token : options_.tokens)
+        {
+            token_patterns_.push_back("\"" + token + "\"");
+        }
+    }
+
+    bool FeedReplay::wanted(const ReplayEvent &event) const
+    {
+        if (options_.tokens.empty())
+        {
+            return true;
+        }
+        auto listed = [this](std::string_view token)
+        {
+            return std::find(options_.tokens.begin(), options_.tokens.end(), token) != options_.tokens.end();
+        };
+
+        switch (event.kind)
+        {
+        case JournalRecordKind::RAW:
+            // Substring check: a message naming any wanted token is decoded in full
+            return std::any_of(token_patterns_.begin(), token_patterns_.end(), [&event](const std::string &pattern)
+                               { return event.payload.find(pattern) != std::string_view::npos; });
+        case JournalRecordKind::MARKET:
+        {
+            MarketState market;
+            return decode_journal_market(event.payload, market) && (listed(market.token_yes) || listed(market.token_no));
+        }
+        default:
+            return listed(journal_book_asset_id(event.payload));
+        }
+    }
+
+    void FeedReplay::begin()
+    {
+        running_.store(true);
+        started_ns_ = polymarket::now_ns();
+        now_ns_.store(0);
+        wall_start_ns_ = 0;
+        recorded_start_ns_ = 0;
+    }
+
+    bool FeedReplay::advance(const ReplayEvent &event, ReplayStats &stats)
+    {
+        if (event.recv_ns == 0)
+        {
+            // No receive time: applied at the current replay time (wall time if none yet), unpaced
+            if (!now_ns_.load(std::memory_order_relaxed))
+            {
+                now_ns_.store(polymarket::now_ns(), std::memory_order_relaxed);
+            }
+            return true;
+        }
+
+        // Subscriptions always apply, even those recorded before the range starts
+        bool feed = event.kind != JournalRecordKind::MARKET;
+        if (feed && options_.until_ns && event.recv_ns > options_.until_ns)
+        {
+            running_.store(false);
+            return false;
+        }
+        now_ns_.store(std::max(now_ns_.load(std::memory_order_relaxed), event.recv_ns), std::memory_order_relaxed);
+        if (!feed)
+        {
+            return true;
+        }
+        if (options_.from_ns && event.recv_ns < options_.from_ns)
+        {
+            return false;
+        }
+
+        if (!stats.first_ns)
+        {
+            stats.first_ns = event.recv_ns;
+        }
+        stats.last_ns = std::max(stats.last_ns, event.recv_ns);
+
+        if (options_.pacing == ReplayPacing::ORIGINAL)
+        {
+            uint64_t wall = polymarket::now_ns();
+            if (!wall_start_ns_)
+            {
+                wall_start_ns_ = wall;
+                recorded_start_ns_ = event.recv_ns;
+            }
+            auto offset = static_cast<uint64_t>((event.recv_ns - std::min(event.recv_ns, recorded_start_ns_)) / options_.speed);
+            uint64_t due = wall_start_ns_ + offset;
+            if (due > wall)
+            {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(due - wall));
+            }
+            else
+            {
+                stats.max_behind_ns = std::max(stats.max_behind_ns, wall - due);
+            }
+        }
+        return true;
+    }
+
+    void FeedReplay::finish(const ReplaySource &source, ReplayStats &stats)
+    {
+        stats.malformed = source.malformed();
+        stats.wall_sec = (polymarket::now_ns() - started_ns_) / 1e9;
+        running_.store(false);
+    }
+
+} // namespace polymarket
@@ -1,7 +1,9 @@
 #include "http_client.hpp"
 #include <chrono>
+#include <cstring>
 #include <stdexcept>
 #include <thread>
+#include <unordered_map>
 
 namespace polymarket
 {
@@ -9,6 +11,50 @@ namespace polymarket
     // Global initialization
     static bool g_curl_initialized = false;
 
+    // Shared DNS cache, TLS session cache and connection pool for all HttpClient instances
+    namespace
+    {
+        struct ShareState
+        {
+            CURLSH *handle = nullptr;
+            std::mutex locks[CURL_LOCK_DATA_LAST];
+        };
+
+        void share_lock(CURL *, curl_lock_data data, curl_lock_access, void *userptr)
+        {
+            static_cast<ShareState *>(userptr)->locks[data].lock();
+        }
+
+        void share_unlock(CURL *, curl_lock_data data, void *userptr)
+        {
+            static_cast<ShareState *>(userptr)->locks[data].unlock();
+        }
+
+        // Lives for the whole process: easy handles may still reference it during static destruction
+        ShareState &share_state()
+        {
+            static ShareState *state = []()
+            {
+                auto *s = new ShareState();
+                s->handle = curl_share_init();
+                if (s->handle)
+                {
+                    curl_share_setopt(s->handle, CURLSHOPT_LOCKFUNC, share_lock);
+                    curl_share_setopt(s->handle, CURLSHOPT_UNLOCKFUNC, share_unlock);
+                    curl_share_setopt(s->handle, CURLSHOPT_USERDATA, s);
+                    curl_share_setopt(s->handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+                    curl_share_setopt(s->handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+                    curl_share_setopt(s->handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+                }
+                return s;
+            }();
+            return *state;
+        }
+
+        std::mutex g_registry_mutex;
+        std::unordered_map<std::string, std::shared_ptr<HttpClient>> g_registry;
+    } // namespace
+
     void http_global_init()
     {
         if (!g_curl_initialized)
@@ -20,6 +66,11 @@ namespace polymarket
 
     void http_global_cleanup()
     {
+        {
+            std::lock_guard<std::mutex> lock(g_registry_mutex);
+            g_registry.clear();
+        }
+
         if (g_curl_initialized)
         {
             curl_global_cleanup();
@@ -27,11 +78,27 @@ namespace polymarket
         }
     }
 
+    std::shared_ptr<HttpClient> shared_http_client(const std::string &base_url, long timeout_ms)
+    {
+        std::lock_guard<std::mutex> lock(g_registry_mutex);
+        auto it = g_registry.find(base_url);
+        if (it != g_registry.end())
+        {
+            return it->second;
+        }
+
+        auto client = std::make_shared<HttpClient>();
+        client->set_base_url(base_url);
+        client->set_timeout_ms(timeout_ms);
+        g_registry.emplace(base_url, client);
+        return client;
+    }
+
     HttpClient::HttpClient()
         : curl_(nullptr), headers_(nullptr), timeout_ms_(5000),
           dns_cache_timeout_(60), keepalive_interval_(20),
           heartbeat_running_(false),
-          total_requests_(0), reused_connections_(0),
+          total_requests_(0), reused_connections_(0), new_connections_(0),
           total_latency_ms_(0.0), last_latency_ms_(0.0),
           connection_warm_(false)
     {
@@ -50,7 +117,7 @@ namespace polymarket
           dns_cache_timeout_(other.dns_cache_timeout_), keepalive_interval_(other.keepalive_interval_),
           heartbeat_running_(false),
           total_requests_(other.total_requests_), reused_connections_(other.reused_connections_),
-          total_latency_ms_(other.total_latency_ms_), last_latency_ms_(other.last_latency_ms_),
+          new_connections_(other.new_connections_), total_latency_ms_(other.total_latency_ms_), last_latency_ms_(other.last_latency_ms_),
           connection_warm_(other.connection_warm_)
     {
         other.stop_heartbeat();
@@ -74,6 +141,7 @@ namespace polymarket
             keepalive_interval_ = other.keepalive_interval_;
             total_requests_ = other.total_requests_;
             reused_connections_ = other.reused_connections_;
+            new_connections_ = other.new_connections_;
             total_latency_ms_ = other.total_latency_ms_;
             last_latency_ms_ = other.last_latency_ms_;
             connection_warm_ = other.connection_warm_;
@@ -105,6 +173,12 @@ namespace polymarket
         curl_easy_setopt(curl_, CURLOPT_FRESH_CONNECT, 0L);                     // Reuse existing connections
         curl_easy_setopt(curl_, CURLOPT_DNS_CACHE_TIMEOUT, dns_cache_timeout_); // DNS cache TTL
 
+        // Share DNS, TLS sessions and connections with every other client in the process
+        if (CURLSH *share = share_state().handle)
+        {
+            curl_easy_setopt(curl_, CURLOPT_SHARE, share);
+        }
+
         // HTTP/1.1 keep-alive
         add_header("Connection: keep-alive");
 
@@ -218,15 +292,34 @@ namespace polymarket
         return total_size;
     }
 
-    HttpResponse HttpClient::perform(const std::string &url)
+    HttpResponse HttpClient::perform(const char *method, const std::string &path,
+                                     const std::string *body, struct curl_slist *headers)
     {
         HttpResponse response;
         response.status_code = 0;
 
+        std::string url = base_url_.empty() ? path : base_url_ + path;
+
+        std::lock_guard<std::mutex> lock(curl_mutex_);
+
         auto start = std::chrono::high_resolution_clock::now();
 
+        if (body)
+        {
+            curl_easy_setopt(curl_, CURLOPT_POST, 1L);
+            curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, body->c_str());
+            curl_easy_setopt(curl_, CURLOPT_POSTFIELDSIZE, static_cast<long>(body->size()));
+        }
+        else
+        {
+            curl_easy_setopt(curl_, CURLOPT_HTTPGET, 1L);
+        }
+        // GET/POST are selected above; anything else (DELETE) is sent as a custom verb
+        bool custom = std::strcmp(method, "GET") != 0 && std::strcmp(method, "POST") != 0;
+        curl_easy_setopt(curl_, CURLOPT_CUSTOMREQUEST, custom ? method : nullptr);
+
         curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers_);
+        curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
         curl_easy_setopt(curl_, CURLOPT_TIMEOUT_MS, timeout_ms_);
         curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response.body);
 
@@ -245,39 +338,31 @@ namespace polymarket
 
         // Track connection reuse stats
         {
-            std::lock_guard<std::mutex> lock(stats_mutex_);
+            std::lock_guard<std::mutex> stats_lock(stats_mutex_);
             total_requests_++;
             total_latency_ms_ += response.elapsed_ms;
             last_latency_ms_ = response.elapsed_ms;
 
             // Check if connection was reused
-            long reused = 0;
-            curl_easy_getinfo(curl_, CURLINFO_NUM_CONNECTS, &reused);
-            if (reused == 0)
+            long connects = 0;
+            curl_easy_getinfo(curl_, CURLINFO_NUM_CONNECTS, &connects);
+            if (connects == 0)
             {
                 reused_connections_++;
             }
+            else
+            {
+                new_connections_ += connects;
+            }
         }
 
         return response;
     }
 
-    HttpResponse HttpClient::get(const std::string &path)
-    {
-        std::string url = base_url_.empty() ? path : base_url_ + path;
-
-        curl_easy_setopt(curl_, CURLOPT_HTTPGET, 1L);
-        curl_easy_setopt(curl_, CURLOPT_POST, 0L);
-
-        return perform(url);
-    }
-
-    HttpResponse HttpClient::get(const std::string &path, const std::map<std::string, std::string> &custom_headers)
+    HttpResponse HttpClient::perform_with_headers(const char *method, const std::string &path, const std::string *body,
+                                                  const std::map<std::string, std::string> &custom_headers)
     {
-        // Save original headers
-        struct curl_slist *original_headers = headers_;
-
-        // Add custom headers
+        // Build a per-request header list so concurrent callers never touch headers_
         struct curl_slist *temp_headers = nullptr;
         for (auto h = headers_; h; h = h->next)
         {
@@ -288,99 +373,41 @@ namespace polymarket
             std::string header = key + ": " + value;
             temp_headers = curl_slist_append(temp_headers, header.c_str());
         }
-        headers_ = temp_headers;
 
-        auto response = get(path);
-
-        // Restore original headers
-        curl_slist_free_all(headers_);
-        headers_ = original_headers;
+        auto response = perform(method, path, body, temp_headers);
 
+        curl_slist_free_all(temp_headers);
         return response;
     }
 
-    HttpResponse HttpClient::post(const std::string &path, const std::string &body)
+    HttpResponse HttpClient::get(const std::string &path)
     {
-        std::string url = base_url_.empty() ? path : base_url_ + path;
+        return perform("GET", path, nullptr, headers_);
+    }
 
-        curl_easy_setopt(curl_, CURLOPT_POST, 1L);
-        curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, body.c_str());
-        curl_easy_setopt(curl_, CURLOPT_POSTFIELDSIZE, static_cast<long>(body.size()));
+    HttpResponse HttpClient::get(const std::string &path, const std::map<std::string, std::string> &custom_headers)
+    {
+        return perform_with_headers("GET", path, nullptr, custom_headers);
+    }
 
-        return perform(url);
+    HttpResponse HttpClient::post(const std::string &path, const std::string &body)
+    {
+        return perform("POST", path, &body, headers_);
     }
 
     HttpResponse HttpClient::post(const std::string &path, const std::string &body, const std::map<std::string, std::string> &custom_headers)
     {
-        // Save original headers
-        struct curl_slist *original_headers = headers_;
-
-        // Add custom headers
-        struct curl_slist *temp_headers = nullptr;
-        for (auto h = headers_; h; h = h->next)
-        {
-            temp_headers = curl_slist_append(temp_headers, h->data);
-        }
-        for (const auto &[key, value] : custom_headers)
-        {
-            std::string header = key + ": " + value;
-            temp_headers = curl_slist_append(temp_headers, header.c_str());
-        }
-        headers_ = temp_headers;
-
-        auto response = post(path, body);
-
-        // Restore original headers
-        curl_slist_free_all(headers_);
-        headers_ = original_headers;
-
-        return response;
+        return perform_with_headers("POST", path, &body, custom_headers);
     }
 
     HttpResponse HttpClient::del(const std::string &path, const std::string &body)
     {
-        std::string url = base_url_.empty() ? path : base_url_ + path;
-
-        curl_easy_setopt(curl_, CURLOPT_CUSTOMREQUEST, "DELETE");
-        if (!body.empty())
-        {
-            curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, body.c_str());
-            curl_easy_setopt(curl_, CURLOPT_POSTFIELDSIZE, static_cast<long>(body.size()));
-        }
-
-        auto response = perform(url);
-
-        // Reset to default
-        curl_easy_setopt(curl_, CURLOPT_CUSTOMREQUEST, nullptr);
-
-        return response;
+        return perform("DELETE", path, body.empty() ? nullptr : &body, headers_);
     }
 
     HttpResponse HttpClient::del(const std::string &path, const std::string &body, const std::map<std::string, std::string> &custom_headers)
     {
-        // Save original headers
-        struct curl_slist *original_headers = headers_;
-
-        // Add custom headers
-        struct curl_slist *temp_headers = nullptr;
-        for (auto h = headers_; h; h = h->next)
-        {
-            temp_headers = curl_slist_append(temp_headers, h->data);
-        }
-        for (const auto &[key, value] : custom_headers)
-        {
-            std::string header = key + ": " + value;
-            temp_headers = curl_slist_append(temp_headers, header.c_str());
-        }
-        headers_ = temp_headers;
-
-        auto response = del(path, body);
-
-        // Restore original headers
-        curl_slist_free_all(headers_);
-        headers_ = original_headers;
-
-        return response;
+        return perform_with_headers("DELETE", path, body.empty() ? nullptr : &body, custom_headers);
     }
 
     // ============================================================
@@ -428,8 +455,7 @@ namespace polymarket
                     break;
                 }
 
-                // Send a lightweight GET to keep connection alive
-                std::lock_guard<std::mutex> lock(curl_mutex_);
+                // Send a lightweight GET to keep connection alive (get() serializes on curl_mutex_)
                 if (curl_ && !base_url_.empty())
                 {
                     get("/");
@@ -457,6 +483,7 @@ namespace polymarket
         ConnectionStats stats;
         stats.total_requests = total_requests_;
         stats.reused_connections = reused_connections_;
+        stats.new_connections = new_connections_;
         stats.avg_latency_ms = total_requests_ > 0 ? total_latency_ms_ / total_requests_ : 0.0;
         stats.last_latency_ms = last_latency_ms_;
         stats.connection_warm = connection_warm_;
@@ -1,50 +1,34 @@
 #include "types.hpp"
 #include "http_client.hpp"
 #include "market_fetcher.hpp"
+#include "market_catalog.hpp"
 #include "orderbook.hpp"
+#include "clob_client.hpp"
+#include "user_channel.hpp"
+#include "order_store.hpp"
+#include "arb_executor.hpp"
+#include "neg_risk_scanner.hpp"
+#include "market_lifecycle.hpp"
+#include "feed_journal.hpp"
 #include "order_signer.hpp"
 #include <iostream>
 #include <csignal>
 #include <thread>
 #include <atomic>
 #include <iomanip>
-#include <regex>
 #include <cstdlib>
+#include <cmath>
+#include <future>
 
 using namespace polymarket;
 
-// Extract market expiry timestamp from slug (e.g., "btc-updown-15m-1767170700")
-uint64_t get_market_expiry(const std::string &slug, const std::string &timeframe = "15m")
-{
-    std::regex ts_regex("-(\\d{10})$");
-    std::smatch match;
-    if (std::regex_search(slug, match, ts_regex))
-    {
-        uint64_t start_ts = std::stoull(match[1].str()) * 1000; // to ms
-        if (timeframe == "15m")
-            return start_ts + 15 * 60 * 1000;
-        if (timeframe == "1h")
-            return start_ts + 60 * 60 * 1000;
-        if (timeframe == "4h")
-            return start_ts + 4 * 60 * 60 * 1000;
-        return start_ts + 15 * 60 * 1000;
-    }
-    // Fallback
-    return now_sec() * 1000 + 15 * 60 * 1000;
-}
+// Exchange contracts orders are signed against
+const std::string CTF_EXCHANGE = "0x4bFb41d5B3570DeFd03C39a9A4D8dE6Bd8B8982E";
+const std::string NEG_RISK_CTF_EXCHANGE = "0xC5d563A36AE78145C45a50134d48A1215220f80a";
 
 // Global flag for graceful shutdown
 std::atomic<bool> g_running{true};
 
-// Pre-fetched market config for fast order placement
-struct MarketConfig
-{
-    std::string tick_size = "0.01";
-    bool neg_risk = true;
-};
-std::atomic<bool> g_config_ready{false};
-MarketConfig g_market_config;
-
 void signal_handler(int signal)
 {
     std::cout << "\n[Main] Received signal " << signal << ", shutting down..." << std::endl;
@@ -62,9 +46,19 @@ void print_usage()
               << "  --15m           Fetch 15-minute crypto markets\n"
               << "  --4h            Fetch 4-hour crypto markets\n"
               << "  --1h            Fetch 1-hour crypto markets\n"
-              << "  --neg-risk      Fetch neg_risk binary markets (default)\n"
+              << "  --neg-risk      Fetch neg_risk markets and scan their events for basket arbs\n"
               << "  --max N         Maximum number of markets to fetch (default: 50)\n"
               << "  --trigger N     Trigger threshold for arb (default: 0.98)\n"
+              << "  --slippage N    Ticks of room above the swept asks in order limits (default: 0)\n"
+              << "  --catalog FILE  Persistent market catalog for fast warm starts\n"
+              << "  --shards N      WebSocket connections to spread subscriptions over (default: 1 per 100 tokens)\n"
+              << "  --feed MODE     Orderbook feed: rtds (default), clob, or arb (both, first wins)\n"
+              << "  --strategy-threads N  Threads running callbacks off the feed threads (default: 1, 0 = inline)\n"
+              << "  --overflow POLICY     Strategy ring policy: conflate (default, newest book per token), block, or drop\n"
+              << "  --pin CPU             Pin strategy threads to cores CPU, CPU+1, ...\n"
+              << "  --executor-cpu CPU    Pin the order execution thread to core CPU\n"
+              << "  --record DIR    Record every feed message to a segmented journal in DIR\n"
+              << "  --record-books  Record applied books instead of raw messages (with --record)\n"
               << "  --dry-run       Don't place actual orders (default)\n"
               << "  --live          Place actual orders (requires PRIVATE_KEY, API_KEY, etc)\n"
               << "\nEnvironment variables for live trading:\n"
@@ -87,8 +81,18 @@ int main(int argc, char *argv[])
     bool fetch_neg_risk = false;
     int max_markets = 50;
     double trigger = 0.98;
+    int slippage_ticks = 0;
     bool dry_run = true;
     double size_usdc = 5.0;
+    std::string catalog_path;
+    int ws_shards = 0; // 0 = sized from the market count
+    FeedMode feed_mode = FeedMode::RTDS;
+    int strategy_threads = 1;
+    OverflowPolicy overflow = OverflowPolicy::CONFLATE; // Order signing is slow; act on the newest book only
+    int strategy_cpu = -1;
+    int executor_cpu = -1;
+    std::string record_dir;
+    JournalMode journal_mode = JournalMode::RAW;
 
     for (int i = 1; i < argc; i++)
     {
@@ -126,6 +130,58 @@ int main(int argc, char *argv[])
         {
             trigger = std::stod(argv[++i]);
         }
+        else if (arg == "--slippage" && i + 1 < argc)
+        {
+            slippage_ticks = std::stoi(argv[++i]);
+        }
+        else if (arg == "--catalog" && i + 1 < argc)
+        {
+            catalog_path = argv[++i];
+        }
+        else if (arg == "--shards" && i + 1 < argc)
+        {
+            ws_shards = std::stoi(argv[++i]);
+        }
+        else if (arg == "--feed" && i + 1 < argc)
+        {
+            std::string mode = argv[++i];
+            if (mode == "clob")
+                feed_mode = FeedMode::CLOB;
+            else if (mode == "arb")
+                feed_mode = FeedMode::ARBITRATED;
+            else
+                feed_mode = FeedMode::RTDS;
+        }
+        else if (arg == "--strategy-threads" && i + 1 < argc)
+        {
+            strategy_threads = std::stoi(argv[++i]);
+        }
+        else if (arg == "--overflow" && i + 1 < argc)
+        {
+            std::string policy = argv[++i];
+            if (policy == "drop")
+                overflow = OverflowPolicy::DROP_OLDEST;
+            else if (policy == "block")
+                overflow = OverflowPolicy::BLOCK;
+            else
+                overflow = OverflowPolicy::CONFLATE;
+        }
+        else if (arg == "--pin" && i + 1 < argc)
+        {
+            strategy_cpu = std::stoi(argv[++i]);
+        }
+        else if (arg == "--executor-cpu" && i + 1 < argc)
+        {
+            executor_cpu = std::stoi(argv[++i]);
+        }
+        else if (arg == "--record" && i + 1 < argc)
+        {
+            record_dir = argv[++i];
+        }
+        else if (arg == "--record-books")
+        {
+            journal_mode = JournalMode::BOOKS;
+        }
         else if (arg == "--dry-run")
         {
             dry_run = true;
@@ -167,6 +223,15 @@ int main(int argc, char *argv[])
     Config config;
     config.max_markets = max_markets;
     config.trigger_combined = trigger;
+    config.arb_slippage_ticks = slippage_ticks;
+    config.size_usdc = size_usdc;
+    config.ws_shards = ws_shards;
+    config.feed_mode = feed_mode;
+    config.strategy_threads = strategy_threads;
+    config.ingress_overflow = overflow;
+    config.strategy_cpu = strategy_cpu;
+    config.executor_cpu = executor_cpu;
+    config.journal_mode = journal_mode;
 
     std::cout << "[Config] Trigger threshold: " << std::fixed << std::setprecision(2)
               << config.trigger_combined << std::endl;
@@ -179,6 +244,10 @@ int main(int argc, char *argv[])
     std::unique_ptr<OrderSigner> order_signer;
     ApiCredentials api_creds;
 
+    // Live trading: authenticated client whose posts and cancels feed the local order store
+    std::unique_ptr<ClobClient> trading_client;
+    OrderStore order_store;
+
     if (!dry_run)
     {
         const char *private_key = std::getenv("PRIVATE_KEY");
@@ -202,6 +271,9 @@ int main(int argc, char *argv[])
             api_creds.api_secret = api_secret;
             api_creds.api_passphrase = api_passphrase;
 
+            trading_client = std::make_unique<ClobClient>(config.clob_rest_url, 137, private_key, api_creds);
+            trading_client->set_order_store(&order_store);
+
             if (funder_address)
             {
                 std::cout << "[Signer] Funder address: " << funder_address << std::endl;
@@ -216,24 +288,49 @@ int main(int argc, char *argv[])
 
     // Fetch markets
     MarketFetcher fetcher(config);
-    std::vector<MarketState> markets;
 
-    if (fetch_15m)
+    // Known markets come from the mapped catalog; only unseen slugs go to the network
+    MarketCatalog catalog;
+    if (!catalog_path.empty())
     {
-        auto m = fetcher.fetch_crypto_15m_markets();
-        markets.insert(markets.end(), m.begin(), m.end());
+        if (catalog.load(catalog_path))
+        {
+            std::cout << "[Catalog] Loaded " << catalog.size() << " markets from " << catalog_path << std::endl;
+        }
+        fetcher.set_catalog(&catalog);
+        catalog.start_auto_save(catalog_path);
     }
+    std::vector<MarketState> markets;
 
+    std::vector<std::string> timeframes;
+    if (fetch_15m)
+        timeframes.push_back("15m");
     if (fetch_4h)
+        timeframes.push_back("4h");
+    if (fetch_1h)
+        timeframes.push_back("1h");
+
+    auto discover = [&fetcher](const std::string &timeframe)
     {
-        auto m = fetcher.fetch_crypto_4h_markets();
-        markets.insert(markets.end(), m.begin(), m.end());
+        if (timeframe == "4h")
+            return fetcher.fetch_crypto_4h_markets();
+        if (timeframe == "1h")
+            return fetcher.fetch_crypto_1h_markets();
+        return fetcher.fetch_crypto_15m_markets();
+    };
+
+    // Gamma discovery for each timeframe runs concurrently (each is itself parallel per slug)
+    std::vector<std::future<std::vector<MarketState>>> discoveries;
+    for (const auto &timeframe : timeframes)
+    {
+        discoveries.push_back(std::async(std::launch::async, discover, timeframe));
     }
 
-    if (fetch_1h)
+    std::vector<std::vector<MarketState>> windows; // Per entry of timeframes
+    for (auto &discovery : discoveries)
     {
-        auto m = fetcher.fetch_crypto_1h_markets();
-        markets.insert(markets.end(), m.begin(), m.end());
+        windows.push_back(discovery.get());
+        markets.insert(markets.end(), windows.back().begin(), windows.back().end());
     }
 
     if (fetch_neg_risk)
@@ -242,6 +339,7 @@ int main(int argc, char *argv[])
         for (const auto &m : clob_markets)
         {
             markets.push_back(MarketFetcher::to_market_state(m));
+            catalog.upsert(markets.back());
         }
     }
 
@@ -301,125 +399,188 @@ int main(int argc, char *argv[])
             }
         }
 
+        if (!catalog_path.empty())
+        {
+            catalog.stop_auto_save();
+            catalog.save(catalog_path);
+        }
+
         http_global_cleanup();
         return 0;
     }
 
-    // Filter to get the best market (soonest expiring with enough time left)
-    auto get_best_market = [](const std::vector<MarketState> &all_markets, const std::string &symbol) -> MarketState *
+    // Every window of every ticker and timeframe is tracked at once. Its deadlines are fixed
+    // at discovery: the successor is found, subscribed and warmed minutes ahead, and takes
+    // over from the expiring window in one step
+    MarketLifecycle lifecycle(config);
+    uint64_t start_ms = now_ms();
+    for (size_t i = 0; i < timeframes.size(); i++)
     {
-        uint64_t now_ms = now_sec() * 1000;
-        uint64_t min_time_left = 2 * 60 * 1000; // At least 2 min left
-
-        MarketState *best = nullptr;
-        uint64_t best_expiry = UINT64_MAX;
+        lifecycle.add(windows[i], timeframes[i], start_ms);
+    }
 
-        for (auto &m : const_cast<std::vector<MarketState> &>(all_markets))
+    // Neg-risk event outcomes have no window; they stay tracked until shutdown
+    std::vector<MarketState> event_markets;
+    for (const auto &m : markets)
+    {
+        if (!m.neg_risk_market_id.empty())
         {
-            if (m.symbol != symbol)
-                continue;
-            uint64_t expiry = get_market_expiry(m.slug);
-            if (expiry > now_ms + min_time_left && expiry < best_expiry)
-            {
-                best_expiry = expiry;
-                best = &m;
-            }
+            event_markets.push_back(m);
         }
-        return best;
-    };
-
-    // Pick initial market (BTC by default, like arb-smoke.ts)
-    std::string target_symbol = "btc";
-    MarketState *current_market = get_best_market(markets, target_symbol);
+    }
+    lifecycle.add(event_markets, "", start_ms);
 
-    if (!current_market)
+    if (lifecycle.size() == 0)
     {
-        std::cerr << "[Error] No valid " << target_symbol << " market found!" << std::endl;
+        std::cerr << "[Error] No market with enough time left to trade!" << std::endl;
         http_global_cleanup();
         return 1;
     }
 
-    uint64_t market_expiry = get_market_expiry(current_market->slug);
-    int64_t time_left_sec = (market_expiry - now_sec() * 1000) / 1000;
-    std::cout << "\n[Market] Using: " << current_market->slug
-              << " (expires in " << time_left_sec << "s)" << std::endl;
+    // Feed capacity follows the market count: both legs of every tracked window (and the
+    // successors discovery adds) spread over enough connections
+    if (config.ws_shards <= 0)
+    {
+        size_t tokens = 2 * lifecycle.size();
+        size_t per_shard = static_cast<size_t>(std::max(1, config.ws_tokens_per_shard));
+        config.ws_shards = static_cast<int>(std::max<size_t>(1, (tokens + per_shard - 1) / per_shard));
+    }
+    std::cout << "[Markets] Tracking " << lifecycle.size() << " markets over " << config.ws_shards
+              << " feed connection(s)" << std::endl;
+
+    // Before a window is subscribed: tick size and neg_risk (live), the exchange and both
+    // legs' order templates. Live, one throwaway order is signed against the window's
+    // exchange so a bad key or contract shows up minutes ahead, not on the first signal.
+    // Windows are prefetched in parallel, so each call gets its own client (on the shared
+    // connection pool).
+    lifecycle.on_prefetch([&config, &dry_run, &order_signer](MarketSession &session)
+                          {
+        if (!dry_run)
+        {
+            ClobClient prefetch_client(config.clob_rest_url);
+            auto tick = prefetch_client.get_tick_size(session.market.token_yes);
+            if (!tick)
+                return false;
+            session.tick_size = tick->minimum_tick_size;
+            if (auto neg_risk = prefetch_client.get_neg_risk(session.market.token_yes))
+                session.neg_risk = neg_risk->neg_risk;
+        }
+        session.exchange = session.neg_risk ? NEG_RISK_CTF_EXCHANGE : CTF_EXCHANGE;
+
+        OrderData order{};
+        order.maker = order_signer ? order_signer->address() : "";
+        order.signer = order.maker;
+        order.taker = "0x0000000000000000000000000000000000000000";
+        order.side = OrderSide::BUY;
+        order.fee_rate_bps = "0";
+        order.nonce = "0";
+        order.expiration = "0";
+        order.signature_type = SignatureType::EOA;
+        session.order_yes = order;
+        session.order_yes.token_id = session.market.token_yes;
+        session.order_no = order;
+        session.order_no.token_id = session.market.token_no;
+
+        if (order_signer)
+        {
+            try
+            {
+                OrderData probe = session.order_yes;
+                probe.maker_amount = probe.taker_amount = "0";
+                order_signer->sign_order(probe, session.exchange);
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "[Prefetch] " << session.market.slug << " signing failed: " << e.what() << std::endl;
+                return false;
+            }
+            std::cout << "[Prefetch] " << session.market.slug << " tickSize=" << session.tick_size
+                      << ", negRisk=" << (session.neg_risk ? "true" : "false") << ", signer ready" << std::endl;
+        }
+        return true; });
 
-    // Prefetch tick size and neg_risk for fast order placement
-    if (!dry_run)
+    // Declared before the orderbook manager, whose threads post into it
+    ArbExecutor executor(config);
+    NegRiskScanner neg_risk_scanner(config);
+
+    // Feed recorder; outlives the orderbook manager, whose feed threads append to it
+    FeedJournal journal(config);
+    if (!record_dir.empty())
     {
-        std::cout << "[Prefetch] Fetching tick size and neg_risk..." << std::endl;
-        auto book = fetcher.fetch_orderbook(current_market->token_yes);
-        if (book)
+        if (!journal.open(record_dir))
         {
-            g_market_config.tick_size = "0.01"; // Default for crypto markets
-            g_market_config.neg_risk = true;    // Crypto markets are neg_risk
-            g_config_ready.store(true);
-            std::cout << "[Prefetch] tickSize=" << g_market_config.tick_size
-                      << ", negRisk=" << (g_market_config.neg_risk ? "true" : "false") << std::endl;
+            std::cerr << "[Error] Cannot open journal directory " << record_dir << std::endl;
+            http_global_cleanup();
+            return 1;
         }
     }
 
-    // Create orderbook manager
+    // Create orderbook manager; stale books are refetched over REST in batches
+    ClobClient resync_client(config.clob_rest_url);
     OrderbookManager orderbook_mgr(config);
+    orderbook_mgr.set_resync_client(&resync_client);
+    if (!record_dir.empty())
+    {
+        orderbook_mgr.set_journal(&journal);
+    }
 
-    // Set up arb opportunity callback
-    orderbook_mgr.on_arb_opportunity([&config, &dry_run, &size_usdc, &order_signer, &api_creds, &fetcher, &current_market](const LiveMarketState &market, double combined)
-                                     {
-        double edge = 1.0 - combined;
-        double edge_pct = edge * 100.0;
-        double slippage_buffer = 0.005; // 0.5% slippage per side
-        
-        double yes_price = std::min(market.best_ask_yes.load() + slippage_buffer, 0.99);
-        double no_price = std::min(market.best_ask_no.load() + slippage_buffer, 0.99);
-        
-        // Round to 2 decimals for API compliance
-        yes_price = std::round(yes_price * 100) / 100;
-        no_price = std::round(no_price * 100) / 100;
+    // Execution runs on its own thread: the feed path only posts a snapshot of both legs
+    executor.on_signal([&config, &dry_run, &order_signer, &lifecycle](const ArbSignal &signal)
+                       {
+        const auto &executable = signal.executable;
+
+        // Only the active window of its series; its prefetched parameters and templates
+        auto session = lifecycle.session(signal.condition_id);
+        if (!session || session->phase != MarketPhase::TRADING)
+            return;
+
+        // Equal shares on both legs, limit at the deepest level the sweep touched
+        auto plan = plan_arb_orders(executable, std::strtod(session->tick_size.c_str(), nullptr), config.arb_slippage_ticks);
+        double shares = plan.shares;
+        double yes_price = plan.yes_price;
+        double no_price = plan.no_price;
         
         std::cout << "\n\n🎯 OPPORTUNITY FOUND! Combined=" << std::fixed << std::setprecision(4) 
-                  << combined << " < " << config.trigger_combined << std::endl;
-        std::cout << "  Market: " << market.slug << std::endl;
-        std::cout << "  YES Ask: " << market.best_ask_yes.load() << " -> order @ " << yes_price << std::endl;
-        std::cout << "  NO Ask:  " << market.best_ask_no.load() << " -> order @ " << no_price << std::endl;
-        std::cout << "  Edge: " << std::setprecision(2) << edge_pct << "%" << std::endl;
-        std::cout << "  Size: $" << size_usdc << " per leg" << std::endl;
+                  << signal.combined << " < " << config.trigger_combined << std::endl;
+        std::cout << "  Market: " << signal.slug << std::endl;
+        std::cout << "  YES Ask: " << signal.ask_yes << " (" << std::setprecision(2) << signal.ask_yes_size
+                  << ") -> order @ " << yes_price << std::endl;
+        std::cout << "  NO Ask:  " << std::setprecision(4) << signal.ask_no << " (" << std::setprecision(2) << signal.ask_no_size
+                  << ") -> order @ " << no_price << std::endl;
+        std::cout << "  Executable: " << shares << " pairs @ avg " << std::setprecision(4) << executable.avg_combined
+                  << " | Edge: $" << std::setprecision(2) << executable.edge
+                  << " | Max under trigger: " << executable.max_shares << " pairs" << std::endl;
+        std::cout << "  Size: $" << config.size_usdc << " per leg | tickSize=" << session->tick_size
+                  << " negRisk=" << (session->neg_risk ? "true" : "false") << std::endl;
         
         if (dry_run) {
             std::cout << "  [DRY RUN] Would place orders here\n" << std::endl;
             return;
         }
         
-        if (!order_signer || !g_config_ready.load()) {
+        if (!order_signer) {
             std::cout << "  [ERROR] Order signer not ready\n" << std::endl;
             return;
         }
         
-        // Calculate shares
-        double yes_shares = std::floor((size_usdc / yes_price) * 100) / 100;
-        double no_shares = std::floor((size_usdc / no_price) * 100) / 100;
+        if (shares <= 0) {
+            std::cout << "  [SKIP] Executable size rounds to zero\n" << std::endl;
+            return;
+        }
         
         std::cout << "  [EXECUTING] Creating orders..." << std::endl;
-        std::cout << "    YES: " << yes_shares << " shares @ " << yes_price << std::endl;
-        std::cout << "    NO:  " << no_shares << " shares @ " << no_price << std::endl;
+        std::cout << "    YES: " << shares << " shares @ " << yes_price << std::endl;
+        std::cout << "    NO:  " << shares << " shares @ " << no_price << std::endl;
         
         // Create and sign orders
         // Note: Full order placement would require posting to API with L2 headers
         // This is a placeholder showing the signing works
         try {
-            OrderData yes_order;
-            yes_order.maker = order_signer->address();
-            yes_order.taker = "0x0000000000000000000000000000000000000000";
-            yes_order.token_id = market.token_yes;
-            yes_order.maker_amount = to_wei(size_usdc, 6);
-            yes_order.taker_amount = to_wei(yes_shares, 6);
-            yes_order.side = OrderSide::BUY;
-            yes_order.fee_rate_bps = "0";
-            yes_order.nonce = "0";
-            yes_order.signer = order_signer->address();
-            yes_order.expiration = "0";
-            yes_order.signature_type = SignatureType::EOA;
+            OrderData yes_order = session->order_yes;
+            yes_order.maker_amount = to_wei(std::floor(shares * yes_price * 100) / 100, 6);
+            yes_order.taker_amount = to_wei(shares, 6);
             
-            auto signed_yes = order_signer->sign_order(yes_order, "0xC5d563A36AE78145C45a50134d48A1215220f80a");
+            auto signed_yes = order_signer->sign_order(yes_order, session->exchange);
             std::cout << "    YES order signed: " << signed_yes.signature.substr(0, 20) << "..." << std::endl;
             
             // TODO: Post orders to API with L2 headers
@@ -432,10 +593,64 @@ int main(int argc, char *argv[])
         } catch (const std::exception& e) {
             std::cout << "  [ERROR] Order signing failed: " << e.what() << "\n" << std::endl;
         } });
+    executor.start();
+
+    orderbook_mgr.on_arb_opportunity([&executor](const ArbSignal &signal)
+                                     { executor.post(signal); });
 
-    // Subscribe to current market only
-    std::vector<MarketState> current_markets = {*current_market};
-    orderbook_mgr.subscribe(current_markets);
+    // Successor windows are looked for on schedule (market_discover_lead_sec before a window
+    // closes), in the background; the main loop adds what they find
+    std::vector<std::future<std::vector<MarketState>>> rediscoveries(timeframes.size());
+    auto start_discovery = [&rediscoveries, &timeframes, &discover](const std::string &timeframe)
+    {
+        for (size_t i = 0; i < timeframes.size(); i++)
+        {
+            if (timeframes[i] == timeframe && !rediscoveries[i].valid())
+            {
+                rediscoveries[i] = std::async(std::launch::async, discover, timeframes[i]);
+            }
+        }
+    };
+    lifecycle.on_successor_needed(start_discovery);
+
+    // One manager streams every tracked market; the lifecycle batches (un)subscriptions
+    std::unique_ptr<UserChannelClient> user_channel;
+    lifecycle.on_subscribe([&orderbook_mgr, &user_channel](const std::vector<MarketState> &batch)
+                           {
+        orderbook_mgr.subscribe(batch);
+        if (user_channel)
+        {
+            std::vector<std::string> condition_ids;
+            for (const auto &m : batch)
+                condition_ids.push_back(m.condition_id);
+            user_channel->subscribe(condition_ids);
+        } });
+    lifecycle.on_unsubscribe([&orderbook_mgr, &user_channel](const std::vector<std::string> &condition_ids)
+                             {
+        for (const auto &condition_id : condition_ids)
+            orderbook_mgr.unsubscribe_market(condition_id);
+        if (user_channel)
+            user_channel->unsubscribe(condition_ids); });
+    lifecycle.on_warm_check([&orderbook_mgr](const MarketSession &session)
+                            {
+        MarketState state = orderbook_mgr.get_market(session.market.condition_id);
+        return state.best_ask_yes > 0 && state.best_ask_no > 0; });
+
+    // Prefetch, then subscribe, the initial windows before connecting
+    lifecycle.start(start_ms);
+
+    // Neg-risk events: every outcome streams into the basket scanner. The fetcher completes
+    // events that --max cut short; one it could not complete only reports SELL_YES baskets.
+    if (fetch_neg_risk)
+    {
+        neg_risk_scanner.add_markets(event_markets);
+        if (neg_risk_scanner.event_count() > 0)
+        {
+            neg_risk_scanner.enable_queue();
+            orderbook_mgr.on_orderbook_update([&neg_risk_scanner](const std::string &asset_id, const Orderbook &book)
+                                              { neg_risk_scanner.on_book(asset_id, book); });
+        }
+    }
 
     // Connect to WebSocket
     std::cout << "[WebSocket] Connecting to orderbook stream..." << std::endl;
@@ -451,101 +666,223 @@ int main(int argc, char *argv[])
     std::thread ws_thread([&orderbook_mgr]()
                           { orderbook_mgr.run(); });
 
-    // Main loop - monitor prices and check for market expiry
-    while (g_running.load())
+    if (!orderbook_mgr.wait_until_connected(std::chrono::seconds(5)))
     {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-        uint64_t now_ms = now_sec() * 1000;
-        int64_t time_left = (market_expiry - now_ms) / 1000;
-
-        // Get current market state
-        MarketState state = orderbook_mgr.get_market(current_market->condition_id);
-        double combined = state.best_ask_yes + state.best_ask_no;
+        std::cerr << "[Warn] WebSocket not connected yet, continuing (auto-reconnect enabled)" << std::endl;
+    }
 
-        // Print status line (overwrite previous)
-        if (state.best_ask_yes > 0 && state.best_ask_no > 0)
+    // Live trading: order and fill events are pushed over the user channel instead of polled
+    if (!dry_run)
+    {
+        std::vector<std::string> condition_ids;
+        for (const auto &session : lifecycle.sessions())
         {
-            std::cout << "\r[" << current_market->slug << "] "
-                      << "YES=" << std::fixed << std::setprecision(4) << state.best_ask_yes
-                      << " NO=" << state.best_ask_no
-                      << " SUM=" << combined
-                      << " (trigger <" << config.trigger_combined << ")"
-                      << " TTL=" << time_left << "s   " << std::flush;
+            if (session.phase == MarketPhase::SUBSCRIBED || session.phase == MarketPhase::TRADING)
+                condition_ids.push_back(session.market.condition_id);
         }
+        user_channel = std::make_unique<UserChannelClient>(config, api_creds);
+        user_channel->subscribe(condition_ids);
+        user_channel->on_order([&order_store](const UserOrderEvent &order)
+                               {
+            order_store.on_user_order(order);
+            std::cout << "\n[UserWS] Order " << order.id.substr(0, 12) << "... matched "
+                      << order.size_matched << "/" << order.original_size << " @ " << order.price << std::endl; });
+        user_channel->on_trade([&order_store](const UserTradeEvent &trade)
+                               {
+            order_store.on_user_trade(trade);
+            std::cout << "\n[UserWS] Fill " << trade.side << " " << trade.size << " @ " << trade.price
+                      << " (" << (trade.status == TradeStatus::CONFIRMED ? "confirmed" : "matched") << ")" << std::endl; });
+        user_channel->connect();
+        order_store.start_reconciler(trading_client.get());
+    }
 
-        // Check for market expiry - switch 60s before
-        if (time_left < 60)
-        {
-            std::cout << "\n\n⏰ Market expiring soon, switching..." << std::endl;
-
-            // Stop current subscription
-            orderbook_mgr.unsubscribe_all();
+    const uint64_t rediscover_ms = static_cast<uint64_t>(std::max(1, config.market_rediscover_sec)) * 1000;
+    uint64_t last_discovery_ms = start_ms;
+    uint64_t expired_seen = 0;
+    uint64_t rollovers_seen = 0;
 
-            // Re-fetch markets to get fresh data
-            auto fresh_markets = fetcher.fetch_crypto_15m_markets();
-            if (!fresh_markets.empty())
-            {
-                markets = fresh_markets;
-            }
+    // Main loop - fire due lifecycle timers and pick up new windows
+    while (g_running.load())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
-            // Find next market
-            current_market = get_best_market(markets, target_symbol);
-            if (!current_market)
-            {
-                std::cout << "[Warn] No more " << target_symbol << " markets, waiting 30s..." << std::endl;
-                std::this_thread::sleep_for(std::chrono::seconds(30));
+        BasketOpportunity basket;
+        while (neg_risk_scanner.poll(basket))
+        {
+            std::cout << "\n[NegRisk] " << (basket.side == BasketSide::BUY_YES ? "BUY" : "SELL")
+                      << " YES x" << basket.legs.size() << " on event " << basket.event_id.substr(0, 12)
+                      << "... sum=" << std::fixed << std::setprecision(4) << basket.price_sum
+                      << " edge=" << basket.edge_per_share
+                      << " shares=" << std::setprecision(2) << basket.shares << std::endl;
+        }
 
-                // Try again
-                fresh_markets = fetcher.fetch_crypto_15m_markets();
-                if (!fresh_markets.empty())
-                {
-                    markets = fresh_markets;
-                    current_market = get_best_market(markets, target_symbol);
-                }
+        uint64_t clock_ms = now_ms();
 
-                if (!current_market)
+        // Windows found by scheduled (or catch-all) discovery
+        for (size_t i = 0; i < timeframes.size(); i++)
+        {
+            auto &rediscovery = rediscoveries[i];
+            if (rediscovery.valid() &&
+                rediscovery.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            {
+                size_t added = lifecycle.add(rediscovery.get(), timeframes[i], clock_ms);
+                if (added > 0)
                 {
-                    std::cerr << "[Error] Still no markets available, exiting." << std::endl;
-                    break;
+                    std::cout << "\n[Lifecycle] " << added << " new " << timeframes[i] << " window(s)" << std::endl;
                 }
             }
+        }
+        // Catch-all for series whose scheduled discovery came up empty until they closed
+        if (clock_ms - last_discovery_ms >= rediscover_ms)
+        {
+            last_discovery_ms = clock_ms;
+            for (const auto &timeframe : timeframes)
+            {
+                start_discovery(timeframe);
+            }
+        }
 
-            market_expiry = get_market_expiry(current_market->slug);
-            time_left_sec = (market_expiry - now_sec() * 1000) / 1000;
-            std::cout << "[Market] Switched to: " << current_market->slug
-                      << " (expires in " << time_left_sec << "s)" << std::endl;
+        lifecycle.advance(clock_ms);
 
-            // Prefetch tick size for new market
-            if (!dry_run)
+        auto counts = lifecycle.counts();
+        if (counts.expired_total != expired_seen)
+        {
+            std::cout << "\n[Lifecycle] " << counts.expired_total - expired_seen << " window(s) expired, "
+                      << counts.rollovers_total - rollovers_seen << " rolled over to a warm successor" << std::endl;
+            expired_seen = counts.expired_total;
+            rollovers_seen = counts.rollovers_total;
+        }
+
+        // Status line (overwrite previous): phase counts and the tightest trading market
+        std::string best_slug;
+        double best_combined = 0.0;
+        int64_t best_ttl = -1;
+        for (const auto &session : lifecycle.sessions())
+        {
+            if (session.phase != MarketPhase::TRADING)
+                continue;
+            MarketState state = orderbook_mgr.get_market(session.market.condition_id);
+            double combined = state.best_ask_yes + state.best_ask_no;
+            if (best_slug.empty() || combined < best_combined)
             {
-                auto book = fetcher.fetch_orderbook(current_market->token_yes);
-                if (book)
-                {
-                    g_market_config.tick_size = "0.01";
-                    g_market_config.neg_risk = true;
-                    g_config_ready.store(true);
-                    std::cout << "[Prefetch] tickSize=" << g_market_config.tick_size << std::endl;
-                }
+                best_slug = session.market.slug;
+                best_combined = combined;
+                best_ttl = session.expiry_ms ? static_cast<int64_t>(session.expiry_ms - clock_ms) / 1000 : -1;
             }
-
-            // Subscribe to new market
-            current_markets = {*current_market};
-            orderbook_mgr.subscribe(current_markets);
         }
+        std::cout << "\r[Markets] trading=" << counts.trading << " standby=" << counts.warm
+                  << " warming=" << counts.subscribed << " pending=" << counts.pending;
+        if (!best_slug.empty())
+        {
+            std::cout << " | best " << best_slug << " SUM=" << std::fixed << std::setprecision(4) << best_combined
+                      << " (trigger <" << config.trigger_combined << ")";
+            if (best_ttl >= 0)
+                std::cout << " TTL=" << best_ttl << "s";
+        }
+        std::cout << "   " << std::flush;
     }
 
     // Shutdown
     std::cout << "\n[Main] Stopping orderbook manager..." << std::endl;
     orderbook_mgr.stop();
+    executor.stop();
+    if (user_channel)
+    {
+        user_channel->stop();
+    }
+    order_store.stop_reconciler();
 
     if (ws_thread.joinable())
     {
         ws_thread.join();
     }
+    if (!record_dir.empty())
+    {
+        journal.close();
+    }
+    for (auto &rediscovery : rediscoveries)
+    {
+        if (rediscovery.valid())
+        {
+            rediscovery.wait(); // Still using the HTTP stack torn down below
+        }
+    }
+
+    if (!catalog_path.empty())
+    {
+        catalog.stop_auto_save();
+        catalog.save(catalog_path);
+    }
 
     std::cout << "[Main] Final stats - Updates: " << orderbook_mgr.total_updates()
-              << " | Arb opportunities: " << orderbook_mgr.arb_opportunities() << std::endl;
+              << " | Arb opportunities: " << orderbook_mgr.arb_opportunities()
+              << " | Gaps: " << orderbook_mgr.gaps_detected()
+              << " | Resynced: " << orderbook_mgr.books_resynced() << std::endl;
+
+    if (strategy_threads > 0)
+    {
+        auto ingress = orderbook_mgr.ingress_stats();
+        std::cout << "[Main] Strategy ring - Enqueued: " << ingress.enqueued
+                  << " | Dropped: " << ingress.dropped
+                  << " | Producer waits: " << ingress.producer_waits
+                  << " | High water: " << ingress.high_water << "/" << ingress.capacity << std::endl;
+        std::cout << "[Main] Dispatch - Delivered: " << ingress.delivered
+                  << " | Conflated: " << ingress.conflated
+                  << " | Withheld (stale): " << ingress.withheld
+                  << " | Latency avg/max: " << std::setprecision(1) << ingress.avg_dispatch_latency_us
+                  << "/" << ingress.max_dispatch_latency_us << "us" << std::endl;
+    }
+
+    if (!record_dir.empty())
+    {
+        auto recorded = journal.stats();
+        std::cout << "[Main] Journal - Records: " << recorded.records
+                  << " | Bytes: " << recorded.bytes
+                  << " | Dropped: " << recorded.dropped
+                  << " | Segments: " << recorded.segments << std::endl;
+    }
+
+    auto lifecycle_counts = lifecycle.counts();
+    std::cout << "[Main] Markets - Trading: " << lifecycle_counts.trading
+              << " | Standby: " << lifecycle_counts.warm
+              << " | Warming: " << lifecycle_counts.subscribed
+              << " | Pending: " << lifecycle_counts.pending
+              << " | Expired: " << lifecycle_counts.expired_total
+              << " | Rollovers: " << lifecycle_counts.rollovers_total << std::endl;
+
+    auto execution = executor.stats();
+    std::cout << "[Main] Executor - Signals: " << execution.posted
+              << " | Executed: " << execution.executed
+              << " | Expired: " << execution.expired
+              << " | Dropped: " << execution.dropped
+              << " | Queue latency avg/max: " << std::setprecision(1) << execution.avg_queue_latency_us
+              << "/" << execution.max_queue_latency_us << "us" << std::endl;
+
+    if (neg_risk_scanner.event_count() > 0)
+    {
+        std::cout << "[Main] Neg-risk - Events: " << neg_risk_scanner.event_count()
+                  << " | Updates: " << neg_risk_scanner.updates()
+                  << " | Baskets: " << neg_risk_scanner.opportunities()
+                  << " | Dropped: " << neg_risk_scanner.dropped() << std::endl;
+    }
+
+    if (!dry_run)
+    {
+        std::cout << "[Main] Orders - Tracked: " << order_store.size()
+                  << " | Still open: " << order_store.open_count() << std::endl;
+    }
+
+    if (feed_mode == FeedMode::ARBITRATED)
+    {
+        for (FeedSource source : {FeedSource::RTDS, FeedSource::CLOB})
+        {
+            auto stats = orderbook_mgr.feed_stats(source);
+            std::cout << "[Main] Feed " << (source == FeedSource::RTDS ? "RTDS" : "CLOB")
+                      << " - Wins: " << stats.wins << " (" << std::setprecision(1) << stats.win_rate() * 100 << "%)"
+                      << " | Duplicates: " << stats.duplicates << " | Stale: " << stats.stale
+                      << " | Avg lag: " << std::setprecision(2) << stats.avg_lag_ms << "ms" << std::endl;
+        }
+    }
 
     http_global_cleanup();
 
@@ -0,0 +1,394 @@
+#include "market_catalog.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace polymarket
+{
+
+    static const char CATALOG_MAGIC[8] = {'P', 'M', 'C', 'A', 'T', 'L', 'G', '\0'};
+    static constexpr uint32_t CATALOG_VERSION = 1;
+
+    MarketCatalog::~MarketCatalog()
+    {
+        stop_auto_save();
+        unmap();
+    }
+
+    void MarketCatalog::unmap()
+    {
+        if (map_)
+        {
+            munmap(const_cast<char *>(map_), map_size_);
+        }
+        map_ = nullptr;
+        map_size_ = 0;
+        header_ = nullptr;
+        records_ = nullptr;
+        condition_index_ = nullptr;
+        slug_index_ = nullptr;
+    }
+
+    bool MarketCatalog::load(const std::string &path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CatalogHeader))
+        {
+            close(fd);
+            return false;
+        }
+
+        size_t size = static_cast<size_t>(st.st_size);
+        void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED)
+        {
+            return false;
+        }
+
+        const char *base = static_cast<const char *>(addr);
+        const auto *header = reinterpret_cast<const CatalogHeader *>(base);
+
+        // Validate layout before trusting any offset; offsets come from the file, so a range is
+        // checked against what is left after its offset rather than by adding (which can wrap)
+        uint64_t count = header->record_count;
+        auto fits = [size](uint64_t offset, uint64_t bytes)
+        { return offset <= size && bytes <= size - offset; };
+        bool valid = std::memcmp(header->magic, CATALOG_MAGIC, sizeof(CATALOG_MAGIC)) == 0 &&
+                     header->version == CATALOG_VERSION &&
+                     fits(header->strings_offset, header->strings_size) &&
+                     fits(header->records_offset, count * sizeof(CatalogRecord)) &&
+                     fits(header->condition_index_offset, count * sizeof(uint32_t)) &&
+                     fits(header->slug_index_offset, count * sizeof(uint32_t)) &&
+                     header->records_offset % alignof(CatalogRecord) == 0 &&
+                     header->condition_index_offset % alignof(uint32_t) == 0 &&
+                     header->slug_index_offset % alignof(uint32_t) == 0;
+
+        const auto *records = reinterpret_cast<const CatalogRecord *>(base + header->records_offset);
+        const auto *condition_index = reinterpret_cast<const uint32_t *>(base + header->condition_index_offset);
+        const auto *slug_index = reinterpret_cast<const uint32_t *>(base + header->slug_index_offset);
+
+        for (uint64_t i = 0; valid && i < count; i++)
+        {
+            const auto &r = records[i];
+            for (const auto *ref : {&r.condition_id, &r.slug, &r.title, &r.symbol, &r.token_yes, &r.token_no})
+            {
+                if (static_cast<uint64_t>(ref->offset) + ref->length > header->strings_size)
+                {
+                    valid = false;
+                }
+            }
+            if (condition_index[i] >= count || slug_index[i] >= count)
+            {
+                valid = false;
+            }
+        }
+
+        if (!valid)
+        {
+            munmap(addr, size);
+            std::cerr << "[MarketCatalog] Ignoring corrupt catalog: " << path << std::endl;
+            return false;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        unmap();
+        map_ = base;
+        map_size_ = size;
+        header_ = header;
+        records_ = records;
+        condition_index_ = condition_index;
+        slug_index_ = slug_index;
+        return true;
+    }
+
+    std::string_view MarketCatalog::view(const CatalogStringRef &ref) const
+    {
+        return std::string_view(map_ + header_->strings_offset + ref.offset, ref.length);
+    }
+
+    MarketState MarketCatalog::to_market_state(const CatalogRecord &record) const
+    {
+        MarketState state;
+        state.condition_id = std::string(view(record.condition_id));
+        state.slug = std::string(view(record.slug));
+        state.title = std::string(view(record.title));
+        state.symbol = std::string(view(record.symbol));
+        state.token_yes = std::string(view(record.token_yes));
+        state.token_no = std::string(view(record.token_no));
+        state.neg_risk = (record.flags & CATALOG_FLAG_NEG_RISK) != 0;
+        return state;
+    }
+
+    const CatalogRecord *MarketCatalog::find_mapped(const uint32_t *index, CatalogStringRef CatalogRecord::*key,
+                                                    std::string_view value) const
+    {
+        if (!map_)
+        {
+            return nullptr;
+        }
+
+        const uint32_t *end = index + header_->record_count;
+        const uint32_t *it = std::lower_bound(index, end, value, [&](uint32_t rec, std::string_view v)
+                                              { return view(records_[rec].*key) < v; });
+        if (it != end && view(records_[*it].*key) == value)
+        {
+            return &records_[*it];
+        }
+        return nullptr;
+    }
+
+    std::optional<MarketState> MarketCatalog::find_by_condition(const std::string &condition_id) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = overlay_.find(condition_id);
+        if (it != overlay_.end())
+        {
+            return it->second;
+        }
+
+        if (const auto *record = find_mapped(condition_index_, &CatalogRecord::condition_id, condition_id))
+        {
+            return to_market_state(*record);
+        }
+        return std::nullopt;
+    }
+
+    std::optional<MarketState> MarketCatalog::find_by_slug(const std::string &slug) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = overlay_slugs_.find(slug);
+        if (it != overlay_slugs_.end())
+        {
+            return overlay_.at(it->second);
+        }
+
+        if (const auto *record = find_mapped(slug_index_, &CatalogRecord::slug, slug))
+        {
+            return to_market_state(*record);
+        }
+        return std::nullopt;
+    }
+
+    void MarketCatalog::upsert(const MarketState &market)
+    {
+        if (market.condition_id.empty())
+        {
+            return;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (overlay_.count(market.condition_id) ||
+            find_mapped(condition_index_, &CatalogRecord::condition_id, market.condition_id))
+        {
+            return;
+        }
+
+        // Only static identity is persisted; live prices are not catalog data
+        MarketState identity;
+        identity.condition_id = market.condition_id;
+        identity.slug = market.slug;
+        identity.title = market.title;
+        identity.symbol = market.symbol;
+        identity.token_yes = market.token_yes;
+        identity.token_no = market.token_no;
+        identity.neg_risk = market.neg_risk;
+
+        overlay_slugs_[identity.slug] = identity.condition_id;
+        overlay_.emplace(identity.condition_id, std::move(identity));
+        dirty_.store(true);
+    }
+
+    std::vector<MarketState> MarketCatalog::all() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::vector<MarketState> result;
+        result.reserve(overlay_.size() + (header_ ? header_->record_count : 0));
+
+        for (uint32_t i = 0; header_ && i < header_->record_count; i++)
+        {
+            result.push_back(to_market_state(records_[i]));
+        }
+        for (const auto &[id, market] : overlay_)
+        {
+            result.push_back(market);
+        }
+        return result;
+    }
+
+    size_t MarketCatalog::size() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return overlay_.size() + (header_ ? header_->record_count : 0);
+    }
+
+    bool MarketCatalog::save(const std::string &path)
+    {
+        // One writer at a time: the auto-save thread and callers share the .tmp path
+        std::lock_guard<std::mutex> write_lock(write_mutex_);
+        auto markets = all();
+
+        // Intern strings into one pool
+        std::string pool;
+        std::unordered_map<std::string, CatalogStringRef> interned;
+        auto intern = [&](const std::string &s)
+        {
+            auto it = interned.find(s);
+            if (it != interned.end())
+            {
+                return it->second;
+            }
+            CatalogStringRef ref{static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(s.size())};
+            pool += s;
+            interned.emplace(s, ref);
+            return ref;
+        };
+
+        std::vector<CatalogRecord> records;
+        records.reserve(markets.size());
+        for (const auto &m : markets)
+        {
+            CatalogRecord r{};
+            r.condition_id = intern(m.condition_id);
+            r.slug = intern(m.slug);
+            r.title = intern(m.title);
+            r.symbol = intern(m.symbol);
+            r.token_yes = intern(m.token_yes);
+            r.token_no = intern(m.token_no);
+            r.flags = m.neg_risk ? CATALOG_FLAG_NEG_RISK : 0;
+            records.push_back(r);
+        }
+
+        auto sorted_index = [&](std::string MarketState::*key)
+        {
+            std::vector<uint32_t> index(markets.size());
+            for (uint32_t i = 0; i < index.size(); i++)
+            {
+                index[i] = i;
+            }
+            std::sort(index.begin(), index.end(), [&](uint32_t a, uint32_t b)
+                      { return markets[a].*key < markets[b].*key; });
+            return index;
+        };
+        auto condition_index = sorted_index(&MarketState::condition_id);
+        auto slug_index = sorted_index(&MarketState::slug);
+
+        auto align8 = [](uint64_t v)
+        { return (v + 7) & ~uint64_t(7); };
+
+        CatalogHeader header{};
+        std::memcpy(header.magic, CATALOG_MAGIC, sizeof(CATALOG_MAGIC));
+        header.version = CATALOG_VERSION;
+        header.record_count = static_cast<uint32_t>(records.size());
+        header.strings_offset = sizeof(CatalogHeader);
+        header.strings_size = pool.size();
+        header.records_offset = align8(header.strings_offset + header.strings_size);
+        header.condition_index_offset = header.records_offset + records.size() * sizeof(CatalogRecord);
+        header.slug_index_offset = header.condition_index_offset + condition_index.size() * sizeof(uint32_t);
+
+        std::string tmp_path = path + ".tmp";
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                return false;
+            }
+
+            static const char padding[8] = {};
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            out.write(pool.data(), static_cast<std::streamsize>(pool.size()));
+            out.write(padding, static_cast<std::streamsize>(header.records_offset - header.strings_offset - pool.size()));
+            out.write(reinterpret_cast<const char *>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(CatalogRecord)));
+            out.write(reinterpret_cast<const char *>(condition_index.data()), static_cast<std::streamsize>(condition_index.size() * sizeof(uint32_t)));
+            out.write(reinterpret_cast<const char *>(slug_index.data()), static_cast<std::streamsize>(slug_index.size() * sizeof(uint32_t)));
+            if (!out)
+            {
+                return false;
+            }
+        }
+
+        if (std::rename(tmp_path.c_str(), path.c_str()) != 0)
+        {
+            return false;
+        }
+
+        // Remap the merged file; everything in the overlay is now persisted
+        if (!load(path))
+        {
+            return false;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        for (auto it = overlay_.begin(); it != overlay_.end();)
+        {
+            if (find_mapped(condition_index_, &CatalogRecord::condition_id, it->first))
+            {
+                overlay_slugs_.erase(it->second.slug);
+                it = overlay_.erase(it);
+            }
+            else
+            {
+                ++it; // Discovered while we were writing; keep for the next save
+            }
+        }
+        dirty_.store(!overlay_.empty());
+        return true;
+    }
+
+    void MarketCatalog::start_auto_save(const std::string &path, long interval_seconds)
+    {
+        {
+            std::lock_guard<std::mutex> lock(save_mutex_);
+            if (save_running_)
+            {
+                return; // Already running
+            }
+            save_running_ = true;
+        }
+
+        save_thread_ = std::thread([this, path, interval_seconds]()
+                                   {
+            std::unique_lock<std::mutex> lock(save_mutex_);
+            while (save_running_)
+            {
+                save_cv_.wait_for(lock, std::chrono::seconds(interval_seconds),
+                                  [this]() { return !save_running_; });
+
+                if (dirty_.load())
+                {
+                    lock.unlock();
+                    if (!save(path))
+                    {
+                        std::cerr << "[MarketCatalog] Failed to save " << path << std::endl;
+                    }
+                    lock.lock();
+                }
+            } });
+    }
+
+    void MarketCatalog::stop_auto_save()
+    {
+        {
+            std::lock_guard<std::mutex> lock(save_mutex_);
+            save_running_ = false;
+        }
+        save_cv_.notify_all();
+        if (save_thread_.joinable())
+        {
+            save_thread_.join();
+        }
+    }
+
+} // namespace polymarket
@@ -4,6 +4,12 @@
 #include <sstream>
 #include <iomanip>
 #include <ctime>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <unordered_map>
+#include <unordered_set>
 
 using json = nlohmann::json;
 
@@ -17,81 +23,205 @@ namespace polymarket
         http_.set_timeout_ms(config_.http_timeout_ms);
     }
 
-    std::vector<ClobMarket> MarketFetcher::fetch_all_markets(int max_markets)
+    namespace
+    {
+        // Cursor the CLOB API returns once the last page has been served
+        const std::string END_CURSOR = "LTE=";
+
+        ClobMarket parse_market_item(const json &item)
+        {
+            ClobMarket market;
+
+            if (item.contains("condition_id"))
+            {
+                market.condition_id = item["condition_id"].get<std::string>();
+            }
+            if (item.contains("question") && !item["question"].is_null())
+            {
+                market.question = item["question"].get<std::string>();
+            }
+            if (item.contains("market_slug") && !item["market_slug"].is_null())
+            {
+                market.market_slug = item["market_slug"].get<std::string>();
+            }
+            if (item.contains("neg_risk"))
+            {
+                market.neg_risk = item["neg_risk"].get<bool>();
+            }
+            if (item.contains("neg_risk_market_id") && item["neg_risk_market_id"].is_string())
+            {
+                market.neg_risk_market_id = item["neg_risk_market_id"].get<std::string>();
+            }
+            if (item.contains("active"))
+            {
+                market.active = item["active"].get<bool>();
+            }
+            if (item.contains("closed"))
+            {
+                market.closed = item["closed"].get<bool>();
+            }
+
+            if (item.contains("tokens") && item["tokens"].is_array())
+            {
+                for (const auto &t : item["tokens"])
+                {
+                    Token token;
+                    if (t.contains("token_id"))
+                    {
+                        token.token_id = t["token_id"].get<std::string>();
+                    }
+                    if (t.contains("outcome"))
+                    {
+                        token.outcome = t["outcome"].get<std::string>();
+                    }
+                    market.tokens.push_back(token);
+                }
+            }
+
+            return market;
+        }
+    } // namespace
+
+    std::vector<ClobMarket> MarketFetcher::stream_markets(size_t max_markets, const MarketFilter &filter, bool *complete)
     {
         std::vector<ClobMarket> markets;
-        std::string next_cursor;
+        bool failed = false;
 
-        while (markets.size() < static_cast<size_t>(max_markets))
+        auto request_page = [this](const std::string &cursor)
         {
             std::string path = "/markets";
-            if (!next_cursor.empty())
+            if (!cursor.empty())
             {
-                path += "?next_cursor=" + next_cursor;
+                path += "?next_cursor=" + cursor;
             }
+            return std::async(std::launch::async, [this, path]()
+                              { return http_.get(path); });
+        };
 
-            auto response = http_.get(path);
+        auto pending = request_page("");
+        while (pending.valid() && markets.size() < max_markets)
+        {
+            auto response = pending.get();
             if (!response.ok())
             {
                 std::cerr << "Failed to fetch markets: " << response.status_code
                           << " - " << response.error << std::endl;
+                failed = true;
                 break;
             }
 
             try
             {
-                auto parsed = parse_markets_response(response.body);
-                if (parsed.empty())
-                    break;
+                auto j = json::parse(response.body);
 
-                for (auto &m : parsed)
+                // Pipeline: next page is on the wire while this one is decoded
+                if (j.contains("next_cursor") && j["next_cursor"].is_string())
                 {
-                    if (markets.size() >= static_cast<size_t>(max_markets))
-                        break;
-                    markets.push_back(std::move(m));
+                    auto cursor = j["next_cursor"].get<std::string>();
+                    if (!cursor.empty() && cursor != END_CURSOR)
+                    {
+                        pending = request_page(cursor);
+                    }
                 }
 
-                // Get next cursor from response
-                auto j = json::parse(response.body);
-                if (j.contains("next_cursor") && !j["next_cursor"].is_null())
+                const json *page = &j;
+                if (!j.is_array())
                 {
-                    next_cursor = j["next_cursor"].get<std::string>();
+                    if (!j.contains("data") || !j["data"].is_array())
+                        break;
+                    page = &j["data"];
                 }
-                else
+
+                for (const auto &item : *page)
                 {
-                    break;
+                    auto market = parse_market_item(item);
+                    if (filter && !filter(market))
+                        continue;
+
+                    markets.push_back(std::move(market));
+                    if (markets.size() >= max_markets)
+                        break;
                 }
             }
             catch (const std::exception &e)
             {
                 std::cerr << "JSON parse error: " << e.what() << std::endl;
+                failed = true;
                 break;
             }
         }
 
+        if (complete)
+        {
+            *complete = !failed && !pending.valid();
+        }
+
+        // An in-flight prefetch past the target is simply awaited and discarded
         return markets;
     }
 
-    std::vector<ClobMarket> MarketFetcher::fetch_neg_risk_markets(int max_markets)
+    std::vector<ClobMarket> MarketFetcher::fetch_all_markets(int max_markets)
     {
-        auto all_markets = fetch_all_markets(max_markets * 5); // Fetch more to filter
+        return stream_markets(static_cast<size_t>(std::max(0, max_markets)));
+    }
 
-        std::vector<ClobMarket> valid_markets;
-        for (auto &m : all_markets)
+    std::vector<ClobMarket> MarketFetcher::fetch_neg_risk_markets(int max_markets)
+    {
+        // Filter for markets with valid tokens (Yes/No outcomes with token IDs) while paging,
+        // instead of over-fetching and filtering afterwards
+        auto is_valid = [](const ClobMarket &m)
         {
-            // Filter for markets with valid tokens (Yes/No outcomes with token IDs)
-            bool has_valid_tokens = m.tokens.size() == 2 &&
-                                    !m.token_yes().empty() &&
-                                    !m.token_no().empty();
+            return m.tokens.size() == 2 &&
+                   !m.token_yes().empty() &&
+                   !m.token_no().empty() &&
+                   !m.condition_id.empty();
+        };
+        auto valid_markets = stream_markets(static_cast<size_t>(std::max(0, max_markets)), is_valid);
+
+        // max_markets cuts through events; a basket missing an outcome does not pay out 1, so
+        // page the rest of the catalog for the other conditions of every event we returned
+        std::unordered_map<std::string, size_t> outcomes; // neg_risk_market_id -> conditions
+        std::unordered_set<std::string> seen;
+        for (const auto &m : valid_markets)
+        {
+            seen.insert(m.condition_id);
+            if (!m.neg_risk_market_id.empty())
+            {
+                outcomes[m.neg_risk_market_id]++;
+            }
+        }
 
-            if (has_valid_tokens && !m.condition_id.empty())
+        if (!outcomes.empty())
+        {
+            bool complete = false;
+            auto rest = stream_markets(SIZE_MAX, [&](const ClobMarket &m)
+                                       { return is_valid(m) && outcomes.count(m.neg_risk_market_id) &&
+                                                !seen.count(m.condition_id); },
+                                       &complete);
+            for (auto &m : rest)
             {
+                outcomes[m.neg_risk_market_id]++;
                 valid_markets.push_back(std::move(m));
-                if (valid_markets.size() >= static_cast<size_t>(max_markets))
+            }
+
+            // Only a full pass proves an event complete; otherwise counts stay unknown
+            if (complete)
+            {
+                for (auto &m : valid_markets)
                 {
-                    break;
+                    if (!m.neg_risk_market_id.empty())
+                    {
+                        m.neg_risk_outcomes = outcomes[m.neg_risk_market_id];
+                    }
                 }
             }
+            else
+            {
+                std::cerr << "[MarketFetcher] Catalog scan incomplete; neg-risk events stay partial" << std::endl;
+            }
+
+            std::cout << "[MarketFetcher] Completed " << outcomes.size() << " neg-risk events with "
+                      << rest.size() << " more conditions" << std::endl;
         }
 
         std::cout << "[MarketFetcher] Found " << valid_markets.size()
@@ -152,51 +282,7 @@ namespace polymarket
 
             for (const auto &item : market_array)
             {
-                ClobMarket market;
-
-                if (item.contains("condition_id"))
-                {
-                    market.condition_id = item["condition_id"].get<std::string>();
-                }
-                if (item.contains("question") && !item["question"].is_null())
-                {
-                    market.question = item["question"].get<std::string>();
-                }
-                if (item.contains("market_slug") && !item["market_slug"].is_null())
-                {
-                    market.market_slug = item["market_slug"].get<std::string>();
-                }
-                if (item.contains("neg_risk"))
-                {
-                    market.neg_risk = item["neg_risk"].get<bool>();
-                }
-                if (item.contains("active"))
-                {
-                    market.active = item["active"].get<bool>();
-                }
-                if (item.contains("closed"))
-                {
-                    market.closed = item["closed"].get<bool>();
-                }
-
-                if (item.contains("tokens") && item["tokens"].is_array())
-                {
-                    for (const auto &t : item["tokens"])
-                    {
-                        Token token;
-                        if (t.contains("token_id"))
-                        {
-                            token.token_id = t["token_id"].get<std::string>();
-                        }
-                        if (t.contains("outcome"))
-                        {
-                            token.outcome = t["outcome"].get<std::string>();
-                        }
-                        market.tokens.push_back(token);
-                    }
-                }
-
-                markets.push_back(std::move(market));
+                markets.push_back(parse_market_item(item));
             }
         }
         catch (const std::exception &e)
@@ -333,38 +419,92 @@ namespace polymarket
         return slugs;
     }
 
-    std::vector<MarketState> MarketFetcher::fetch_crypto_15m_markets()
+    std::vector<MarketState> MarketFetcher::fetch_gamma_slugs(const std::vector<SlugRequest> &requests)
     {
-        std::vector<MarketState> markets;
-        auto timestamps = get_15m_timestamps(3);
+        std::vector<std::optional<MarketState>> results(requests.size());
+
+        // Warm start: slugs already in the catalog never touch the network
+        std::vector<size_t> pending;
+        for (size_t i = 0; i < requests.size(); i++)
+        {
+            if (catalog_)
+            {
+                results[i] = catalog_->find_by_slug(requests[i].slug);
+            }
+            if (!results[i])
+            {
+                pending.push_back(i);
+            }
+        }
 
-        HttpClient gamma_http;
-        gamma_http.set_base_url(config_.gamma_api_url);
-        gamma_http.set_timeout_ms(config_.http_timeout_ms);
+        std::atomic<size_t> next{0};
 
-        std::cout << "Fetching crypto up/down 15m markets from Gamma API...\n"
-                  << std::endl;
+        size_t max_in_flight = static_cast<size_t>(std::max(1, config_.gamma_max_in_flight));
+        size_t worker_count = std::min(max_in_flight, pending.size());
 
-        for (const auto &ticker : config_.crypto_tickers)
+        // Each worker owns its easy handle; the shared CURLSH pool keeps them all on warm connections
+        auto worker = [&]()
         {
-            for (const auto &ts : timestamps)
-            {
-                std::string slug = ticker + "-updown-15m-" + std::to_string(ts);
-                std::string path = "/events?slug=" + slug;
+            HttpClient gamma_http;
+            gamma_http.set_base_url(config_.gamma_api_url);
+            gamma_http.set_timeout_ms(config_.gamma_slug_timeout_ms);
 
-                auto response = gamma_http.get(path);
+            for (size_t n = next.fetch_add(1); n < pending.size(); n = next.fetch_add(1))
+            {
+                size_t i = pending[n];
+                auto response = gamma_http.get("/events?slug=" + requests[i].slug);
                 if (!response.ok())
                     continue;
 
-                auto market = parse_gamma_event(response.body, ticker);
-                if (market)
+                results[i] = parse_gamma_event(response.body, requests[i].ticker);
+                if (results[i] && catalog_)
                 {
-                    std::cout << "  Found: " << ticker << " - " << market->slug << std::endl;
-                    markets.push_back(std::move(*market));
+                    catalog_->upsert(*results[i]);
                 }
             }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(worker_count);
+        for (size_t i = 0; i < worker_count; i++)
+        {
+            workers.emplace_back(worker);
+        }
+        for (auto &t : workers)
+        {
+            t.join();
+        }
+
+        std::vector<MarketState> markets;
+        for (auto &result : results)
+        {
+            if (result)
+            {
+                std::cout << "  Found: " << result->symbol << " - " << result->slug << std::endl;
+                markets.push_back(std::move(*result));
+            }
+        }
+        return markets;
+    }
+
+    std::vector<MarketState> MarketFetcher::fetch_crypto_15m_markets()
+    {
+        auto timestamps = get_15m_timestamps(3);
+
+        std::cout << "Fetching crypto up/down 15m markets from Gamma API...\n"
+                  << std::endl;
+
+        std::vector<SlugRequest> requests;
+        for (const auto &ticker : config_.crypto_tickers)
+        {
+            for (const auto &ts : timestamps)
+            {
+                requests.push_back({ticker + "-updown-15m-" + std::to_string(ts), ticker});
+            }
         }
 
+        auto markets = fetch_gamma_slugs(requests);
+
         std::cout << "\nFound " << markets.size() << " crypto 15m markets\n"
                   << std::endl;
         return markets;
@@ -372,36 +512,22 @@ namespace polymarket
 
     std::vector<MarketState> MarketFetcher::fetch_crypto_4h_markets()
     {
-        std::vector<MarketState> markets;
         auto timestamps = get_4h_timestamps(3);
 
-        HttpClient gamma_http;
-        gamma_http.set_base_url(config_.gamma_api_url);
-        gamma_http.set_timeout_ms(config_.http_timeout_ms);
-
         std::cout << "Fetching crypto up/down 4h markets from Gamma API...\n"
                   << std::endl;
 
+        std::vector<SlugRequest> requests;
         for (const auto &ticker : config_.crypto_tickers)
         {
             for (const auto &ts : timestamps)
             {
-                std::string slug = ticker + "-updown-4h-" + std::to_string(ts);
-                std::string path = "/events?slug=" + slug;
-
-                auto response = gamma_http.get(path);
-                if (!response.ok())
-                    continue;
-
-                auto market = parse_gamma_event(response.body, ticker);
-                if (market)
-                {
-                    std::cout << "  Found: " << ticker << " - " << market->slug << std::endl;
-                    markets.push_back(std::move(*market));
-                }
+                requests.push_back({ticker + "-updown-4h-" + std::to_string(ts), ticker});
             }
         }
 
+        auto markets = fetch_gamma_slugs(requests);
+
         std::cout << "\nFound " << markets.size() << " crypto 4h markets\n"
                   << std::endl;
         return markets;
@@ -409,35 +535,20 @@ namespace polymarket
 
     std::vector<MarketState> MarketFetcher::fetch_crypto_1h_markets()
     {
-        std::vector<MarketState> markets;
         auto slugs = generate_1h_slugs(3);
 
-        HttpClient gamma_http;
-        gamma_http.set_base_url(config_.gamma_api_url);
-        gamma_http.set_timeout_ms(config_.http_timeout_ms);
-
         std::cout << "Fetching crypto up/down 1h markets from Gamma API...\n"
                   << std::endl;
 
+        std::vector<SlugRequest> requests;
         for (const auto &slug : slugs)
         {
-            std::string path = "/events?slug=" + slug;
-
-            auto response = gamma_http.get(path);
-            if (!response.ok())
-                continue;
-
             // Extract ticker from slug
-            std::string ticker = slug.substr(0, slug.find('-'));
-
-            auto market = parse_gamma_event(response.body, ticker);
-            if (market)
-            {
-                markets.push_back(std::move(*market));
-                std::cout << "  Found: " << slug << std::endl;
-            }
+            requests.push_back({slug, slug.substr(0, slug.find('-'))});
         }
 
+        auto markets = fetch_gamma_slugs(requests);
+
         std::cout << "\nFound " << markets.size() << " crypto 1h markets\n"
                   << std::endl;
         return markets;
@@ -480,6 +591,7 @@ namespace polymarket
             state.condition_id = m["conditionId"].get<std::string>();
             state.token_yes = token_ids[0].get<std::string>();
             state.token_no = token_ids[1].get<std::string>();
+            state.neg_risk = m.contains("negRisk") && m["negRisk"].is_boolean() && m["negRisk"].get<bool>();
 
             return state;
         }
@@ -497,6 +609,9 @@ namespace polymarket
         state.condition_id = market.condition_id;
         state.token_yes = market.token_yes();
         state.token_no = market.token_no();
+        state.neg_risk = market.neg_risk;
+        state.neg_risk_market_id = market.neg_risk_market_id;
+        state.neg_risk_outcomes = market.neg_risk_outcomes;
 
         // Extract symbol from slug
         auto pos = state.slug.find('-');
@@ -0,0 +1,499 @@
+#include "market_lifecycle.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+
+namespace polymarket
+{
+
+    namespace
+    {
+        // "<symbol>-updown-15m-1767170700": trailing unix seconds of the window start
+        uint64_t trailing_start_sec(const std::string &slug)
+        {
+            size_t dash = slug.rfind('-');
+            if (dash == std::string::npos || slug.size() - dash - 1 != 10)
+                return 0;
+            uint64_t sec = 0;
+            for (size_t i = dash + 1; i < slug.size(); i++)
+            {
+                if (!std::isdigit(static_cast<unsigned char>(slug[i])))
+                    return 0;
+                sec = sec * 10 + static_cast<uint64_t>(slug[i] - '0');
+            }
+            return sec;
+        }
+
+        // "bitcoin-up-or-down-december-31-3pm-et": the hour starting then, in ET (UTC-5, as
+        // MarketFetcher::generate_1h_slugs builds them). The year is the one nearest to now.
+        uint64_t et_hour_start_sec(const std::string &slug)
+        {
+            static const char *months[] = {"january", "february", "march", "april", "may", "june",
+                                           "july", "august", "september", "october", "november", "december"};
+
+            if (slug.size() < 3 || slug.compare(slug.size() - 3, 3, "-et") != 0)
+                return 0;
+            std::vector<std::string> parts;
+            size_t start = 0;
+            for (size_t dash; (dash = slug.find('-', start)) != std::string::npos; start = dash + 1)
+            {
+                parts.push_back(slug.substr(start, dash - start));
+            }
+            if (parts.size() < 3)
+                return 0;
+
+            const std::string &month_str = parts[parts.size() - 3];
+            const std::string &day_str = parts[parts.size() - 2];
+            const std::string &hour_str = parts[parts.size() - 1];
+            int month = -1;
+            for (int i = 0; i < 12; i++)
+            {
+                if (month_str == months[i])
+                    month = i;
+            }
+            if (month < 0 || day_str.empty() || day_str.size() > 2 || hour_str.size() < 3 ||
+                !std::all_of(day_str.begin(), day_str.end(), ::isdigit))
+                return 0;
+
+            std::string suffix = hour_str.substr(hour_str.size() - 2);
+            std::string digits = hour_str.substr(0, hour_str.size() - 2);
+            if ((suffix != "am" && suffix != "pm") || digits.empty() || digits.size() > 2 ||
+                !std::all_of(digits.begin(), digits.end(), ::isdigit))
+                return 0;
+            int hour = std::stoi(digits) % 12 + (suffix == "pm" ? 12 : 0);
+
+            time_t now = static_cast<time_t>(now_sec());
+            struct tm utc;
+            gmtime_r(&now, &utc);
+
+            uint64_t best = 0;
+            int64_t best_distance = INT64_MAX;
+            for (int year = utc.tm_year - 1; year <= utc.tm_year + 1; year++)
+            {
+                struct tm et{};
+                et.tm_year = year;
+                et.tm_mon = month;
+                et.tm_mday = std::stoi(day_str);
+                et.tm_hour = hour;
+                int64_t start_sec = static_cast<int64_t>(timegm(&et)) + 5 * 3600;
+                int64_t distance = std::llabs(start_sec - static_cast<int64_t>(now));
+                if (distance < best_distance)
+                {
+                    best_distance = distance;
+                    best = static_cast<uint64_t>(start_sec);
+                }
+            }
+            return best;
+        }
+    } // namespace
+
+    const char *market_phase_name(MarketPhase phase)
+    {
+        switch (phase)
+        {
+        case MarketPhase::PENDING:
+            return "pending";
+        case MarketPhase::PREFETCHED:
+            return "prefetched";
+        case MarketPhase::SUBSCRIBED:
+            return "subscribed";
+        case MarketPhase::WARM:
+            return "warm";
+        case MarketPhase::TRADING:
+            return "trading";
+        case MarketPhase::EXPIRED:
+            return "expired";
+        }
+        return "unknown";
+    }
+
+
+    MarketLifecycle::MarketLifecycle(const Config &config)
+        : min_time_left_ms_(static_cast<uint64_t>(std::max(0, config.market_min_time_left_sec)) * 1000),
+          expire_lead_ms_(static_cast<uint64_t>(std::max(0, config.market_expire_lead_sec)) * 1000),
+          discover_lead_ms_(static_cast<uint64_t>(std::max(0, config.market_discover_lead_sec)) * 1000),
+          discover_retry_ms_(static_cast<uint64_t>(std::max(1, config.market_discover_retry_sec)) * 1000),
+          presubscribe_ms_(static_cast<uint64_t>(std::max(0, config.market_presubscribe_sec)) * 1000),
+          prefetch_workers_(static_cast<size_t>(std::max(1, config.market_prefetch_workers))),
+          timers_(100, 8192, 0) // 100ms slots, ~13.6 min per revolution; the first advance catches up
+    {
+    }
+
+    void MarketLifecycle::on_prefetch(PrefetchHook hook)
+    {
+        prefetch_ = std::move(hook);
+    }
+
+    void MarketLifecycle::on_subscribe(SubscribeHook hook)
+    {
+        subscribe_ = std::move(hook);
+    }
+
+    void MarketLifecycle::on_unsubscribe(UnsubscribeHook hook)
+    {
+        unsubscribe_ = std::move(hook);
+    }
+
+    void MarketLifecycle::on_warm_check(WarmCheck hook)
+    {
+        warm_ = std::move(hook);
+    }
+
+    void MarketLifecycle::on_successor_needed(SuccessorHook hook)
+    {
+        successor_ = std::move(hook);
+    }
+
+    size_t MarketLifecycle::add(const std::vector<MarketState> &markets, const std::string &timeframe, uint64_t now_ms)
+    {
+        size_t added = 0;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &market : markets)
+        {
+            if (market.condition_id.empty() || sessions_.count(market.condition_id))
+                continue;
+
+            uint64_t expiry = timeframe.empty() ? 0 : window_expiry_ms(market.slug, timeframe);
+            if (expiry != 0 && expiry <= now_ms + std::max(min_time_left_ms_, expire_lead_ms_))
+                continue;
+
+            Session session;
+            session.market = market;
+            session.timeframe = timeframe;
+            session.series = timeframe.empty() ? market.condition_id : market.symbol + "-" + timeframe;
+            session.expiry_ms = expiry;
+            session.start_ms = expiry != 0 ? expiry - timeframe_ms(timeframe) : 0;
+            session.neg_risk = market.neg_risk;
+            session.discovered_ms = now_ms;
+
+            // Every deadline of the window, once
+            if (expiry != 0)
+            {
+                timers_.schedule(expiry - expire_lead_ms_, {TimerKind::EXPIRE, market.condition_id});
+                session.discover_timer = timers_.schedule(expiry > discover_lead_ms_ ? expiry - discover_lead_ms_ : 0,
+                                                          {TimerKind::DISCOVER, market.condition_id});
+            }
+            if (session.start_ms > presubscribe_ms_ && session.start_ms - presubscribe_ms_ > now_ms)
+            {
+                session.subscribe_timer = timers_.schedule(session.start_ms - presubscribe_ms_,
+                                                           {TimerKind::SUBSCRIBE, market.condition_id});
+            }
+            else
+            {
+                session.subscribe_due = true;
+            }
+
+            sessions_.emplace(market.condition_id, std::move(session));
+            added++;
+        }
+        return added;
+    }
+
+    void MarketLifecycle::advance(uint64_t now_ms)
+    {
+        // Hooks do network I/O: run them on copies with the lock released, so the executor's
+        // lookups never wait on a REST round trip
+        std::vector<MarketSession> pending;
+        std::vector<MarketSession> subscribed;
+        std::vector<MarketState> to_subscribe;
+        std::vector<std::string> to_unsubscribe;
+        std::vector<std::string> discover;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            timers_.advance(now_ms, [&](const Timer &timer)
+                            {
+                auto it = sessions_.find(timer.condition_id);
+                if (it == sessions_.end())
+                    return;
+                Session &session = it->second;
+
+                switch (timer.kind)
+                {
+                case TimerKind::SUBSCRIBE:
+                    session.subscribe_timer = 0;
+                    session.subscribe_due = true;
+                    break;
+
+                case TimerKind::DISCOVER:
+                    session.discover_timer = 0;
+                    if (!has_successor(session))
+                    {
+                        if (std::find(discover.begin(), discover.end(), session.timeframe) == discover.end())
+                            discover.push_back(session.timeframe);
+                        if (now_ms + discover_retry_ms_ + expire_lead_ms_ < session.expiry_ms)
+                            session.discover_timer = timers_.schedule(now_ms + discover_retry_ms_, timer);
+                    }
+                    break;
+
+                case TimerKind::EXPIRE:
+                {
+                    bool was_trading = session.phase == MarketPhase::TRADING;
+                    if (session.phase == MarketPhase::SUBSCRIBED || session.phase == MarketPhase::WARM || was_trading)
+                        to_unsubscribe.push_back(session.market.condition_id);
+                    if (session.subscribe_timer)
+                        timers_.cancel(session.subscribe_timer);
+                    if (session.discover_timer)
+                        timers_.cancel(session.discover_timer);
+                    std::string series = session.series;
+                    sessions_.erase(it);
+                    expired_total_++;
+
+                    // The switch: the warm successor trades from the same instant
+                    Session *next = series_head(series);
+                    if (was_trading && next && next->phase == MarketPhase::WARM)
+                    {
+                        promote(*next, now_ms);
+                        rollovers_total_++;
+                    }
+                    break;
+                }
+                } });
+
+            for (auto &[condition_id, session] : sessions_)
+            {
+                switch (session.phase)
+                {
+                case MarketPhase::PENDING:
+                    pending.push_back(session);
+                    break;
+                case MarketPhase::PREFETCHED:
+                    if (session.subscribe_due)
+                    {
+                        session.phase = MarketPhase::SUBSCRIBED;
+                        to_subscribe.push_back(session.market);
+                    }
+                    break;
+                case MarketPhase::SUBSCRIBED:
+                    subscribed.push_back(session);
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+        if (!to_unsubscribe.empty() && unsubscribe_)
+        {
+            unsubscribe_(to_unsubscribe);
+        }
+        if (!to_subscribe.empty() && subscribe_)
+        {
+            subscribe_(to_subscribe);
+        }
+        if (successor_)
+        {
+            for (const auto &timeframe : discover)
+            {
+                successor_(timeframe);
+            }
+        }
+
+        // Each prefetch is a few REST round trips: run them side by side, a bounded pool of
+        // workers pulling sessions off a shared index
+        std::atomic<size_t> next{0};
+        auto prefetch_worker = [&]()
+        {
+            for (size_t n = next.fetch_add(1); n < pending.size(); n = next.fetch_add(1))
+            {
+                auto &session = pending[n];
+                session.phase = !prefetch_ || prefetch_(session) ? MarketPhase::PREFETCHED : MarketPhase::PENDING;
+            }
+        };
+        size_t worker_count = std::min(prefetch_workers_, pending.size());
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < worker_count; i++)
+        {
+            workers.emplace_back(prefetch_worker);
+        }
+        prefetch_worker(); // The calling thread is one of them
+        for (auto &t : workers)
+        {
+            t.join();
+        }
+
+        std::vector<std::string> warm;
+        for (const auto &session : subscribed)
+        {
+            if (!warm_ || warm_(session))
+            {
+                warm.push_back(session.market.condition_id);
+            }
+        }
+
+        // Sessions may have expired meanwhile; only those still present take the update
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &result : pending)
+        {
+            auto it = sessions_.find(result.market.condition_id);
+            if (it != sessions_.end() && it->second.phase == MarketPhase::PENDING)
+            {
+                Session &session = it->second;
+                session.tick_size = result.tick_size;
+                session.neg_risk = result.neg_risk;
+                session.exchange = result.exchange;
+                session.order_yes = result.order_yes;
+                session.order_no = result.order_no;
+                session.phase = result.phase;
+            }
+        }
+        for (const auto &condition_id : warm)
+        {
+            auto it = sessions_.find(condition_id);
+            if (it != sessions_.end() && it->second.phase == MarketPhase::SUBSCRIBED)
+            {
+                it->second.phase = MarketPhase::WARM;
+            }
+        }
+
+        // A warm window trades once it heads its series (nothing earlier is still open)
+        for (auto &[condition_id, session] : sessions_)
+        {
+            if (session.phase == MarketPhase::WARM && series_head(session.series) == &session)
+            {
+                promote(session, now_ms);
+            }
+        }
+    }
+
+    void MarketLifecycle::start(uint64_t now_ms)
+    {
+        advance(now_ms); // Prefetch
+        advance(now_ms); // Subscribe what is due; windows still failing prefetch retry later
+    }
+
+    MarketLifecycle::Session *MarketLifecycle::series_head(const std::string &series)
+    {
+        Session *head = nullptr;
+        for (auto &[condition_id, session] : sessions_)
+        {
+            if (session.series != series)
+                continue;
+            uint64_t expiry = session.expiry_ms ? session.expiry_ms : UINT64_MAX;
+            uint64_t head_expiry = head && head->expiry_ms ? head->expiry_ms : UINT64_MAX;
+            if (!head || expiry < head_expiry)
+            {
+                head = &session;
+            }
+        }
+        return head;
+    }
+
+    bool MarketLifecycle::has_successor(const Session &session) const
+    {
+        for (const auto &[condition_id, other] : sessions_)
+        {
+            if (other.series == session.series && other.expiry_ms > session.expiry_ms)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void MarketLifecycle::promote(Session &session, uint64_t now_ms)
+    {
+        session.phase = MarketPhase::TRADING;
+        session.trading_since_ms = now_ms;
+    }
+
+    std::optional<MarketSession> MarketLifecycle::session(const std::string &condition_id) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sessions_.find(condition_id);
+        if (it == sessions_.end())
+            return std::nullopt;
+        return static_cast<const MarketSession &>(it->second);
+    }
+
+    bool MarketLifecycle::tradable(const std::string &condition_id) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sessions_.find(condition_id);
+        return it != sessions_.end() && it->second.phase == MarketPhase::TRADING;
+    }
+
+    std::vector<MarketSession> MarketLifecycle::sessions() const
+    {
+        std::vector<MarketSession> result;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            result.reserve(sessions_.size());
+            for (const auto &[condition_id, session] : sessions_)
+            {
+                result.push_back(session);
+            }
+        }
+        std::sort(result.begin(), result.end(), [](const MarketSession &a, const MarketSession &b)
+                  {
+            // Open-ended markets last
+            uint64_t ea = a.expiry_ms ? a.expiry_ms : UINT64_MAX;
+            uint64_t eb = b.expiry_ms ? b.expiry_ms : UINT64_MAX;
+            return ea != eb ? ea < eb : a.market.slug < b.market.slug; });
+        return result;
+    }
+
+    LifecycleCounts MarketLifecycle::counts() const
+    {
+        LifecycleCounts counts;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &[condition_id, session] : sessions_)
+        {
+            switch (session.phase)
+            {
+            case MarketPhase::PENDING:
+            case MarketPhase::PREFETCHED:
+                counts.pending++;
+                break;
+            case MarketPhase::SUBSCRIBED:
+                counts.subscribed++;
+                break;
+            case MarketPhase::WARM:
+                counts.warm++;
+                break;
+            case MarketPhase::TRADING:
+                counts.trading++;
+                break;
+            default:
+                break;
+            }
+        }
+        counts.expired_total = expired_total_;
+        counts.rollovers_total = rollovers_total_;
+        return counts;
+    }
+
+    size_t MarketLifecycle::size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return sessions_.size();
+    }
+
+    size_t MarketLifecycle::pending_timers() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return timers_.size();
+    }
+
+    uint64_t MarketLifecycle::window_expiry_ms(const std::string &slug, const std::string &timeframe)
+    {
+        uint64_t start_sec = trailing_start_sec(slug);
+        if (start_sec == 0)
+        {
+            start_sec = et_hour_start_sec(slug);
+        }
+        return start_sec == 0 ? 0 : start_sec * 1000 + timeframe_ms(timeframe);
+    }
+
+    uint64_t MarketLifecycle::timeframe_ms(const std::string &timeframe)
+    {
+        if (timeframe == "1h")
+            return 60 * 60 * 1000;
+        if (timeframe == "4h")
+            return 4 * 60 * 60 * 1000;
+        return 15 * 60 * 1000;
+    }
+
+} // namespace polymarket
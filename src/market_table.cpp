@@ -0,0 +1,288 @@
+#include "market_table.hpp"
+#include <algorithm>
+#include <iostream>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define POLYMARKET_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace polymarket
+{
+
+    namespace
+    {
+        constexpr double NO_ASK = std::numeric_limits<double>::infinity();
+
+        struct ScanColumns
+        {
+            const double *ask_yes;
+            const double *ask_no;
+            const double *size_yes;
+            const double *size_no;
+            const uint64_t *update_ns_yes;
+            const uint64_t *update_ns_no;
+        };
+
+        // Oldest update time that still counts as fresh (0 accepts everything)
+        uint64_t fresh_cutoff(const MarketScanFilter &filter)
+        {
+            if (filter.max_age_ns == 0 || filter.now_ns <= filter.max_age_ns)
+            {
+                return 0;
+            }
+            return filter.now_ns - filter.max_age_ns;
+        }
+
+        size_t scan_scalar(const ScanColumns &c, size_t rows, const MarketScanFilter &filter, std::vector<uint32_t> &hits)
+        {
+            const uint64_t cutoff = fresh_cutoff(filter);
+            size_t found = 0;
+            for (size_t i = 0; i < rows; i++)
+            {
+                // Non-short-circuit so the loop body stays branch-free until the hit
+                bool hit = (c.ask_yes[i] + c.ask_no[i] < filter.max_combined) &
+                           (c.size_yes[i] >= filter.min_size) & (c.size_no[i] >= filter.min_size) &
+                           (c.update_ns_yes[i] >= cutoff) & (c.update_ns_no[i] >= cutoff);
+                if (hit)
+                {
+                    hits.push_back(static_cast<uint32_t>(i));
+                    found++;
+                }
+            }
+            return found;
+        }
+
+#ifdef POLYMARKET_SCAN_X86
+        __attribute__((target("avx2"))) size_t scan_avx2(const ScanColumns &c, size_t rows, const MarketScanFilter &filter,
+                                                         std::vector<uint32_t> &hits)
+        {
+            // Timestamps stay below 2^63, so the signed 64-bit compare is exact
+            const __m256d max_combined = _mm256_set1_pd(filter.max_combined);
+            const __m256d min_size = _mm256_set1_pd(filter.min_size);
+            const __m256i cutoff = _mm256_set1_epi64x(static_cast<long long>(fresh_cutoff(filter)));
+            size_t found = 0;
+            for (size_t i = 0; i < rows; i += 4)
+            {
+                __m256d combined = _mm256_add_pd(_mm256_load_pd(c.ask_yes + i), _mm256_load_pd(c.ask_no + i));
+                __m256d ok = _mm256_cmp_pd(combined, max_combined, _CMP_LT_OQ);
+                ok = _mm256_and_pd(ok, _mm256_cmp_pd(_mm256_load_pd(c.size_yes + i), min_size, _CMP_GE_OQ));
+                ok = _mm256_and_pd(ok, _mm256_cmp_pd(_mm256_load_pd(c.size_no + i), min_size, _CMP_GE_OQ));
+
+                __m256i stale = _mm256_or_si256(
+                    _mm256_cmpgt_epi64(cutoff, _mm256_load_si256(reinterpret_cast<const __m256i *>(c.update_ns_yes + i))),
+                    _mm256_cmpgt_epi64(cutoff, _mm256_load_si256(reinterpret_cast<const __m256i *>(c.update_ns_no + i))));
+                ok = _mm256_andnot_pd(_mm256_castsi256_pd(stale), ok);
+
+                unsigned mask = static_cast<unsigned>(_mm256_movemask_pd(ok));
+                while (mask)
+                {
+                    hits.push_back(static_cast<uint32_t>(i + __builtin_ctz(mask)));
+                    mask &= mask - 1;
+                    found++;
+                }
+            }
+            return found;
+        }
+
+        __attribute__((target("avx512f"))) size_t scan_avx512(const ScanColumns &c, size_t rows, const MarketScanFilter &filter,
+                                                              std::vector<uint32_t> &hits)
+        {
+            const __m512d max_combined = _mm512_set1_pd(filter.max_combined);
+            const __m512d min_size = _mm512_set1_pd(filter.min_size);
+            const __m512i cutoff = _mm512_set1_epi64(static_cast<long long>(fresh_cutoff(filter)));
+            size_t found = 0;
+            for (size_t i = 0; i < rows; i += 8)
+            {
+                __m512d combined = _mm512_add_pd(_mm512_load_pd(c.ask_yes + i), _mm512_load_pd(c.ask_no + i));
+                __mmask8 ok = _mm512_cmp_pd_mask(combined, max_combined, _CMP_LT_OQ);
+                ok &= _mm512_cmp_pd_mask(_mm512_load_pd(c.size_yes + i), min_size, _CMP_GE_OQ);
+                ok &= _mm512_cmp_pd_mask(_mm512_load_pd(c.size_no + i), min_size, _CMP_GE_OQ);
+                ok &= _mm512_cmp_epu64_mask(_mm512_load_si512(c.update_ns_yes + i), cutoff, _MM_CMPINT_NLT);
+                ok &= _mm512_cmp_epu64_mask(_mm512_load_si512(c.update_ns_no + i), cutoff, _MM_CMPINT_NLT);
+
+                unsigned mask = ok;
+                while (mask)
+                {
+                    hits.push_back(static_cast<uint32_t>(i + __builtin_ctz(mask)));
+                    mask &= mask - 1;
+                    found++;
+                }
+            }
+            return found;
+        }
+#endif
+    } // namespace
+
+    template <typename T>
+    MarketTable::Column<T> MarketTable::make_column(size_t rows, T fill)
+    {
+        T *data = static_cast<T *>(::operator new[](rows * sizeof(T), std::align_val_t(CACHE_LINE_SIZE)));
+        std::fill(data, data + rows, fill);
+        return Column<T>(data);
+    }
+
+    MarketTable::MarketTable(size_t capacity)
+        : capacity_((std::max<size_t>(capacity, 1) + ROW_ALIGN - 1) / ROW_ALIGN * ROW_ALIGN),
+          ask_yes_(make_column<double>(capacity_, NO_ASK)),
+          ask_no_(make_column<double>(capacity_, NO_ASK)),
+          size_yes_(make_column<double>(capacity_, 0.0)),
+          size_no_(make_column<double>(capacity_, 0.0)),
+          update_ns_yes_(make_column<uint64_t>(capacity_, 0)),
+          update_ns_no_(make_column<uint64_t>(capacity_, 0))
+    {
+    }
+
+    uint32_t MarketTable::assign(const std::string &condition_id)
+    {
+        std::lock_guard<std::mutex> lock(ids_mutex_);
+        auto existing = id_by_condition_.find(condition_id);
+        if (existing != id_by_condition_.end())
+        {
+            return existing->second;
+        }
+
+        uint32_t id;
+        if (!free_ids_.empty())
+        {
+            id = free_ids_.back();
+            free_ids_.pop_back();
+        }
+        else if (condition_ids_.size() < capacity_)
+        {
+            id = static_cast<uint32_t>(condition_ids_.size());
+            condition_ids_.emplace_back();
+        }
+        else
+        {
+            std::cerr << "[MarketTable] Full (" << capacity_ << " markets), " << condition_id
+                      << " is not scanned" << std::endl;
+            return INVALID_ID;
+        }
+
+        condition_ids_[id] = condition_id;
+        id_by_condition_[condition_id] = id;
+
+        size_t rows = (static_cast<size_t>(id) + ROW_ALIGN) / ROW_ALIGN * ROW_ALIGN;
+        if (rows > rows_.load(std::memory_order_relaxed))
+        {
+            rows_.store(rows, std::memory_order_release);
+        }
+        return id;
+    }
+
+    void MarketTable::release(uint32_t id)
+    {
+        std::lock_guard<std::mutex> lock(ids_mutex_);
+        if (id >= condition_ids_.size() || condition_ids_[id].empty())
+        {
+            return;
+        }
+        clear_row(id);
+        id_by_condition_.erase(condition_ids_[id]);
+        condition_ids_[id].clear();
+        free_ids_.push_back(id);
+    }
+
+    void MarketTable::clear_row(uint32_t id)
+    {
+        store(id, true, 0.0, 0.0, 0);
+        store(id, false, 0.0, 0.0, 0);
+    }
+
+    void MarketTable::store(uint32_t id, bool yes_leg, double ask, double size, uint64_t update_ns)
+    {
+        if (id >= capacity_)
+        {
+            return;
+        }
+        if (ask <= 0.0 || size <= 0.0)
+        {
+            ask = NO_ASK;
+            size = 0.0;
+        }
+
+        // Cell-wise relaxed stores: scans only need each value untorn
+        std::atomic_ref<double>((yes_leg ? ask_yes_ : ask_no_)[id]).store(ask, std::memory_order_relaxed);
+        std::atomic_ref<double>((yes_leg ? size_yes_ : size_no_)[id]).store(size, std::memory_order_relaxed);
+        std::atomic_ref<uint64_t>((yes_leg ? update_ns_yes_ : update_ns_no_)[id]).store(update_ns, std::memory_order_relaxed);
+    }
+
+    size_t MarketTable::scan(const MarketScanFilter &filter, std::vector<uint32_t> &hits, ScanKernel kernel) const
+    {
+        if (kernel == ScanKernel::AUTO || !kernel_supported(kernel))
+        {
+            kernel = best_kernel();
+        }
+
+        const ScanColumns columns{ask_yes_.get(), ask_no_.get(), size_yes_.get(), size_no_.get(),
+                                  update_ns_yes_.get(), update_ns_no_.get()};
+        const size_t rows = rows_.load(std::memory_order_acquire);
+
+        switch (kernel)
+        {
+#ifdef POLYMARKET_SCAN_X86
+        case ScanKernel::AVX512:
+            return scan_avx512(columns, rows, filter, hits);
+        case ScanKernel::AVX2:
+            return scan_avx2(columns, rows, filter, hits);
+#endif
+        default:
+            return scan_scalar(columns, rows, filter, hits);
+        }
+    }
+
+    std::string MarketTable::condition_id(uint32_t id) const
+    {
+        std::lock_guard<std::mutex> lock(ids_mutex_);
+        return id < condition_ids_.size() ? condition_ids_[id] : std::string();
+    }
+
+    size_t MarketTable::size() const
+    {
+        std::lock_guard<std::mutex> lock(ids_mutex_);
+        return id_by_condition_.size();
+    }
+
+    bool MarketTable::kernel_supported(ScanKernel kernel)
+    {
+        switch (kernel)
+        {
+        case ScanKernel::AUTO:
+        case ScanKernel::SCALAR:
+            return true;
+#ifdef POLYMARKET_SCAN_X86
+        case ScanKernel::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case ScanKernel::AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+        }
+    }
+
+    ScanKernel MarketTable::best_kernel()
+    {
+        static const ScanKernel best = kernel_supported(ScanKernel::AVX512) ? ScanKernel::AVX512
+                                       : kernel_supported(ScanKernel::AVX2) ? ScanKernel::AVX2
+                                                                            : ScanKernel::SCALAR;
+        return best;
+    }
+
+    const char *MarketTable::kernel_name(ScanKernel kernel)
+    {
+        switch (kernel)
+        {
+        case ScanKernel::AUTO:
+            return kernel_name(best_kernel());
+        case ScanKernel::AVX2:
+            return "avx2";
+        case ScanKernel::AVX512:
+            return "avx512";
+        default:
+            return "scalar";
+        }
+    }
+
+} // namespace polymarket
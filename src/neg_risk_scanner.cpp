@@ -0,0 +1,236 @@
+#include "neg_risk_scanner.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace polymarket
+{
+
+    NegRiskScanner::NegRiskScanner(const Config &config)
+        : config_(config)
+    {
+    }
+
+    void NegRiskScanner::add_markets(const std::vector<MarketState> &markets)
+    {
+        // Group first so single-outcome events never enter the index
+        std::unordered_map<std::string, std::vector<const MarketState *>> grouped;
+        std::vector<std::string> order;
+        for (const auto &market : markets)
+        {
+            if (market.neg_risk_market_id.empty() || market.token_yes.empty() ||
+                token_index_.count(market.token_yes))
+            {
+                continue;
+            }
+            auto &group = grouped[market.neg_risk_market_id];
+            if (group.empty())
+            {
+                order.push_back(market.neg_risk_market_id);
+            }
+            group.push_back(&market);
+        }
+
+        for (const auto &event_id : order)
+        {
+            const auto &group = grouped[event_id];
+            auto existing = event_index_.find(event_id);
+            if (existing == event_index_.end() && group.size() < 2)
+            {
+                continue;
+            }
+
+            size_t event_pos;
+            if (existing == event_index_.end())
+            {
+                event_pos = events_.size();
+                events_.push_back(std::make_unique<Event>());
+                events_.back()->id = event_id;
+                event_index_[event_id] = event_pos;
+            }
+            else
+            {
+                event_pos = existing->second;
+            }
+
+            Event &event = *events_[event_pos];
+            std::lock_guard<std::mutex> lock(event.mutex);
+            for (const auto *market : group)
+            {
+                event.expected_outcomes = std::max(event.expected_outcomes, market->neg_risk_outcomes);
+                token_index_[market->token_yes] = LegRef{event_pos, event.legs.size()};
+                Leg leg;
+                leg.condition_id = market->condition_id;
+                leg.token_id = market->token_yes;
+                event.legs.push_back(std::move(leg));
+                event.missing_asks++;
+                event.missing_bids++;
+            }
+        }
+
+        std::cout << "[NegRisk] Tracking " << events_.size() << " events over "
+                  << token_index_.size() << " outcomes" << std::endl;
+    }
+
+    void NegRiskScanner::on_opportunity(BasketOpportunityCallback callback)
+    {
+        on_opportunity_cb_ = std::move(callback);
+    }
+
+    void NegRiskScanner::enable_queue(size_t capacity)
+    {
+        queue_ = std::make_unique<MpscQueue<BasketOpportunity>>(capacity);
+    }
+
+    bool NegRiskScanner::poll(BasketOpportunity &opportunity)
+    {
+        return queue_ && queue_->try_pop(opportunity);
+    }
+
+    void NegRiskScanner::on_book(const std::string &asset_id, const Orderbook &book)
+    {
+        auto it = token_index_.find(asset_id);
+        if (it == token_index_.end())
+        {
+            return;
+        }
+        updates_++;
+
+        // An empty side means the leg has no price, not a price of 0 or 1
+        bool has_ask = !book.asks.empty();
+        bool has_bid = !book.bids.empty();
+        double ask = has_ask ? book.best_ask() : 0.0;
+        double bid = has_bid ? book.best_bid() : 0.0;
+        double ask_size = has_ask ? book.best_ask_size() : 0.0;
+        double bid_size = has_bid ? book.best_bid_size() : 0.0;
+
+        Event &event = *events_[it->second.event];
+        std::optional<BasketOpportunity> fired[2];
+        {
+            std::lock_guard<std::mutex> lock(event.mutex);
+            Leg &leg = event.legs[it->second.leg];
+
+            // O(1): move each sum by this leg's delta
+            event.ask_sum += ask - leg.ask;
+            event.bid_sum += bid - leg.bid;
+            event.missing_asks += static_cast<size_t>(!has_ask) - static_cast<size_t>(!leg.has_ask);
+            event.missing_bids += static_cast<size_t>(!has_bid) - static_cast<size_t>(!leg.has_bid);
+            leg.ask = ask;
+            leg.bid = bid;
+            leg.ask_size = ask_size;
+            leg.bid_size = bid_size;
+            leg.has_ask = has_ask;
+            leg.has_bid = has_bid;
+
+            if (++event.since_resync >= RESYNC_INTERVAL)
+            {
+                resync(event);
+            }
+
+            // Fire once per crossing; the O(N) leg snapshot is only built on a fire
+            bool complete = event.expected_outcomes != 0 && event.legs.size() >= event.expected_outcomes;
+            bool buy = complete && event.missing_asks == 0 && event.ask_sum < 1.0 - config_.neg_risk_min_edge;
+            if (buy && event.buy_armed)
+            {
+                fired[0] = make_opportunity(event, BasketSide::BUY_YES);
+            }
+            event.buy_armed = !buy;
+
+            bool sell = event.missing_bids == 0 && event.bid_sum > 1.0 + config_.neg_risk_min_edge;
+            if (sell && event.sell_armed)
+            {
+                fired[1] = make_opportunity(event, BasketSide::SELL_YES);
+            }
+            event.sell_armed = !sell;
+        }
+
+        // Delivered outside the event lock so a slow callback does not stall the feed
+        for (auto &opportunity : fired)
+        {
+            if (opportunity)
+            {
+                deliver(std::move(*opportunity));
+            }
+        }
+    }
+
+    void NegRiskScanner::resync(Event &event)
+    {
+        event.ask_sum = 0.0;
+        event.bid_sum = 0.0;
+        for (const auto &leg : event.legs)
+        {
+            event.ask_sum += leg.ask;
+            event.bid_sum += leg.bid;
+        }
+        event.since_resync = 0;
+    }
+
+    BasketOpportunity NegRiskScanner::make_opportunity(const Event &event, BasketSide side) const
+    {
+        BasketOpportunity opportunity;
+        opportunity.event_id = event.id;
+        opportunity.side = side;
+        opportunity.detected_ns = now_ns();
+        opportunity.legs.reserve(event.legs.size());
+
+        double shares = -1.0;
+        for (const auto &leg : event.legs)
+        {
+            BasketLeg basket_leg;
+            basket_leg.condition_id = leg.condition_id;
+            basket_leg.token_id = leg.token_id;
+            basket_leg.price = side == BasketSide::BUY_YES ? leg.ask : leg.bid;
+            basket_leg.size = side == BasketSide::BUY_YES ? leg.ask_size : leg.bid_size;
+            opportunity.price_sum += basket_leg.price;
+            shares = shares < 0.0 ? basket_leg.size : std::min(shares, basket_leg.size);
+            opportunity.legs.push_back(std::move(basket_leg));
+        }
+
+        // Exact sum of the snapshot, not the running one
+        opportunity.edge_per_share = side == BasketSide::BUY_YES ? 1.0 - opportunity.price_sum
+                                                                 : opportunity.price_sum - 1.0;
+
+        // Equal shares on every leg; the thinnest top level bounds the basket
+        opportunity.shares = std::max(shares, 0.0);
+        if (config_.size_usdc > 0.0 && opportunity.price_sum > 0.0)
+        {
+            opportunity.shares = std::min(opportunity.shares, config_.size_usdc / opportunity.price_sum);
+        }
+        return opportunity;
+    }
+
+    void NegRiskScanner::deliver(BasketOpportunity &&opportunity)
+    {
+        opportunities_++;
+        if (on_opportunity_cb_)
+        {
+            on_opportunity_cb_(opportunity);
+        }
+        if (queue_ && !queue_->try_push(std::move(opportunity)))
+        {
+            dropped_++;
+        }
+    }
+
+    std::optional<EventQuote> NegRiskScanner::quote(const std::string &event_id) const
+    {
+        auto it = event_index_.find(event_id);
+        if (it == event_index_.end())
+        {
+            return std::nullopt;
+        }
+
+        const Event &event = *events_[it->second];
+        std::lock_guard<std::mutex> lock(event.mutex);
+        EventQuote quote;
+        quote.event_id = event.id;
+        quote.outcomes = event.legs.size();
+        quote.expected_outcomes = event.expected_outcomes;
+        quote.missing_asks = event.missing_asks;
+        quote.missing_bids = event.missing_bids;
+        quote.ask_sum = event.ask_sum;
+        quote.bid_sum = event.bid_sum;
+        return quote;
+    }
+
+} // namespace polymarket
@@ -0,0 +1,457 @@
+#include "order_store.hpp"
+#include "user_channel.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace polymarket
+{
+
+    namespace
+    {
+        constexpr double SIZE_EPSILON = 1e-9;
+
+        // REST fields are decimal strings; a malformed value counts as zero
+        double to_double(const std::string &value)
+        {
+            try
+            {
+                return value.empty() ? 0.0 : std::stod(value);
+            }
+            catch (...)
+            {
+                return 0.0;
+            }
+        }
+
+        OrderSide parse_side(const std::string &side)
+        {
+            return (side == "SELL" || side == "sell") ? OrderSide::SELL : OrderSide::BUY;
+        }
+
+        bool is_immediate(OrderType type)
+        {
+            return type == OrderType::FOK || type == OrderType::FAK;
+        }
+    } // namespace
+
+    OrderStore::~OrderStore()
+    {
+        stop_reconciler();
+    }
+
+    void OrderStore::update_locked(const std::string &order_id, const std::function<void(Entry &)> &mutate)
+    {
+        auto [it, inserted] = orders_.try_emplace(order_id);
+        Entry &entry = it->second;
+        TrackedOrder &order = entry.order;
+        if (inserted)
+        {
+            order.id = order_id;
+        }
+        else
+        {
+            add_exposure_locked(order, -1);
+        }
+
+        OrderState previous = order.state;
+        std::string previous_market = order.market;
+        mutate(entry);
+
+        if (!inserted && !is_open(previous))
+        {
+            order.state = previous; // Terminal states are final
+        }
+        else if (is_open(order.state) && order.size_matched > SIZE_EPSILON)
+        {
+            order.state = (order.original_size > 0 && order.size_matched >= order.original_size - SIZE_EPSILON)
+                              ? OrderState::FILLED
+                              : OrderState::PARTIALLY_FILLED;
+        }
+        order.updated_ns = now_ns();
+
+        if (order.market != previous_market)
+        {
+            if (!previous_market.empty())
+            {
+                auto market_it = by_market_.find(previous_market);
+                if (market_it != by_market_.end())
+                {
+                    market_it->second.erase(order_id);
+                    if (market_it->second.empty())
+                    {
+                        by_market_.erase(market_it);
+                    }
+                }
+            }
+            if (!order.market.empty())
+            {
+                by_market_[order.market].insert(order_id);
+            }
+        }
+
+        add_exposure_locked(order, +1);
+    }
+
+    void OrderStore::add_exposure_locked(const TrackedOrder &order, int sign)
+    {
+        if (!is_open(order.state) || order.asset_id.empty())
+        {
+            return;
+        }
+
+        auto &exposure = by_token_[order.asset_id];
+        double working = sign * order.working_size();
+        if (order.side == OrderSide::BUY)
+        {
+            exposure.working_buy += working;
+        }
+        else
+        {
+            exposure.working_sell += working;
+        }
+
+        if (sign > 0)
+        {
+            exposure.open_orders++;
+            open_count_++;
+        }
+        else
+        {
+            exposure.open_orders--;
+            open_count_--;
+            if (exposure.open_orders == 0)
+            {
+                by_token_.erase(order.asset_id); // Also discards floating-point residue
+            }
+        }
+    }
+
+    void OrderStore::on_post(const SignedOrder &order, const OrderResponse &response, OrderType order_type)
+    {
+        if (response.order_id.empty())
+        {
+            return; // Rejected before the exchange assigned an id: nothing to track
+        }
+
+        // Amounts are 6-decimal fixed point; BUY pays USDC for shares, SELL the reverse
+        double maker = to_double(order.maker_amount) / 1e6;
+        double taker = to_double(order.taker_amount) / 1e6;
+        bool buy = order.side == 0;
+        double size = buy ? taker : maker;
+        double price = size > 0 ? (buy ? maker : taker) / size : 0.0;
+        double matched = to_double(buy ? response.taking_amount : response.making_amount);
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        update_locked(response.order_id, [&](Entry &entry)
+                      {
+            auto &tracked = entry.order;
+            tracked.asset_id = order.token_id;
+            tracked.side = buy ? OrderSide::BUY : OrderSide::SELL;
+            tracked.price = price;
+            tracked.original_size = size;
+            tracked.size_matched = std::max(tracked.size_matched, matched);
+
+            if (!response.success)
+            {
+                tracked.state = OrderState::REJECTED;
+            }
+            else if (response.status == "delayed")
+            {
+                tracked.state = OrderState::PENDING;
+            }
+            else if (is_immediate(order_type) && response.status != "live")
+            {
+                // FOK/FAK never rest: whatever did not match is killed
+                tracked.state = tracked.size_matched >= size - SIZE_EPSILON ? OrderState::FILLED : OrderState::CANCELED;
+            }
+            else if (tracked.state == OrderState::PENDING)
+            {
+                tracked.state = OrderState::LIVE;
+            } });
+    }
+
+    void OrderStore::on_cancel(const std::vector<std::string> &order_ids)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        for (const auto &id : order_ids)
+        {
+            if (orders_.count(id))
+            {
+                update_locked(id, [](Entry &entry)
+                              { entry.order.state = OrderState::CANCELED; });
+            }
+        }
+    }
+
+    void OrderStore::on_user_order(const UserOrderEvent &event)
+    {
+        if (event.id.empty())
+        {
+            return;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        update_locked(event.id, [&](Entry &entry)
+                      {
+            auto &tracked = entry.order;
+            if (!event.market.empty())
+                tracked.market = event.market;
+            if (!event.asset_id.empty())
+                tracked.asset_id = event.asset_id;
+            if (!event.side.empty())
+                tracked.side = parse_side(event.side);
+            if (event.price > 0)
+                tracked.price = event.price;
+            if (event.original_size > 0)
+                tracked.original_size = event.original_size;
+
+            // size_matched is cumulative; remember which trades it covers so the
+            // matching trade events are not counted a second time
+            tracked.size_matched = std::max(tracked.size_matched, event.size_matched);
+            entry.trades.insert(event.associate_trades.begin(), event.associate_trades.end());
+
+            if (event.type == UserOrderEventType::CANCELLATION)
+            {
+                tracked.state = OrderState::CANCELED;
+            }
+            else if (tracked.state == OrderState::PENDING)
+            {
+                tracked.state = OrderState::LIVE;
+            } });
+    }
+
+    void OrderStore::on_user_trade(const UserTradeEvent &event)
+    {
+        // A trade is reported again as it is mined and confirmed; count it once, when matched
+        if (event.status != TradeStatus::MATCHED || event.id.empty())
+        {
+            return;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto add_fill = [&](const std::string &order_id, double amount)
+        {
+            // Fills only apply to orders we know; an unknown taker id is someone else's order
+            auto it = orders_.find(order_id);
+            if (it == orders_.end() || it->second.trades.count(event.id))
+            {
+                return;
+            }
+            update_locked(order_id, [&](Entry &entry)
+                          {
+                entry.trades.insert(event.id);
+                entry.order.size_matched += amount;
+                if (entry.order.market.empty())
+                    entry.order.market = event.market; });
+        };
+
+        add_fill(event.taker_order_id, event.size);
+        for (const auto &maker : event.maker_orders)
+        {
+            add_fill(maker.order_id, maker.matched_amount);
+        }
+    }
+
+    void OrderStore::reconcile(const std::vector<OpenOrder> &open_orders, const std::string &market,
+                               std::chrono::milliseconds grace)
+    {
+        uint64_t cutoff_ns = now_ns() - static_cast<uint64_t>(std::chrono::nanoseconds(grace).count());
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+
+        // Snapshot values are authoritative for open orders
+        std::unordered_set<std::string> seen;
+        for (const auto &open : open_orders)
+        {
+            seen.insert(open.id);
+            update_locked(open.id, [&](Entry &entry)
+                          {
+                auto &tracked = entry.order;
+                tracked.market = open.market;
+                tracked.asset_id = open.asset_id;
+                tracked.side = parse_side(open.side);
+                tracked.price = to_double(open.price);
+                tracked.original_size = to_double(open.original_size);
+                tracked.size_matched = to_double(open.size_matched);
+                if (tracked.state == OrderState::PENDING)
+                    tracked.state = OrderState::LIVE; });
+        }
+
+        // Orders posted after the snapshot was taken are inside the grace window
+        std::vector<std::string> missing;
+        for (const auto &[id, entry] : orders_)
+        {
+            const auto &tracked = entry.order;
+            if (is_open(tracked.state) && !seen.count(id) && tracked.updated_ns < cutoff_ns &&
+                (market.empty() || tracked.market == market))
+            {
+                missing.push_back(id);
+            }
+        }
+        for (const auto &id : missing)
+        {
+            update_locked(id, [](Entry &entry)
+                          { entry.order.state = OrderState::CLOSED; });
+        }
+
+        if (!missing.empty())
+        {
+            std::cout << "[OrderStore] Reconcile closed " << missing.size() << " order(s) missing from REST" << std::endl;
+        }
+    }
+
+    void OrderStore::prune_locked(std::chrono::minutes max_age)
+    {
+        uint64_t cutoff_ns = now_ns() - static_cast<uint64_t>(std::chrono::nanoseconds(max_age).count());
+        for (auto it = orders_.begin(); it != orders_.end();)
+        {
+            const auto &tracked = it->second.order;
+            if (is_open(tracked.state) || tracked.updated_ns >= cutoff_ns)
+            {
+                ++it;
+                continue;
+            }
+
+            auto market_it = by_market_.find(tracked.market);
+            if (market_it != by_market_.end())
+            {
+                market_it->second.erase(tracked.id);
+                if (market_it->second.empty())
+                {
+                    by_market_.erase(market_it);
+                }
+            }
+            it = orders_.erase(it);
+        }
+    }
+
+    std::optional<TrackedOrder> OrderStore::get(const std::string &order_id) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = orders_.find(order_id);
+        if (it == orders_.end())
+        {
+            return std::nullopt;
+        }
+        return it->second.order;
+    }
+
+    TokenExposure OrderStore::exposure(const std::string &asset_id) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = by_token_.find(asset_id);
+        return it != by_token_.end() ? it->second : TokenExposure{};
+    }
+
+    double OrderStore::working_size(const std::string &asset_id, OrderSide side) const
+    {
+        auto token = exposure(asset_id);
+        return side == OrderSide::BUY ? token.working_buy : token.working_sell;
+    }
+
+    std::vector<TrackedOrder> OrderStore::open_orders(const std::string &market) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::vector<TrackedOrder> result;
+
+        if (market.empty())
+        {
+            for (const auto &[id, entry] : orders_)
+            {
+                if (is_open(entry.order.state))
+                {
+                    result.push_back(entry.order);
+                }
+            }
+            return result;
+        }
+
+        auto it = by_market_.find(market);
+        if (it == by_market_.end())
+        {
+            return result;
+        }
+        for (const auto &id : it->second)
+        {
+            const auto &tracked = orders_.at(id).order;
+            if (is_open(tracked.state))
+            {
+                result.push_back(tracked);
+            }
+        }
+        return result;
+    }
+
+    size_t OrderStore::open_count() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return open_count_;
+    }
+
+    size_t OrderStore::size() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return orders_.size();
+    }
+
+    void OrderStore::start_reconciler(ClobClient *client, long interval_seconds)
+    {
+        {
+            std::lock_guard<std::mutex> lock(reconcile_mutex_);
+            if (reconcile_running_ || !client)
+            {
+                return;
+            }
+            reconcile_running_ = true;
+        }
+
+        reconcile_thread_ = std::thread([this, client, interval_seconds]()
+                                        {
+            std::unique_lock<std::mutex> lock(reconcile_mutex_);
+            while (reconcile_running_)
+            {
+                reconcile_cv_.wait_for(lock, std::chrono::seconds(interval_seconds),
+                                       [this]() { return !reconcile_running_; });
+                if (!reconcile_running_)
+                {
+                    break;
+                }
+
+                lock.unlock();
+                try
+                {
+                    // Every page, or nothing: an empty snapshot that succeeded closes what we hold
+                    auto snapshot = client->get_all_open_orders();
+                    if (snapshot)
+                    {
+                        reconcile(*snapshot);
+                    }
+                    else
+                    {
+                        std::cerr << "[OrderStore] Open-order snapshot failed; reconcile skipped" << std::endl;
+                    }
+                    std::unique_lock<std::shared_mutex> store_lock(mutex_);
+                    prune_locked(std::chrono::minutes(10));
+                }
+                catch (const std::exception &e)
+                {
+                    std::cerr << "[OrderStore] Reconcile failed: " << e.what() << std::endl;
+                }
+                lock.lock();
+            } });
+    }
+
+    void OrderStore::stop_reconciler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(reconcile_mutex_);
+            reconcile_running_ = false;
+        }
+        reconcile_cv_.notify_all();
+        if (reconcile_thread_.joinable())
+        {
+            reconcile_thread_.join();
+        }
+    }
+
+} // namespace polymarket
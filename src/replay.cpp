@@ -0,0 +1,229 @@
+#include "types.hpp"
+#include "orderbook.hpp"
+#include "feed_replay.hpp"
+#include "market_catalog.hpp"
+#include <iostream>
+#include <csignal>
+#include <atomic>
+#include <iomanip>
+#include <algorithm>
+#include <map>
+
+using namespace polymarket;
+
+// Replay in progress, stopped by SIGINT/SIGTERM
+std::atomic<FeedReplay *> g_replay{nullptr};
+
+void signal_handler(int)
+{
+    if (FeedReplay *replay = g_replay.load())
+    {
+        replay->stop();
+    }
+}
+
+void print_usage()
+{
+    std::cout << "Polymarket Feed Replay\n"
+              << "======================\n\n"
+              << "Usage: polymarket_replay RECORDING [options]\n\n"
+              << "RECORDING is a journal directory (polymarket_arb --record DIR), one journal segment,\n"
+              << "or a JSONL capture. Messages go through the same OrderbookManager decode, book and\n"
+              << "arb detection as the live bot, on this thread, with the recording's clock.\n\n"
+              << "Options:\n"
+              << "  --help          Show this help message\n"
+              << "  --original      Replay at the recorded pacing (default: maximum speed)\n"
+              << "  --speed X       With --original: X times faster than recorded (default: 1)\n"
+              << "  --from SEC      Skip messages received before unix time SEC\n"
+              << "  --until SEC     Stop at messages received after unix time SEC\n"
+              << "  --catalog FILE  Subscribe every market of a catalog (recordings without subscriptions)\n"
+              << "  --feed MODE     Orderbook feed: rtds, clob, or arb (default: as recorded)\n"
+              << "  --shards N      Feed shards (default: as recorded)\n"
+              << "  --trigger N     Trigger threshold for arb (default: 0.98)\n"
+              << "  --rounds N      Replay N times, report the fastest (throughput benchmark)\n"
+              << "  --signals N     Print the first N arb signals (default: 10)\n"
+              << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string path;
+    ReplayOptions options;
+    std::string catalog_path;
+    std::string feed; // Empty = as recorded
+    int shards = 0;                            // 0 = as recorded
+    double trigger = 0.98;
+    int rounds = 1;
+    int print_signals = 10;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--help")
+        {
+            print_usage();
+            return 0;
+        }
+        else if (arg == "--original")
+        {
+            options.pacing = ReplayPacing::ORIGINAL;
+        }
+        else if (arg == "--speed" && i + 1 < argc)
+        {
+            options.speed = std::stod(argv[++i]);
+        }
+        else if (arg == "--from" && i + 1 < argc)
+        {
+            options.from_ns = static_cast<uint64_t>(std::stod(argv[++i]) * 1e9);
+        }
+        else if (arg == "--until" && i + 1 < argc)
+        {
+            options.until_ns = static_cast<uint64_t>(std::stod(argv[++i]) * 1e9);
+        }
+        else if (arg == "--catalog" && i + 1 < argc)
+        {
+            catalog_path = argv[++i];
+        }
+        else if (arg == "--feed" && i + 1 < argc)
+        {
+            feed = argv[++i];
+        }
+        else if (arg == "--shards" && i + 1 < argc)
+        {
+            shards = std::stoi(argv[++i]);
+        }
+        else if (arg == "--trigger" && i + 1 < argc)
+        {
+            trigger = std::stod(argv[++i]);
+        }
+        else if (arg == "--rounds" && i + 1 < argc)
+        {
+            rounds = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--signals" && i + 1 < argc)
+        {
+            print_signals = std::stoi(argv[++i]);
+        }
+        else if (path.empty() && arg.rfind("--", 0) != 0)
+        {
+            path = arg;
+        }
+    }
+
+    if (path.empty())
+    {
+        print_usage();
+        return 1;
+    }
+
+    std::signal(SIGINT, signal_handler);
+    std::signal(SIGTERM, signal_handler);
+
+    ReplaySource source;
+    if (!source.open(path))
+    {
+        return 1;
+    }
+    ReplayManifest manifest = source.scan();
+    std::cout << "[Replay] " << path << ": " << manifest.events << " events, " << manifest.markets.size()
+              << " subscriptions, " << manifest.shards << " shard(s), "
+              << std::fixed << std::setprecision(1)
+              << (manifest.last_ns > manifest.first_ns ? (manifest.last_ns - manifest.first_ns) / 1e9 : 0.0)
+              << "s recorded" << std::endl;
+
+    if (!catalog_path.empty())
+    {
+        MarketCatalog catalog;
+        if (!catalog.load(catalog_path))
+        {
+            std::cerr << "[Error] Cannot load catalog " << catalog_path << std::endl;
+            return 1;
+        }
+        options.markets = catalog.all();
+    }
+    if (manifest.markets.empty() && options.markets.empty())
+    {
+        std::cerr << "[Warn] Recording has no subscriptions; pass --catalog or every book is dropped" << std::endl;
+    }
+
+    // Arbitration only when both feeds were recorded: it also drops same-feed repeats
+    if (feed.empty())
+    {
+        feed = manifest.rtds && manifest.clob ? "arb" : manifest.rtds ? "rtds"
+                                                                      : "clob";
+    }
+
+    Config config;
+    config.trigger_combined = trigger;
+    config.feed_mode = feed == "rtds" ? FeedMode::RTDS : feed == "clob" ? FeedMode::CLOB
+                                                                        : FeedMode::ARBITRATED;
+    config.ws_shards = shards > 0 ? shards : static_cast<int>(manifest.shards); // Same market -> shard mapping as recorded
+    config.strategy_threads = 0; // Callbacks inline: deterministic
+
+    ReplayStats best;
+    uint64_t best_updates = 0, best_arbs = 0, best_gaps = 0;
+    for (int round = 0; round < rounds; round++)
+    {
+        OrderbookManager orderbook_mgr(config);
+
+        // Arb signals as the live bot would post them to its executor
+        std::map<std::string, std::pair<uint64_t, double>> by_market; // slug -> count, best combined
+        int printed = 0;
+        orderbook_mgr.on_arb_opportunity([&](const ArbSignal &signal)
+                                         {
+            auto &entry = by_market[signal.slug.empty() ? signal.condition_id : signal.slug];
+            entry.first++;
+            entry.second = entry.first == 1 ? signal.executable.avg_combined : std::min(entry.second, signal.executable.avg_combined);
+            if (round == 0 && printed < print_signals)
+            {
+                printed++;
+                std::cout << "[Arb] " << signal.slug << " @" << signal.book_ns / 1000000 << "ms SUM=" << std::setprecision(4)
+                          << signal.combined << " executable=" << signal.executable.shares << "sh @"
+                          << signal.executable.avg_combined << std::endl;
+            } });
+
+        FeedReplay replay(options);
+        g_replay.store(&replay);
+        source.rewind();
+        ReplayStats stats = replay.run(source, orderbook_mgr);
+        g_replay.store(nullptr);
+
+        std::cout << "[Replay] Round " << round + 1 << ": " << stats.events << " events in " << std::setprecision(3)
+                  << stats.wall_sec << "s (" << std::setprecision(0) << stats.events_per_sec() << " events/s)" << std::endl;
+        if (round == 0 || stats.wall_sec < best.wall_sec)
+        {
+            best = stats;
+            best_updates = orderbook_mgr.total_updates();
+            best_arbs = orderbook_mgr.arb_opportunities();
+            best_gaps = orderbook_mgr.gaps_detected();
+        }
+
+        if (round == rounds - 1 && !by_market.empty())
+        {
+            std::cout << "[Replay] Arb signals by market:" << std::endl;
+            for (const auto &[market, entry] : by_market)
+            {
+                std::cout << "  " << market << ": " << entry.first << " signals, best executable SUM="
+                          << std::setprecision(4) << entry.second << std::endl;
+            }
+        }
+    }
+
+    std::cout << "[Replay] Final stats - Events: " << best.events
+              << " | Messages: " << best.messages
+              << " | Books: " << best.books
+              << " | Subscriptions: " << best.markets
+              << " | Malformed: " << best.malformed << std::endl;
+    std::cout << "[Replay] Updates: " << best_updates
+              << " | Arb opportunities: " << best_arbs
+              << " | Gaps: " << best_gaps << std::endl;
+    std::cout << "[Replay] Recorded " << std::setprecision(1) << best.recorded_sec() << "s replayed in "
+              << std::setprecision(3) << best.wall_sec << "s (" << std::setprecision(0) << best.events_per_sec()
+              << " events/s";
+    if (options.pacing == ReplayPacing::ORIGINAL)
+    {
+        std::cout << ", max behind schedule " << std::setprecision(2) << best.max_behind_ns / 1e6 << "ms";
+    }
+    std::cout << ")" << std::endl;
+    return 0;
+}
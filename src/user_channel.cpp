@@ -0,0 +1,341 @@
+#include "user_channel.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+using json = nlohmann::json;
+
+namespace polymarket
+{
+
+    namespace
+    {
+        // User channel numbers arrive as strings ("0.45"); tolerate plain numbers too
+        double number_field(const json &obj, const char *key)
+        {
+            if (!obj.contains(key) || obj[key].is_null())
+            {
+                return 0.0;
+            }
+            const auto &v = obj[key];
+            return v.is_string() ? std::stod(v.get<std::string>()) : v.get<double>();
+        }
+
+        uint64_t timestamp_field(const json &obj, const char *key)
+        {
+            if (!obj.contains(key) || obj[key].is_null())
+            {
+                return 0;
+            }
+            const auto &v = obj[key];
+            return v.is_string() ? std::stoull(v.get<std::string>()) : v.get<uint64_t>();
+        }
+
+        UserOrderEventType parse_order_type(const std::string &type)
+        {
+            if (type == "PLACEMENT")
+                return UserOrderEventType::PLACEMENT;
+            if (type == "UPDATE")
+                return UserOrderEventType::UPDATE;
+            if (type == "CANCELLATION")
+                return UserOrderEventType::CANCELLATION;
+            return UserOrderEventType::UNKNOWN;
+        }
+
+        TradeStatus parse_trade_status(const std::string &status)
+        {
+            if (status == "MATCHED")
+                return TradeStatus::MATCHED;
+            if (status == "MINED")
+                return TradeStatus::MINED;
+            if (status == "CONFIRMED")
+                return TradeStatus::CONFIRMED;
+            if (status == "RETRYING")
+                return TradeStatus::RETRYING;
+            if (status == "FAILED")
+                return TradeStatus::FAILED;
+            return TradeStatus::UNKNOWN;
+        }
+    } // namespace
+
+    UserChannelClient::UserChannelClient(const Config &config, const ApiCredentials &creds)
+        : config_(config), creds_(creds)
+    {
+        ws_.set_url(config_.clob_user_ws_url);
+        ws_.set_ping_interval_ms(config_.ws_ping_interval_ms);
+        ws_.set_auto_reconnect(true);
+
+        ws_.on_message_view([this](const WsMessage &msg)
+                            { handle_message(msg.data); });
+
+        ws_.on_connect([this]()
+                       {
+            std::cout << "[UserWS] Connected to user channel" << std::endl;
+            send_subscribe(); });
+
+        ws_.on_disconnect([]()
+                          { std::cout << "[UserWS] Disconnected from user channel" << std::endl; });
+
+        ws_.on_error([](const std::string &error)
+                     { std::cerr << "[UserWS] Error: " << error << std::endl; });
+    }
+
+    UserChannelClient::~UserChannelClient()
+    {
+        stop();
+    }
+
+    void UserChannelClient::subscribe(const std::vector<std::string> &condition_ids)
+    {
+        std::vector<std::string> added;
+        {
+            std::lock_guard<std::mutex> lock(markets_mutex_);
+            for (const auto &id : condition_ids)
+            {
+                if (std::find(markets_.begin(), markets_.end(), id) == markets_.end())
+                {
+                    markets_.push_back(id);
+                    added.push_back(id);
+                }
+            }
+        }
+
+        if (!added.empty() && ws_.is_connected())
+        {
+            json msg;
+            msg["markets"] = added;
+            msg["operation"] = "subscribe";
+            ws_.send(msg.dump());
+        }
+    }
+
+    void UserChannelClient::unsubscribe(const std::vector<std::string> &condition_ids)
+    {
+        std::vector<std::string> removed;
+        {
+            std::lock_guard<std::mutex> lock(markets_mutex_);
+            for (const auto &id : condition_ids)
+            {
+                auto it = std::find(markets_.begin(), markets_.end(), id);
+                if (it != markets_.end())
+                {
+                    markets_.erase(it);
+                    removed.push_back(id);
+                }
+            }
+        }
+
+        if (!removed.empty() && ws_.is_connected())
+        {
+            json msg;
+            msg["markets"] = removed;
+            msg["operation"] = "unsubscribe";
+            ws_.send(msg.dump());
+        }
+    }
+
+    void UserChannelClient::send_subscribe()
+    {
+        // {"auth": {"apiKey", "secret", "passphrase"}, "markets": [condition_id, ...], "type": "user"}
+        json msg;
+        msg["auth"] = {{"apiKey", creds_.api_key}, {"secret", creds_.api_secret}, {"passphrase", creds_.api_passphrase}};
+        msg["type"] = "user";
+        {
+            std::lock_guard<std::mutex> lock(markets_mutex_);
+            msg["markets"] = markets_;
+        }
+        ws_.send(msg.dump());
+    }
+
+    void UserChannelClient::on_order(UserOrderCallback callback)
+    {
+        on_order_cb_ = std::move(callback);
+    }
+
+    void UserChannelClient::on_trade(UserTradeCallback callback)
+    {
+        on_trade_cb_ = std::move(callback);
+    }
+
+    void UserChannelClient::enable_queue(size_t capacity)
+    {
+        queue_ = std::make_unique<SpscQueue<UserEvent>>(capacity);
+    }
+
+    bool UserChannelClient::poll(UserEvent &event)
+    {
+        return queue_ && queue_->try_pop(event);
+    }
+
+    bool UserChannelClient::connect()
+    {
+        running_.store(true);
+        return ws_.connect();
+    }
+
+    void UserChannelClient::disconnect()
+    {
+        ws_.disconnect();
+    }
+
+    bool UserChannelClient::is_connected() const
+    {
+        return ws_.is_connected();
+    }
+
+    bool UserChannelClient::wait_until_connected(std::chrono::milliseconds timeout)
+    {
+        return ws_.wait_until_connected(timeout);
+    }
+
+    void UserChannelClient::run()
+    {
+        ws_.run();
+    }
+
+    void UserChannelClient::stop()
+    {
+        running_.store(false);
+        ws_.stop();
+    }
+
+    std::vector<UserEvent> UserChannelClient::parse_events(std::string_view message)
+    {
+        std::vector<UserEvent> events;
+        auto j = json::parse(message.begin(), message.end());
+        uint64_t received_ns = now_ns();
+
+        auto parse_one = [&](const json &item)
+        {
+            if (!item.is_object() || !item.contains("event_type"))
+            {
+                return;
+            }
+
+            std::string event_type = item["event_type"].get<std::string>();
+            if (event_type == "order")
+            {
+                UserOrderEvent order;
+                order.type = parse_order_type(item.value("type", ""));
+                order.id = item.value("id", "");
+                order.market = item.value("market", "");
+                order.asset_id = item.value("asset_id", "");
+                order.side = item.value("side", "");
+                order.outcome = item.value("outcome", "");
+                order.price = number_field(item, "price");
+                order.original_size = number_field(item, "original_size");
+                order.size_matched = number_field(item, "size_matched");
+                if (item.contains("associate_trades") && item["associate_trades"].is_array())
+                {
+                    for (const auto &trade_id : item["associate_trades"])
+                    {
+                        order.associate_trades.push_back(trade_id.get<std::string>());
+                    }
+                }
+                order.timestamp_ms = timestamp_field(item, "timestamp");
+                order.received_ns = received_ns;
+                events.emplace_back(std::move(order));
+            }
+            else if (event_type == "trade")
+            {
+                UserTradeEvent trade;
+                trade.status = parse_trade_status(item.value("status", ""));
+                trade.id = item.value("id", "");
+                trade.taker_order_id = item.value("taker_order_id", "");
+                trade.market = item.value("market", "");
+                trade.asset_id = item.value("asset_id", "");
+                trade.side = item.value("side", "");
+                trade.outcome = item.value("outcome", "");
+                trade.price = number_field(item, "price");
+                trade.size = number_field(item, "size");
+                if (item.contains("maker_orders") && item["maker_orders"].is_array())
+                {
+                    for (const auto &maker : item["maker_orders"])
+                    {
+                        MakerFill fill;
+                        fill.order_id = maker.value("order_id", "");
+                        fill.asset_id = maker.value("asset_id", "");
+                        fill.outcome = maker.value("outcome", "");
+                        fill.price = number_field(maker, "price");
+                        fill.matched_amount = number_field(maker, "matched_amount");
+                        trade.maker_orders.push_back(std::move(fill));
+                    }
+                }
+                trade.timestamp_ms = timestamp_field(item, "timestamp");
+                trade.received_ns = received_ns;
+                events.emplace_back(std::move(trade));
+            }
+        };
+
+        if (j.is_array())
+        {
+            for (const auto &item : j)
+            {
+                parse_one(item);
+            }
+        }
+        else
+        {
+            parse_one(j);
+        }
+        return events;
+    }
+
+    void UserChannelClient::handle_message(std::string_view message)
+    {
+        // Server keep-alives and acks are not JSON events
+        if (message.empty() || (message.front() != '{' && message.front() != '['))
+        {
+            return;
+        }
+
+        try
+        {
+            for (auto &event : parse_events(message))
+            {
+                deliver(std::move(event));
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "[UserWS] Parse error: " << e.what() << std::endl;
+        }
+    }
+
+    void UserChannelClient::deliver(UserEvent &&event)
+    {
+        if (const auto *order = std::get_if<UserOrderEvent>(&event))
+        {
+            order_events_++;
+            if (on_order_cb_)
+            {
+                on_order_cb_(*order);
+            }
+        }
+        else if (const auto *trade = std::get_if<UserTradeEvent>(&event))
+        {
+            trade_events_++;
+            if (on_trade_cb_)
+            {
+                on_trade_cb_(*trade);
+            }
+        }
+
+        if (!queue_)
+        {
+            return;
+        }
+
+        // Order and fill events must not be lost: wait for the consumer rather than drop
+        while (!queue_->try_push(std::move(event)))
+        {
+            if (!running_.load())
+            {
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+} // namespace polymarket
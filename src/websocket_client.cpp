@@ -6,7 +6,7 @@ namespace polymarket
 {
 
     WebSocketClient::WebSocketClient()
-        : ping_interval_ms_(5000), auto_reconnect_(true), state_(WsState::DISCONNECTED), running_(false), should_stop_(false)
+        : ping_interval_ms_(5000), auto_reconnect_(true), state_(WsState::DISCONNECTED), running_(false)
     {
     }
 
@@ -42,6 +42,11 @@ namespace polymarket
         on_message_cb_ = std::move(callback);
     }
 
+    void WebSocketClient::on_message_view(OnMessageViewCallback callback)
+    {
+        on_message_view_cb_ = std::move(callback);
+    }
+
     void WebSocketClient::on_connect(OnConnectCallback callback)
     {
         on_connect_cb_ = std::move(callback);
@@ -75,6 +80,8 @@ namespace polymarket
                 {
                     on_connect_cb_();
                 }
+                // Wake waiters only after subscriptions sent from on_connect are out
+                notify_lifecycle();
                 break;
 
             case ix::WebSocketMessageType::Close:
@@ -83,6 +90,7 @@ namespace polymarket
                 {
                     on_disconnect_cb_();
                 }
+                notify_lifecycle();
                 break;
 
             case ix::WebSocketMessageType::Error:
@@ -91,11 +99,16 @@ namespace polymarket
                 {
                     on_error_cb_(msg->errorInfo.reason);
                 }
+                notify_lifecycle();
                 break;
 
             case ix::WebSocketMessageType::Message:
                 messages_received_++;
                 bytes_received_ += msg->str.size();
+                if (on_message_view_cb_)
+                {
+                    on_message_view_cb_(WsMessage(msg->str));
+                }
                 if (on_message_cb_)
                 {
                     on_message_cb_(msg->str);
@@ -109,6 +122,12 @@ namespace polymarket
                 break;
             } });
 
+        {
+            // A new session: only a stop() issued from here on ends it, an earlier one does not
+            std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+            session_generation_ = stop_generation_;
+        }
+
         state_.store(WsState::CONNECTING);
         ws_.start();
 
@@ -143,32 +162,51 @@ namespace polymarket
         return result.success;
     }
 
+    void WebSocketClient::notify_lifecycle()
+    {
+        // Taking the lock orders the state change before a waiter re-checks its predicate
+        {
+            std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+        }
+        lifecycle_cv_.notify_all();
+    }
+
+    bool WebSocketClient::wait_until_connected(std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(lifecycle_mutex_);
+        lifecycle_cv_.wait_for(lock, timeout, [this]()
+                               { return state_.load() == WsState::CONNECTED || stop_generation_ != session_generation_; });
+        return is_connected();
+    }
+
     void WebSocketClient::run()
     {
+        std::unique_lock<std::mutex> lock(lifecycle_mutex_);
         running_.store(true);
-        should_stop_.store(false);
 
-        // IXWebSocket runs in its own thread, so we just wait here
-        while (!should_stop_.load())
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
+        // IXWebSocket runs in its own thread, so we just park here until stop()
+        lifecycle_cv_.wait(lock, [this]()
+                           { return stop_generation_ != session_generation_; });
 
         running_.store(false);
+        lock.unlock();
+        lifecycle_cv_.notify_all();
     }
 
     void WebSocketClient::stop()
     {
-        should_stop_.store(true);
+        {
+            std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+            stop_generation_++;
+        }
+        lifecycle_cv_.notify_all();
+
         disconnect();
 
         // Wait for run loop to exit
-        int wait_count = 0;
-        while (running_.load() && wait_count < 100)
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            wait_count++;
-        }
+        std::unique_lock<std::mutex> lock(lifecycle_mutex_);
+        lifecycle_cv_.wait_for(lock, std::chrono::seconds(1), [this]()
+                               { return !running_.load(); });
     }
 
 } // namespace polymarket
@@ -0,0 +1,137 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "backtester.hpp"
+#include "arb_executor.hpp"
+#include <cassert>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+using namespace polymarket;
+
+namespace
+{
+    constexpr uint64_t MS = 1000000ULL;
+    constexpr uint64_t DAY = 86400000ULL * MS;
+    constexpr uint64_t DAY1 = 19700ULL * DAY; // Some UTC midnight
+    constexpr uint64_t T = DAY1 + 12 * 3600000ULL * MS;
+    constexpr uint64_t T2 = DAY1 + DAY + 3600000ULL * MS;
+
+    bool near(double a, double b) { return std::abs(a - b) < 1e-6; }
+
+    std::string book(const char *token, const char *bid, const char *ask)
+    {
+        return std::string("{\"event_type\":\"book\",\"asset_id\":\"") + token + "\",\"bids\":[{\"price\":\"" + bid +
+               "\",\"size\":\"100\"}],\"asks\":[{\"price\":\"" + ask + "\",\"size\":\"100\"}]}";
+    }
+
+    void line(std::ofstream &out, uint64_t recv_ns, const std::string &message)
+    {
+        out << "{\"recv_ns\":" << recv_ns << ",\"msg\":" << message << "}\n";
+    }
+
+    void market(std::ofstream &out, uint64_t recv_ns, const char *condition_id, const char *yes, const char *no)
+    {
+        out << "{\"recv_ns\":" << recv_ns << ",\"market\":{\"condition_id\":\"" << condition_id << "\",\"token_yes\":\""
+            << yes << "\",\"token_no\":\"" << no << "\",\"slug\":\"" << condition_id << "\"}}\n";
+    }
+
+    BacktestParams params(double latency_ms, double fill_ratio = 1.0)
+    {
+        BacktestParams p;
+        p.trigger_combined = 0.98;
+        p.size_usdc = 9.0; // 18 pairs at 0.45 + 0.50
+        p.latency_ms = latency_ms;
+        p.fill_ratio = fill_ratio;
+        return p;
+    }
+} // namespace
+
+int main()
+{
+    // Shared order pricing: shares floored to cents, limits on the tick plus slippage
+    {
+        ExecutableEdge edge;
+        edge.shares = 18.0;
+        edge.worst_yes = 0.1 + 0.35; // 0.44999999999999996
+        edge.worst_no = 0.5;
+        auto plan = plan_arb_orders(edge, 0.01, 2);
+        assert(near(plan.shares, 18.0) && near(plan.yes_price, 0.47) && near(plan.no_price, 0.52));
+        edge.worst_yes = 0.985;
+        plan = plan_arb_orders(edge, 0.01, 3);
+        assert(near(plan.yes_price, 0.99)); // Capped below 1
+    }
+
+    auto directory = (std::filesystem::temp_directory_path() / ("test_backtester_" + std::to_string(getpid()))).string();
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    auto capture = directory + "/capture.jsonl";
+    {
+        std::ofstream out(capture);
+        market(out, T, "A", "a-yes", "a-no");
+        market(out, T, "B", "b-yes", "b-no");
+        // Day 1: A trades at 0.95 for 200ms, then the NO ask jumps to 0.60
+        line(out, T + 1 * MS, book("a-yes", "0.40", "0.45"));
+        line(out, T + 2 * MS, book("a-no", "0.45", "0.50"));
+        line(out, T + 3 * MS, book("b-yes", "0.45", "0.50"));
+        line(out, T + 4 * MS, book("b-no", "0.45", "0.50")); // B never clears the trigger
+        line(out, T + 200 * MS, book("a-no", "0.45", "0.60"));
+        line(out, T + 400 * MS, book("a-yes", "0.40", "0.55"));
+        // Day 2: A at 0.90 once more
+        line(out, T2, book("a-yes", "0.35", "0.40"));
+        line(out, T2 + 1 * MS, book("a-no", "0.45", "0.50"));
+        line(out, T2 + 500 * MS, book("a-no", "0.45", "0.70"));
+    }
+
+    // One unit per market-day with feed events
+    auto units = Backtester::plan({capture});
+    assert(units.size() == 3);
+    size_t a_days = 0;
+    for (const auto &unit : units)
+    {
+        a_days += unit.market.condition_id == "A";
+        assert(unit.day_end_ns - unit.day_start_ns == DAY && unit.feed_mode == FeedMode::CLOB);
+    }
+    assert(a_days == 2);
+
+    BacktestOptions options;
+    options.keep_trades = true;
+    Backtester backtester({params(0), params(100), params(300), params(0, 0.1)}, options);
+    auto results = backtester.run(units);
+    assert(results.size() == 4);
+
+    // No latency: both signals fill in full at the signalled prices, capture exactly 1
+    const auto &instant = results[0];
+    assert(instant.units == 3 && instant.signals == 2 && instant.trades == 2 && instant.full_fills == 2);
+    assert(near(instant.fill_rate(), 1.0) && near(instant.pairs, 36.0));
+    assert(near(instant.locked_pnl, 18 * 0.05 + 18 * 0.10) && near(instant.residual_pnl, 0.0));
+    assert(near(instant.capture_quantile(0.0), 1.0) && near(instant.capture_quantile(1.0), 1.0));
+    assert(instant.trade_log.size() == 2 && instant.trade_log[0].signal_ns == T + 2 * MS);
+
+    // 100ms: still ahead of both moves
+    assert(near(results[1].pnl(), instant.pnl()) && results[1].full_fills == 2);
+
+    // 300ms: day 1's NO ask moved past the limit; the YES leg is left unhedged and marked at
+    // its last bid (0.40 against 0.45 paid). Day 2 still fills.
+    const auto &slow = results[2];
+    assert(slow.trades == 2 && slow.full_fills == 1 && slow.missed == 0);
+    assert(near(slow.fill_rate(), (18.0 + 36.0) / 72.0));
+    assert(near(slow.residual_pnl, 18 * (0.40 - 0.45)) && near(slow.locked_pnl, 18 * 0.10));
+    assert(near(slow.capture_quantile(0.0), -1.0) && near(slow.capture_quantile(1.0), 1.0));
+
+    // Partial fills: a tenth of each 100-share level is ours
+    const auto &partial = results[3];
+    assert(near(partial.pairs, 20.0) && near(partial.fill_rate(), 40.0 / 72.0) && partial.full_fills == 0);
+    assert(near(partial.locked_pnl, 10 * 0.05 + 10 * 0.10));
+
+    // Results do not depend on how units were spread over workers
+    BacktestOptions parallel;
+    parallel.workers = 3;
+    auto again = Backtester({params(300)}, parallel).run(units);
+    assert(again[0].trades == slow.trades && near(again[0].pnl(), slow.pnl()) && near(again[0].filled_shares, slow.filled_shares));
+
+    std::filesystem::remove_all(directory);
+    std::cout << "test_backtester passed\n";
+    return 0;
+}
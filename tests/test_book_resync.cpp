@@ -0,0 +1,202 @@
+// Stale detection and REST resync: a local HTTP server stands in for the CLOB /books endpoint
+// and records every batch the manager requests.
+#undef NDEBUG // keep asserts active in Release builds
+#include "orderbook.hpp"
+#include "clob_client.hpp"
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <string>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace polymarket;
+
+namespace
+{
+    std::mutex g_requests_mutex;
+    std::vector<std::string> g_requests; // Request paths, in arrival order
+    std::atomic<bool> g_fail{false};     // Answer 500 instead of books
+
+    std::vector<std::string> requests()
+    {
+        std::lock_guard<std::mutex> lock(g_requests_mutex);
+        return g_requests;
+    }
+
+    // [{"asset_id": "11", ...}, ...] for every id in /books?token_ids=11,22
+    std::string books_body(const std::string &path)
+    {
+        std::string ids = path.substr(path.find("token_ids=") + 10);
+        std::string body = "[";
+        size_t start = 0;
+        while (start <= ids.size())
+        {
+            size_t end = ids.find(',', start);
+            end = end == std::string::npos ? ids.size() : end;
+            if (body.size() > 1)
+                body += ",";
+            body += R"({"asset_id": ")" + ids.substr(start, end - start) +
+                    R"(", "bids": [{"price": "0.29", "size": "5"}], "asks": [{"price": "0.30", "size": "5"}]})";
+            start = end + 1;
+        }
+        return body + "]";
+    }
+
+    void serve_connection(int fd)
+    {
+        std::string buffer;
+        char chunk[4096];
+        while (true)
+        {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0)
+                break;
+            buffer.append(chunk, static_cast<size_t>(n));
+
+            size_t end;
+            while ((end = buffer.find("\r\n\r\n")) != std::string::npos)
+            {
+                std::string head = buffer.substr(0, end);
+                buffer.erase(0, end + 4);
+                std::string path = head.substr(4, head.find(' ', 4) - 4); // "GET <path> HTTP/1.1"
+                {
+                    std::lock_guard<std::mutex> lock(g_requests_mutex);
+                    g_requests.push_back(path);
+                }
+
+                bool fail = g_fail.load();
+                std::string body = fail ? "{}" : books_body(path);
+                std::string reply = std::string(fail ? "HTTP/1.1 500 Internal Server Error" : "HTTP/1.1 200 OK") +
+                                    "\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) +
+                                    "\r\nConnection: keep-alive\r\n\r\n" + body;
+                send(fd, reply.data(), reply.size(), 0);
+            }
+        }
+        close(fd);
+    }
+
+    std::string book_message(const std::string &asset_id, const char *ask, const char *timestamp)
+    {
+        return R"({"event_type": "book", "market": "0xc", "asset_id": ")" + asset_id +
+               R"(", "timestamp": ")" + timestamp + R"(", "bids": [], "asks": [{"price": ")" + ask + R"(", "size": "10"}]})";
+    }
+
+    template <typename Predicate>
+    bool eventually(Predicate predicate, int timeout_ms = 5000)
+    {
+        for (int i = 0; i < timeout_ms && !predicate(); i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return predicate();
+    }
+
+    bool resynced(const OrderbookManager &manager, const std::string &token)
+    {
+        auto book = manager.get_orderbook(token);
+        return book && std::fabs(book->best_ask() - 0.30) < 1e-9;
+    }
+} // namespace
+
+int main()
+{
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    assert(listener >= 0);
+    int one = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    assert(bind(listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+    assert(listen(listener, 16) == 0);
+    socklen_t addr_len = sizeof(addr);
+    assert(getsockname(listener, reinterpret_cast<sockaddr *>(&addr), &addr_len) == 0);
+    int port = ntohs(addr.sin_port);
+
+    std::thread server([listener]()
+                       {
+        while (true)
+        {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd < 0)
+                break;
+            std::thread(serve_connection, fd).detach();
+        } });
+    server.detach();
+
+    ClobClient rest("http://127.0.0.1:" + std::to_string(port));
+
+    Config config;
+    config.feed_mode = FeedMode::CLOB;
+    config.clob_ws_url = "ws://127.0.0.1:9"; // Nothing listens; books come from inject_message
+    config.resync_interval_ms = 20;
+    config.book_max_silence_ms = 5000;
+
+    MarketState market;
+    market.condition_id = "0xc";
+    market.slug = "test";
+    market.token_yes = "11";
+    market.token_no = "22";
+
+    // Time is ours: books are stamped, and silence measured, on this clock
+    std::atomic<uint64_t> now{1000ULL * 1000000000ULL};
+    OrderbookManager manager(config);
+    manager.set_clock([&now]()
+                      { return now.load(); });
+    manager.subscribe(market);
+    manager.set_resync_client(&rest);
+    manager.connect();
+
+    manager.inject_message(FeedSource::CLOB, book_message("11", "0.40", "2000"));
+    manager.inject_message(FeedSource::CLOB, book_message("22", "0.50", "2000"));
+    assert(manager.get_orderbook("11") && manager.get_orderbook("22"));
+
+    // A message that fails to parse takes down every token it names; both come back from one
+    // batched REST call
+    manager.inject_message(FeedSource::CLOB, R"({"event_type":"book","asset_id":"11","x":{"asset_id":"22",)");
+    assert(manager.gaps_detected() == 2);
+    assert(eventually([&manager]
+                      { return resynced(manager, "11") && resynced(manager, "22"); }));
+    assert(manager.books_resynced() == 2);
+    auto seen = requests();
+    assert(seen.size() == 1 && seen[0] == "/books?token_ids=11,22");
+
+    // A delta older than the stored book means one was missed
+    manager.inject_message(FeedSource::CLOB, book_message("11", "0.41", "3000"));
+    manager.inject_message(FeedSource::CLOB,
+                           R"({"event_type": "price_change", "asset_id": "11", "timestamp": "2500", "changes": [{"price": "0.42", "size": "1", "side": "SELL"}]})");
+    assert(manager.gaps_detected() == 3);
+    assert(eventually([&manager]
+                      { return manager.books_resynced() == 3; }));
+    assert(resynced(manager, "11"));
+
+    // Books silent for longer than book_max_silence_ms go stale on the next silence check
+    now += 6000ULL * 1000000ULL;
+    assert(eventually([&manager]
+                      { return manager.gaps_detected() == 5 && manager.books_resynced() == 5; }));
+    assert(resynced(manager, "11") && resynced(manager, "22"));
+
+    // Failing resyncs back off; stop() still returns without waiting the backoff out
+    g_fail = true;
+    size_t before = requests().size();
+    manager.inject_message(FeedSource::CLOB, R"({"event_type":"book","asset_id":"22","asks":[)");
+    assert(!manager.get_orderbook("22"));
+    assert(eventually([&before]
+                      { return requests().size() >= before + 6; }, 10000)); // Backoff now over a second
+    auto stop_started = std::chrono::steady_clock::now();
+    manager.stop();
+    auto stop_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - stop_started).count();
+    assert(stop_ms < 500);
+
+    std::cout << "test_book_resync passed (stop took " << stop_ms << "ms during backoff)\n";
+    return 0;
+}
@@ -0,0 +1,59 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "orderbook.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+using namespace polymarket;
+
+namespace
+{
+    bool near(double a, double b) { return std::fabs(a - b) < 1e-9; }
+
+    AskLadder ladder(const std::vector<PriceLevel> &asks)
+    {
+        AskLadder result;
+        result.assign(asks);
+        return result;
+    }
+} // namespace
+
+int main()
+{
+    // Top of book 0.45 + 0.50 = 0.95, but only 10 pairs there
+    auto yes = ladder({{0.45, 10}, {0.48, 20}, {0.55, 100}});
+    auto no = ladder({{0.50, 30}, {0.52, 100}});
+
+    {
+        // Budget binds first: $10 per leg is 20 NO @ 0.50 (YES costs 10 @ 0.45 + 10 @ 0.48)
+        auto edge = OrderbookManager::executable_edge(yes, no, 10.0, 0.98);
+        assert(near(edge.shares, 20.0));
+        assert(near(edge.cost, 10 * 0.95 + 10 * 0.98));
+        assert(near(edge.edge, 20.0 - edge.cost) && near(edge.avg_combined, edge.cost / 20.0));
+        assert(edge.worst_yes == 0.48 && edge.worst_no == 0.50);
+    }
+
+    {
+        // Trigger binds: 10 pairs @ 0.95 and 20 @ 0.98 cost 29.1; then pairs @ 1.07 until
+        // (29.1 + 1.07 q) / (30 + q) = 0.98, i.e. q = 10 / 3
+        auto edge = OrderbookManager::executable_edge(yes, no, 1000.0, 0.98);
+        assert(near(edge.max_shares, 30.0 + 10.0 / 3));
+        assert(near(edge.shares, edge.max_shares) && near(edge.avg_combined, 0.98));
+        assert(edge.worst_yes == 0.55 && edge.worst_no == 0.52);
+    }
+
+    {
+        // Top of book already above the trigger: nothing executable
+        auto edge = OrderbookManager::executable_edge(ladder({{0.50, 10}}), ladder({{0.49, 10}}), 100.0, 0.98);
+        assert(edge.shares == 0.0 && edge.max_shares == 0.0 && edge.edge == 0.0);
+    }
+
+    {
+        // Liquidity runs out before budget or trigger
+        auto edge = OrderbookManager::executable_edge(ladder({{0.40, 5}}), ladder({{0.50, 8}}), 100.0, 0.98);
+        assert(near(edge.shares, 5.0) && near(edge.max_shares, 5.0) && near(edge.edge, 5 * 0.10));
+    }
+
+    std::cout << "test_executable_edge passed\n";
+    return 0;
+}
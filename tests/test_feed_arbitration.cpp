@@ -0,0 +1,101 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "orderbook.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+using namespace polymarket;
+
+namespace
+{
+    bool near(double a, double b) { return std::fabs(a - b) < 1e-9; }
+
+    std::string clob_book(const std::string &asset_id, const char *ask, const char *timestamp = nullptr)
+    {
+        std::string message = R"({"event_type": "book", "market": "0xc", "asset_id": ")" + asset_id +
+                              R"(", "bids": [], "asks": [{"price": ")" + ask + R"(", "size": "10"}])";
+        if (timestamp)
+        {
+            message += std::string(R"(, "timestamp": ")") + timestamp + "\"";
+        }
+        return message + "}";
+    }
+
+    std::string rtds_book(const std::string &asset_id, const char *ask, const char *timestamp = nullptr)
+    {
+        std::string payload = R"({"asset_id": ")" + asset_id + R"(", "bids": [], "asks": [{"price": ")" + ask +
+                              R"(", "size": "10"}])";
+        if (timestamp)
+        {
+            payload += std::string(R"(, "timestamp": ")") + timestamp + "\"";
+        }
+        return R"({"topic": "clob_market", "type": "agg_orderbook", "payload": )" + payload + "}}";
+    }
+
+    double best_ask(const OrderbookManager &manager, const std::string &token)
+    {
+        auto book = manager.get_orderbook(token);
+        assert(book.has_value());
+        return book->best_ask();
+    }
+} // namespace
+
+int main()
+{
+    Config config;
+    config.feed_mode = FeedMode::ARBITRATED;
+
+    MarketState market;
+    market.condition_id = "0xc";
+    market.slug = "test";
+    market.token_yes = "11";
+    market.token_no = "22";
+
+    OrderbookManager manager(config);
+    manager.subscribe(market);
+
+    // The second feed's copy of a book is dropped
+    manager.inject_message(FeedSource::CLOB, clob_book("11", "0.45", "1000"));
+    manager.inject_message(FeedSource::RTDS, rtds_book("11", "0.45", "1000"));
+    assert(manager.feed_stats(FeedSource::CLOB).wins == 1 && manager.feed_stats(FeedSource::RTDS).duplicates == 1);
+
+    // One feed reverting to earlier levels: every step is applied
+    manager.inject_message(FeedSource::CLOB, clob_book("11", "0.46", "1001"));
+    manager.inject_message(FeedSource::CLOB, clob_book("11", "0.45", "1002"));
+    assert(near(best_ask(manager, "11"), 0.45));
+    assert(manager.feed_stats(FeedSource::CLOB).wins == 3);
+
+    // The other feed's copy of the revert is still a duplicate; an older one is stale
+    manager.inject_message(FeedSource::RTDS, rtds_book("11", "0.45", "1002"));
+    manager.inject_message(FeedSource::RTDS, rtds_book("11", "0.46", "1001"));
+    auto rtds = manager.feed_stats(FeedSource::RTDS);
+    assert(rtds.duplicates == 2 && rtds.stale == 1 && rtds.wins == 0);
+    assert(near(best_ask(manager, "11"), 0.45));
+
+    // Without exchange timestamps a revert is still applied
+    manager.inject_message(FeedSource::CLOB, clob_book("22", "0.45"));
+    manager.inject_message(FeedSource::CLOB, clob_book("22", "0.46"));
+    manager.inject_message(FeedSource::CLOB, clob_book("22", "0.45"));
+    assert(near(best_ask(manager, "22"), 0.45));
+    manager.inject_message(FeedSource::RTDS, rtds_book("22", "0.45"));
+    assert(manager.feed_stats(FeedSource::RTDS).duplicates == 3);
+
+    // Receive times out of order (taken before the shard lock): no negative lag sample
+    OrderbookManager clocked(config);
+    clocked.subscribe(market);
+    uint64_t now = 5000000000ULL;
+    clocked.set_clock([&now]
+                      { return now; });
+    clocked.inject_message(FeedSource::CLOB, clob_book("11", "0.45", "1000"));
+    now -= 2000000;
+    clocked.inject_message(FeedSource::RTDS, rtds_book("11", "0.45", "1000"));
+    assert(clocked.feed_stats(FeedSource::RTDS).duplicates == 1 && clocked.feed_stats(FeedSource::RTDS).avg_lag_ms == 0.0);
+    now += 5000000;
+    clocked.inject_message(FeedSource::CLOB, clob_book("11", "0.46", "1001"));
+    now += 3000000;
+    clocked.inject_message(FeedSource::RTDS, rtds_book("11", "0.46", "1001"));
+    assert(near(clocked.feed_stats(FeedSource::RTDS).avg_lag_ms, 3.0));
+
+    std::cout << "test_feed_arbitration passed\n";
+    return 0;
+}
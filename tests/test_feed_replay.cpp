@@ -0,0 +1,209 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "feed_replay.hpp"
+#include "orderbook.hpp"
+#include <nlohmann/json.hpp>
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+using namespace polymarket;
+
+namespace
+{
+    constexpr uint64_t T0 = 1700000000000000000ULL;
+    constexpr int MESSAGES = 400;
+
+    MarketState test_market()
+    {
+        MarketState market;
+        market.condition_id = "0xreplay";
+        market.slug = "btc-updown-15m-replay";
+        market.token_yes = "1001";
+        market.token_no = "1002";
+        return market;
+    }
+
+    // Alternating YES/NO books; every 50th pair sums below the trigger
+    std::string book_message(int i)
+    {
+        bool yes = i % 2 == 0;
+        bool cheap = (i / 2) % 50 == 49;
+        std::string ask = cheap ? "0.47" : "0.5" + std::to_string(i % 10);
+        return "{\"event_type\":\"book\",\"market\":\"0xreplay\",\"asset_id\":\"" + std::string(yes ? "1001" : "1002") +
+               "\",\"bids\":[{\"price\":\"0.40\",\"size\":\"100\"}],\"asks\":[{\"price\":\"" + ask +
+               "\",\"size\":\"" + std::to_string(100 + i) + "\"}]}";
+    }
+
+    struct Outcome
+    {
+        uint64_t updates = 0;
+        uint64_t arbs = 0;
+        std::vector<uint64_t> arb_book_ns;
+        Orderbook yes, no;
+    };
+
+    Outcome outcome(OrderbookManager &manager, const std::vector<uint64_t> &arb_book_ns)
+    {
+        Outcome result;
+        result.updates = manager.total_updates();
+        result.arbs = manager.arb_opportunities();
+        result.arb_book_ns = arb_book_ns;
+        result.yes = manager.get_orderbook("1001").value();
+        result.no = manager.get_orderbook("1002").value();
+        return result;
+    }
+
+    bool same_book(const Orderbook &a, const Orderbook &b)
+    {
+        return a.timestamp_ns == b.timestamp_ns && a.asks.size() == b.asks.size() && a.asks[0].price == b.asks[0].price &&
+               a.asks[0].size == b.asks[0].size && a.bids[0].price == b.bids[0].price;
+    }
+
+    Outcome replay_into_manager(const std::string &path, const Config &config, ReplayStats *stats_out = nullptr)
+    {
+        ReplaySource source;
+        assert(source.open(path));
+        OrderbookManager manager(config);
+        std::vector<uint64_t> arb_book_ns;
+        manager.on_arb_opportunity([&arb_book_ns](const ArbSignal &signal)
+                                   { arb_book_ns.push_back(signal.book_ns); });
+        FeedReplay replay;
+        auto stats = replay.run(source, manager);
+        if (stats_out)
+            *stats_out = stats;
+        return outcome(manager, arb_book_ns);
+    }
+} // namespace
+
+int main()
+{
+    auto directory = (std::filesystem::temp_directory_path() / ("test_feed_replay_" + std::to_string(getpid()))).string();
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    Config config;
+    config.feed_mode = FeedMode::CLOB;
+    config.strategy_threads = 0;
+    config.trigger_combined = 0.98;
+
+    // Record a session through the manager (raw journal) on a scripted clock
+    Outcome live;
+    {
+        FeedJournal journal(config);
+        assert(journal.open(directory + "/raw"));
+        OrderbookManager manager(config);
+        uint64_t clock = T0;
+        manager.set_clock([&clock]()
+                          { return clock; });
+        manager.set_journal(&journal);
+        std::vector<uint64_t> arb_book_ns;
+        manager.on_arb_opportunity([&arb_book_ns](const ArbSignal &signal)
+                                   { arb_book_ns.push_back(signal.book_ns); });
+        manager.subscribe(test_market());
+        for (int i = 0; i < MESSAGES; i++)
+        {
+            clock = T0 + uint64_t(i + 1) * 1000000; // 1ms apart
+            manager.inject_message(FeedSource::CLOB, book_message(i));
+        }
+        live = outcome(manager, arb_book_ns);
+        journal.close();
+        assert(live.updates == MESSAGES && live.arbs > 0 && live.yes.timestamp_ns == T0 + (MESSAGES - 1) * 1000000ULL);
+    }
+
+    // Raw journal replay: subscriptions come from the recording; same books, same clock,
+    // same signals at the same recorded times
+    {
+        ReplayStats stats;
+        auto replayed = replay_into_manager(directory + "/raw", config, &stats);
+        assert(stats.markets == 1 && stats.messages == MESSAGES && stats.books == 0 && stats.malformed == 0);
+        assert(stats.first_ns == T0 + 1000000 && stats.last_ns == T0 + MESSAGES * 1000000ULL);
+        assert(replayed.updates == live.updates && replayed.arbs == live.arbs && replayed.arb_book_ns == live.arb_book_ns);
+        assert(same_book(replayed.yes, live.yes) && same_book(replayed.no, live.no));
+
+        ReplaySource source;
+        assert(source.open(directory + "/raw"));
+        auto manifest = source.scan();
+        assert(manifest.events == MESSAGES + 1 && manifest.markets.size() == 1 && manifest.shards == 1);
+        assert(manifest.clob && !manifest.rtds && manifest.markets[0].token_no == "1002");
+    }
+
+    // A books journal replays to the same state without decoding JSON
+    {
+        Config books_config = config;
+        books_config.journal_mode = JournalMode::BOOKS;
+        FeedJournal journal(books_config);
+        assert(journal.open(directory + "/books"));
+        OrderbookManager manager(books_config);
+        uint64_t clock = T0;
+        manager.set_clock([&clock]()
+                          { return clock; });
+        manager.set_journal(&journal);
+        manager.subscribe(test_market());
+        for (int i = 0; i < MESSAGES; i++)
+        {
+            clock = T0 + uint64_t(i + 1) * 1000000;
+            manager.inject_message(FeedSource::CLOB, book_message(i));
+        }
+        journal.close();
+
+        ReplayStats stats;
+        auto replayed = replay_into_manager(directory + "/books", config, &stats);
+        assert(stats.books == MESSAGES && stats.messages == 0 && stats.markets == 1);
+        assert(replayed.arbs == live.arbs && replayed.arb_book_ns == live.arb_book_ns);
+        assert(same_book(replayed.yes, live.yes) && same_book(replayed.no, live.no));
+    }
+
+    // JSONL: wrapped events, a bare message, a malformed line; time range
+    auto jsonl = directory + "/capture.jsonl";
+    {
+        std::ofstream out(jsonl);
+        out << "{\"recv_ns\":" << T0 << ",\"market\":{\"condition_id\":\"0xreplay\",\"token_yes\":\"1001\",\"token_no\":\"1002\",\"slug\":\"jsonl\"}}\n";
+        for (int i = 0; i < 10; i++)
+        {
+            uint64_t recv_ns = T0 + uint64_t(i + 1) * 10000000; // 10ms apart
+            if (i % 2)
+                out << "{\"recv_ns\":" << recv_ns << ",\"source\":\"clob\",\"msg\":" << book_message(i) << "}\n";
+            else
+                out << "{\"recv_ns\":" << recv_ns << ",\"msg\":" << nlohmann::json(book_message(i)).dump() << "}\n";
+        }
+        out << "not json\n\n";
+        out << book_message(10) << "\n"; // Bare: applied at the last recorded time
+    }
+    {
+        ReplayStats stats;
+        auto replayed = replay_into_manager(jsonl, config, &stats);
+        assert(stats.markets == 1 && stats.messages == 11 && stats.malformed == 1);
+        assert(replayed.updates == 11 && replayed.yes.asks[0].size == 110.0 && replayed.yes.timestamp_ns == T0 + 100000000);
+
+        ReplaySource source;
+        assert(source.open(jsonl));
+        OrderbookManager manager(config);
+        ReplayOptions options;
+        options.from_ns = T0 + 30000000;
+        options.until_ns = T0 + 60000000;
+        FeedReplay replay(options);
+        stats = replay.run(source, manager);
+        assert(stats.markets == 1 && stats.messages == 4 && manager.total_updates() == 4);
+        assert(stats.first_ns == T0 + 30000000 && stats.last_ns == T0 + 60000000 && replay.now_ns() == T0 + 60000000);
+    }
+
+    // Original pacing: 100ms recorded at 4x takes about 25ms of wall time
+    {
+        ReplaySource source;
+        assert(source.open(jsonl));
+        OrderbookManager manager(config);
+        ReplayOptions options;
+        options.pacing = ReplayPacing::ORIGINAL;
+        options.speed = 4.0;
+        FeedReplay replay(options);
+        auto stats = replay.run(source, manager);
+        assert(stats.messages == 11 && stats.recorded_sec() > 0.089 && stats.wall_sec >= 0.0225 && stats.wall_sec < 1.0);
+    }
+
+    assert(!ReplaySource().open(directory + "/missing"));
+    std::filesystem::remove_all(directory);
+    std::cout << "test_feed_replay passed\n";
+    return 0;
+}
@@ -0,0 +1,89 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "orderbook.hpp"
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+using namespace polymarket;
+
+namespace
+{
+    bool near(double a, double b) { return std::fabs(a - b) < 1e-9; }
+
+    std::string book_message(const std::string &asset_id, const char *ask)
+    {
+        return R"({"event_type": "book", "asset_id": ")" + asset_id +
+               R"(", "bids": [], "asks": [{"price": ")" + ask + R"(", "size": "10"}]})";
+    }
+} // namespace
+
+int main()
+{
+    // FNV-1a is pinned: a different assignment after a restart would move every market
+    // to another connection
+    const std::string condition = "0x5f65177b394277fd294cd75650044e32ba009a95022d88a0c1d565897d72f8f1";
+    assert(OrderbookManager::shard_for(condition, 8) == 7);
+    assert(OrderbookManager::shard_for(condition, 3) == 0);
+    assert(OrderbookManager::shard_for("0xc", 3) == 2);
+    assert(OrderbookManager::shard_for("", 4) == 3);
+    assert(OrderbookManager::shard_for(condition, 1) == 0 && OrderbookManager::shard_for(condition, 0) == 0);
+
+    // Condition ids spread evenly: 4000 over 8 shards, each within 10% of 500
+    std::array<size_t, 8> counts{};
+    for (unsigned long long i = 0; i < 4000; i++)
+    {
+        char id[80];
+        std::snprintf(id, sizeof(id), "0x%064llx", i * 2654435761ULL);
+        counts[OrderbookManager::shard_for(id, counts.size())]++;
+    }
+    for (size_t count : counts)
+    {
+        assert(count > 450 && count < 550);
+    }
+
+    // Both legs of a market live on the market's shard, so its arb check sees both books
+    Config config;
+    config.feed_mode = FeedMode::CLOB;
+    config.ws_shards = 4;
+    config.trigger_combined = 0.98;
+    OrderbookManager manager(config);
+    assert(manager.shard_count() == 4);
+
+    std::vector<MarketState> markets;
+    for (int i = 0; i < 16; i++)
+    {
+        MarketState market;
+        market.condition_id = "0xm" + std::to_string(i);
+        market.slug = "market-" + std::to_string(i);
+        market.token_yes = "y" + std::to_string(i);
+        market.token_no = "n" + std::to_string(i);
+        markets.push_back(market);
+    }
+    manager.subscribe(markets);
+    assert(manager.subscribed_tokens().size() == 32);
+
+    std::array<size_t, 4> per_shard{};
+    for (const auto &market : markets)
+    {
+        size_t shard = OrderbookManager::shard_for(market.condition_id, manager.shard_count());
+        per_shard[shard]++;
+        manager.inject_message(FeedSource::CLOB, book_message(market.token_yes, "0.45"), shard);
+        manager.inject_message(FeedSource::CLOB, book_message(market.token_no, "0.50"), shard);
+
+        auto yes = manager.get_orderbook(market.token_yes);
+        auto no = manager.get_orderbook(market.token_no);
+        assert(yes && no && near(yes->best_ask(), 0.45) && near(no->best_ask(), 0.50));
+        auto state = manager.get_market(market.condition_id);
+        assert(near(state.best_ask_yes + state.best_ask_no, 0.95));
+    }
+    assert(manager.arb_opportunities() == markets.size());
+    for (size_t count : per_shard)
+    {
+        assert(count == 4); // FNV-1a of "0xm0".."0xm15" happens to split evenly
+    }
+
+    std::cout << "test_feed_sharding passed\n";
+    return 0;
+}
@@ -0,0 +1,110 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "orderbook.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+using namespace polymarket;
+using json = nlohmann::json;
+
+namespace
+{
+    bool near(double a, double b) { return std::fabs(a - b) < 1e-9; }
+
+    std::string book_message(const std::string &asset_id, const char *ask)
+    {
+        return R"({"event_type": "book", "asset_id": ")" + asset_id +
+               R"(", "bids": [], "asks": [{"price": ")" + ask + R"(", "size": "10"}]})";
+    }
+
+    MarketState make_market(const std::string &id)
+    {
+        MarketState market;
+        market.condition_id = "0x" + id;
+        market.slug = "market-" + id;
+        market.token_yes = id + "1";
+        market.token_no = id + "2";
+        return market;
+    }
+
+    bool subscribed(const OrderbookManager &manager, const std::string &token)
+    {
+        auto tokens = manager.subscribed_tokens();
+        return std::count(tokens.begin(), tokens.end(), token) == 1;
+    }
+} // namespace
+
+int main()
+{
+    const std::vector<std::string> tokens = {"11", "22"};
+
+    // CLOB: the handshake names the channel, updates on a live connection name the operation
+    auto handshake = json::parse(OrderbookManager::build_subscription_message(FeedSource::CLOB, tokens, true, true));
+    assert(handshake == json({{"type", "market"}, {"assets_ids", tokens}}));
+    auto add = json::parse(OrderbookManager::build_subscription_message(FeedSource::CLOB, tokens, true, false));
+    assert(add == json({{"assets_ids", tokens}, {"operation", "subscribe"}}));
+    auto remove = json::parse(OrderbookManager::build_subscription_message(FeedSource::CLOB, {"22"}, false, false));
+    assert(remove == json({{"assets_ids", {"22"}}, {"operation", "unsubscribe"}}));
+
+    // RTDS: one shape for both, filters is a JSON array inside a string
+    for (bool subscribe : {true, false})
+    {
+        auto msg = json::parse(OrderbookManager::build_subscription_message(FeedSource::RTDS, tokens, subscribe, false));
+        assert(msg["action"] == (subscribe ? "subscribe" : "unsubscribe"));
+        assert(msg["subscriptions"].size() == 1);
+        const auto &subscription = msg["subscriptions"][0];
+        assert(subscription["topic"] == "clob_market" && subscription["type"] == "agg_orderbook");
+        assert(json::parse(subscription["filters"].get<std::string>()) == json(tokens));
+    }
+    assert(OrderbookManager::build_subscription_message(FeedSource::RTDS, tokens, true, true) ==
+           OrderbookManager::build_subscription_message(FeedSource::RTDS, tokens, true, false));
+
+    Config config;
+    config.feed_mode = FeedMode::CLOB;
+    OrderbookManager manager(config);
+
+    MarketState a = make_market("a");
+    MarketState b = make_market("b");
+    manager.subscribe(a);
+    manager.subscribe(b);
+    manager.subscribe(a); // Repeat is a no-op
+    assert(manager.subscribed_tokens().size() == 4 && subscribed(manager, a.token_yes));
+
+    manager.inject_message(FeedSource::CLOB, book_message(a.token_yes, "0.40"));
+    manager.inject_message(FeedSource::CLOB, book_message(b.token_yes, "0.60"));
+    assert(manager.get_orderbook(a.token_yes) && manager.get_orderbook(b.token_yes));
+
+    // One leg: the token leaves the subscription, its book is dropped and late updates ignored
+    manager.unsubscribe(b.token_yes);
+    assert(manager.subscribed_tokens().size() == 3 && !subscribed(manager, b.token_yes));
+    assert(!manager.get_orderbook(b.token_yes));
+    manager.inject_message(FeedSource::CLOB, book_message(b.token_yes, "0.61"));
+    assert(!manager.get_orderbook(b.token_yes));
+    manager.unsubscribe(b.token_yes); // Unknown token is a no-op
+    assert(manager.subscribed_tokens().size() == 3);
+
+    // Whole market: both legs go, the other market is untouched
+    manager.unsubscribe_market(a.condition_id);
+    assert(manager.subscribed_tokens().size() == 1 && subscribed(manager, b.token_no));
+    assert(!manager.get_orderbook(a.token_yes) && manager.get_market(a.condition_id).condition_id.empty());
+    manager.inject_message(FeedSource::CLOB, book_message(a.token_yes, "0.41"));
+    assert(!manager.get_orderbook(a.token_yes));
+
+    // Resubscribing brings it back from a clean slate, books flow again
+    manager.subscribe(a);
+    assert(manager.subscribed_tokens().size() == 3 && subscribed(manager, a.token_yes) && subscribed(manager, a.token_no));
+    assert(!manager.get_orderbook(a.token_yes));
+    manager.inject_message(FeedSource::CLOB, book_message(a.token_yes, "0.42"));
+    auto book = manager.get_orderbook(a.token_yes);
+    assert(book && near(book->best_ask(), 0.42));
+
+    manager.unsubscribe_all();
+    assert(manager.subscribed_tokens().empty() && !manager.get_orderbook(a.token_yes));
+    manager.subscribe(b);
+    assert(manager.subscribed_tokens().size() == 2);
+
+    std::cout << "test_feed_subscriptions passed\n";
+    return 0;
+}
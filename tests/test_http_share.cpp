@@ -0,0 +1,123 @@
+// Verifies that separate HttpClient instances share one warm connection per host.
+// A local keep-alive HTTP server stands in for Gamma/Data API and counts handshakes (accepts).
+#undef NDEBUG // keep asserts active in Release builds
+#include "http_client.hpp"
+#include <cassert>
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    std::atomic<int> g_accepts{0};
+
+    void serve_connection(int fd)
+    {
+        std::string buffer;
+        char chunk[4096];
+        while (true)
+        {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0)
+                break;
+            buffer.append(chunk, static_cast<size_t>(n));
+
+            // Answer every complete request head (GETs only, no bodies)
+            size_t end;
+            while ((end = buffer.find("\r\n\r\n")) != std::string::npos)
+            {
+                buffer.erase(0, end + 4);
+                static const std::string reply =
+                    "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+                    "Content-Length: 2\r\nConnection: keep-alive\r\n\r\n{}";
+                send(fd, reply.data(), reply.size(), 0);
+            }
+        }
+        close(fd);
+    }
+} // namespace
+
+int main()
+{
+    using namespace polymarket;
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    assert(listener >= 0);
+    int one = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    assert(bind(listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+    assert(listen(listener, 16) == 0);
+
+    socklen_t len = sizeof(addr);
+    getsockname(listener, reinterpret_cast<sockaddr *>(&addr), &len);
+    std::string base_url = "http://127.0.0.1:" + std::to_string(ntohs(addr.sin_port));
+
+    std::vector<std::thread> workers;
+    std::vector<int> client_fds;
+    std::thread acceptor([&]()
+                         {
+        while (true)
+        {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd < 0)
+                break;
+            g_accepts++;
+            client_fds.push_back(fd);
+            workers.emplace_back(serve_connection, fd);
+        } });
+
+    http_global_init();
+
+    {
+        // Two throwaway clients, as MarketFetcher/ClobClient used to create per call
+        HttpClient first;
+        first.set_base_url(base_url);
+        assert(first.get("/events?slug=a").ok());
+        assert(first.get("/events?slug=b").ok());
+
+        HttpClient second;
+        second.set_base_url(base_url);
+        assert(second.get("/positions?user=x").ok());
+
+        auto stats = second.get_stats();
+        assert(stats.new_connections == 0);
+        assert(stats.reused_connections == 1);
+
+        // Registry hands out the same long-lived client per base URL
+        auto shared_a = shared_http_client(base_url);
+        auto shared_b = shared_http_client(base_url + "");
+        assert(shared_a == shared_b);
+        assert(shared_a->get("/").ok());
+    }
+
+    assert(g_accepts.load() == 1);
+
+    http_global_cleanup(); // Releases registry clients
+
+    // The pooled connection stays parked in the share handle; hang up from the server side
+    shutdown(listener, SHUT_RDWR);
+    close(listener);
+    acceptor.join();
+    for (int fd : client_fds)
+    {
+        shutdown(fd, SHUT_RDWR);
+    }
+    for (auto &w : workers)
+    {
+        w.join();
+    }
+
+    std::cout << "test_http_share passed (" << g_accepts.load() << " handshake for "
+              << "2 clients + registry)\n";
+    return 0;
+}
@@ -0,0 +1,172 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "orderbook_impl.hpp"
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+
+using namespace polymarket;
+
+namespace
+{
+    bool near(double a, double b) { return std::fabs(a - b) < 1e-9; }
+
+    // Shared with the test thread; the strategy itself is moved into the manager
+    struct Delivered
+    {
+        std::mutex mutex;
+        std::map<std::string, std::vector<double>> asks; // By token, in delivery order
+        std::atomic<bool> gate_open{true};
+        std::atomic<int> inside{0}; // Strategy thread is holding a book at the gate
+    };
+
+    struct GatedStrategy : StrategyBase
+    {
+        Delivered *delivered;
+
+        void on_book(const std::string &asset_id, const Orderbook &book)
+        {
+            {
+                std::lock_guard<std::mutex> lock(delivered->mutex);
+                delivered->asks[asset_id].push_back(book.best_ask());
+            }
+            delivered->inside++;
+            while (!delivered->gate_open.load())
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            delivered->inside--;
+        }
+    };
+
+    std::string book_message(const std::string &asset_id, const char *ask)
+    {
+        return R"({"event_type": "book", "market": "0xc", "asset_id": ")" + asset_id +
+               R"(", "bids": [], "asks": [{"price": ")" + ask + R"(", "size": "10"}]})";
+    }
+
+    // Fails to parse; the manager marks the tokens it can find stale
+    std::string broken_message(const std::string &asset_id)
+    {
+        return R"({"event_type":"book","asset_id":")" + asset_id + R"(","asks":[)";
+    }
+
+    template <typename Predicate>
+    bool eventually(Predicate predicate)
+    {
+        for (int i = 0; i < 2000 && !predicate(); i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return predicate();
+    }
+
+    std::vector<double> asks_of(Delivered &delivered, const std::string &token)
+    {
+        std::lock_guard<std::mutex> lock(delivered.mutex);
+        return delivered.asks[token];
+    }
+
+    // Park the strategy thread inside on_book for token 11, so later updates queue behind it
+    template <typename Manager>
+    void hold_strategy(Manager &manager, Delivered &delivered, const char *ask)
+    {
+        delivered.gate_open = false;
+        manager.inject_message(FeedSource::CLOB, book_message("11", ask));
+        assert(eventually([&delivered]
+                          { return delivered.inside.load() == 1; }));
+    }
+
+    void release_strategy(Delivered &delivered)
+    {
+        delivered.gate_open = true;
+        assert(eventually([&delivered]
+                          { return delivered.inside.load() == 0; }));
+    }
+} // namespace
+
+int main()
+{
+    Config config;
+    config.feed_mode = FeedMode::CLOB;
+    config.clob_ws_url = "ws://127.0.0.1:9"; // Nothing listens; only the strategy thread matters
+    config.strategy_threads = 1;
+    config.ingress_overflow = OverflowPolicy::CONFLATE;
+
+    MarketState market;
+    market.condition_id = "0xc";
+    market.slug = "test";
+    market.token_yes = "11";
+    market.token_no = "22";
+
+    {
+        Delivered delivered;
+        GatedStrategy strategy;
+        strategy.delivered = &delivered;
+        BasicOrderbookManager<GatedStrategy> manager(config, strategy);
+        manager.subscribe(market);
+        manager.connect();
+
+        // While the strategy is busy, each token keeps only its newest book
+        hold_strategy(manager, delivered, "0.40");
+        manager.inject_message(FeedSource::CLOB, book_message("11", "0.41"));
+        manager.inject_message(FeedSource::CLOB, book_message("11", "0.42"));
+        manager.inject_message(FeedSource::CLOB, book_message("22", "0.50"));
+        manager.inject_message(FeedSource::CLOB, book_message("11", "0.43"));
+        auto stats = manager.ingress_stats();
+        assert(stats.conflated == 2 && stats.enqueued == 3);
+        release_strategy(delivered);
+
+        assert(eventually([&manager]
+                          { return manager.ingress_stats().delivered == 3; }));
+        auto yes = asks_of(delivered, "11");
+        assert(yes.size() == 2 && near(yes[0], 0.40) && near(yes[1], 0.43));
+        assert(asks_of(delivered, "22").size() == 1);
+
+        // A token that goes stale while its conflated book waits is not delivered
+        hold_strategy(manager, delivered, "0.44");
+        manager.inject_message(FeedSource::CLOB, book_message("22", "0.51"));
+        manager.inject_message(FeedSource::CLOB, broken_message("22"));
+        assert(!manager.get_orderbook("22"));
+        release_strategy(delivered);
+        assert(eventually([&manager]
+                          { return manager.ingress_stats().delivered == 4; }));
+        assert(asks_of(delivered, "22").size() == 1 && manager.ingress_stats().withheld == 1);
+
+        // The next full book heals it and flows again
+        manager.inject_message(FeedSource::CLOB, book_message("22", "0.52"));
+        assert(eventually([&delivered]
+                          { return asks_of(delivered, "22").size() == 2; }));
+        assert(near(asks_of(delivered, "22").back(), 0.52));
+        manager.stop();
+    }
+
+    // Without conflation, queued books of a token that went stale are dropped at dispatch
+    config.ingress_overflow = OverflowPolicy::BLOCK;
+    {
+        Delivered delivered;
+        GatedStrategy strategy;
+        strategy.delivered = &delivered;
+        BasicOrderbookManager<GatedStrategy> manager(config, strategy);
+        manager.subscribe(market);
+        manager.connect();
+
+        hold_strategy(manager, delivered, "0.40");
+        manager.inject_message(FeedSource::CLOB, book_message("22", "0.50"));
+        manager.inject_message(FeedSource::CLOB, book_message("22", "0.51"));
+        manager.inject_message(FeedSource::CLOB, book_message("11", "0.41"));
+        manager.inject_message(FeedSource::CLOB, broken_message("22"));
+        release_strategy(delivered);
+
+        assert(eventually([&delivered]
+                          { return asks_of(delivered, "11").size() == 2; }));
+        auto stats = manager.ingress_stats();
+        assert(stats.enqueued == 4 && stats.withheld == 2 && stats.conflated == 0);
+        assert(asks_of(delivered, "22").empty());
+        manager.stop();
+    }
+
+    std::cout << "test_ingress_conflation passed\n";
+    return 0;
+}
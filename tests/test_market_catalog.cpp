@@ -0,0 +1,130 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "market_catalog.hpp"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <thread>
+#include <unistd.h>
+
+using namespace polymarket;
+
+static MarketState make_market(const std::string &id, const std::string &slug, bool neg_risk)
+{
+    MarketState m;
+    m.condition_id = id;
+    m.slug = slug;
+    m.title = "Bitcoin Up or Down";
+    m.symbol = "btc";
+    m.token_yes = id + "-yes";
+    m.token_no = id + "-no";
+    m.neg_risk = neg_risk;
+    m.best_ask_yes = 0.42; // Live state must not be persisted
+    return m;
+}
+
+int main()
+{
+    std::string path = "/tmp/test_market_catalog_" + std::to_string(getpid()) + ".bin";
+
+    {
+        MarketCatalog catalog;
+        assert(!catalog.load(path)); // Missing file is not an error for callers
+        catalog.upsert(make_market("0xccc", "btc-updown-15m-1767170700", true));
+        catalog.upsert(make_market("0xaaa", "btc-updown-15m-1767171600", false));
+        catalog.upsert(make_market("0xaaa", "duplicate", false));
+        assert(catalog.size() == 2);
+        assert(catalog.dirty());
+        assert(catalog.save(path));
+        assert(!catalog.dirty());
+        assert(catalog.size() == 2);
+    }
+
+    {
+        // Warm start: everything served from the mapped file
+        MarketCatalog catalog;
+        assert(catalog.load(path));
+        assert(catalog.size() == 2);
+
+        auto by_slug = catalog.find_by_slug("btc-updown-15m-1767170700");
+        assert(by_slug && by_slug->condition_id == "0xccc");
+        assert(by_slug->token_yes == "0xccc-yes" && by_slug->token_no == "0xccc-no");
+        assert(by_slug->neg_risk && by_slug->symbol == "btc");
+        assert(by_slug->best_ask_yes == 0.0);
+
+        auto by_id = catalog.find_by_condition("0xaaa");
+        assert(by_id && by_id->slug == "btc-updown-15m-1767171600" && !by_id->neg_risk);
+        assert(!catalog.find_by_condition("0xbbb"));
+        assert(!catalog.find_by_slug("eth-updown-15m-1767170700"));
+
+        // Incremental refresh: overlay is visible immediately and merged on save
+        catalog.upsert(make_market("0xbbb", "eth-updown-15m-1767170700", false));
+        assert(catalog.find_by_slug("eth-updown-15m-1767170700"));
+        assert(catalog.save(path));
+    }
+
+    {
+        MarketCatalog catalog;
+        assert(catalog.load(path));
+        assert(catalog.size() == 3);
+        assert(catalog.find_by_condition("0xbbb"));
+        assert(catalog.find_by_slug("btc-updown-15m-1767171600"));
+    }
+
+    {
+        // Concurrent saves (auto-save thread plus an explicit save) leave one complete file
+        MarketCatalog catalog;
+        assert(catalog.load(path));
+        catalog.start_auto_save(path, 1);
+        std::thread writer([&catalog, &path]()
+                           {
+            for (int i = 0; i < 50; i++)
+            {
+                catalog.upsert(make_market("0xw" + std::to_string(i), "writer-" + std::to_string(i), false));
+                assert(catalog.save(path));
+            } });
+        for (int i = 0; i < 50; i++)
+        {
+            catalog.upsert(make_market("0xm" + std::to_string(i), "main-" + std::to_string(i), false));
+            assert(catalog.save(path));
+        }
+        writer.join();
+        catalog.stop_auto_save();
+
+        MarketCatalog reloaded;
+        assert(reloaded.load(path));
+        assert(reloaded.size() == 103);
+    }
+
+    {
+        // An offset near 2^64 must not wrap past the size check
+        std::string bytes;
+        {
+            std::ifstream in(path, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        CatalogHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        header.strings_offset = std::numeric_limits<uint64_t>::max() - 7;
+        std::memcpy(bytes.data(), &header, sizeof(header));
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+
+        MarketCatalog catalog;
+        assert(!catalog.load(path));
+    }
+
+    {
+        // Corrupt files are rejected instead of being mapped
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << "not a catalog, just some bytes here";
+        MarketCatalog catalog;
+        assert(!catalog.load(path));
+        assert(catalog.size() == 0);
+    }
+
+    std::remove(path.c_str());
+    std::cout << "test_market_catalog passed\n";
+    return 0;
+}
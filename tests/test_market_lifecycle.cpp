@@ -0,0 +1,213 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "market_lifecycle.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <set>
+#include <thread>
+
+using namespace polymarket;
+
+namespace
+{
+    MarketState make_window(const std::string &symbol, uint64_t start_sec, const std::string &timeframe = "15m")
+    {
+        MarketState market;
+        market.symbol = symbol;
+        market.slug = symbol + "-updown-" + timeframe + "-" + std::to_string(start_sec);
+        market.condition_id = "0x" + symbol + std::to_string(start_sec);
+        market.token_yes = market.condition_id + "-yes";
+        market.token_no = market.condition_id + "-no";
+        return market;
+    }
+} // namespace
+
+int main()
+{
+    // Expiry from the slug: trailing start seconds plus the window length
+    assert(MarketLifecycle::window_expiry_ms("btc-updown-15m-1767170700", "15m") == (1767170700ULL + 900) * 1000);
+    assert(MarketLifecycle::window_expiry_ms("eth-updown-4h-1767170700", "4h") == (1767170700ULL + 14400) * 1000);
+    assert(MarketLifecycle::window_expiry_ms("no-window-here", "15m") == 0);
+    assert(MarketLifecycle::window_expiry_ms("btc-updown-15m-17671707", "15m") == 0);
+
+    // Hourly slugs name the hour in ET: the current one closes within the next hour
+    {
+        time_t et_now = static_cast<time_t>(now_sec()) - 5 * 3600;
+        struct tm et;
+        gmtime_r(&et_now, &et);
+        static const char *months[] = {"january", "february", "march", "april", "may", "june",
+                                       "july", "august", "september", "october", "november", "december"};
+        int hour12 = et.tm_hour % 12 == 0 ? 12 : et.tm_hour % 12;
+        std::string slug = std::string("bitcoin-up-or-down-") + months[et.tm_mon] + "-" + std::to_string(et.tm_mday) +
+                           "-" + std::to_string(hour12) + (et.tm_hour < 12 ? "am" : "pm") + "-et";
+        uint64_t expiry = MarketLifecycle::window_expiry_ms(slug, "1h");
+        uint64_t now_ms = now_sec() * 1000;
+        assert(expiry > now_ms && expiry <= now_ms + 3600 * 1000);
+    }
+
+    Config config;
+    config.market_min_time_left_sec = 120;
+    config.market_expire_lead_sec = 60;
+    config.market_discover_lead_sec = 600;
+    config.market_discover_retry_sec = 30;
+    config.market_presubscribe_sec = 300;
+    MarketLifecycle lifecycle(config);
+
+    std::set<std::string> subscribed;
+    int subscribe_batches = 0;
+    int sol_attempts = 0;
+    std::set<std::string> warm;
+    std::vector<std::string> discoveries;
+    lifecycle.on_prefetch([&sol_attempts](MarketSession &session)
+                          {
+        if (session.market.symbol == "sol" && ++sol_attempts == 1)
+            return false; // Fails first, retried on the next advance
+        session.tick_size = "0.001";
+        session.order_yes.token_id = session.market.token_yes;
+        return true; });
+    lifecycle.on_subscribe([&subscribed, &subscribe_batches](const std::vector<MarketState> &batch)
+                           {
+        subscribe_batches++;
+        for (const auto &m : batch)
+            subscribed.insert(m.condition_id); });
+    lifecycle.on_unsubscribe([&subscribed](const std::vector<std::string> &condition_ids)
+                             {
+        for (const auto &id : condition_ids)
+            subscribed.erase(id); });
+    lifecycle.on_warm_check([&warm](const MarketSession &session)
+                            { return warm.count(session.market.condition_id) > 0; });
+    lifecycle.on_successor_needed([&discoveries](const std::string &timeframe)
+                                  { discoveries.push_back(timeframe); });
+
+    auto phase = [&lifecycle](const MarketState &market)
+    {
+        auto session = lifecycle.session(market.condition_id);
+        return session ? session->phase : MarketPhase::EXPIRED;
+    };
+
+    const uint64_t t0 = 1767170700ULL; // Window boundary
+    auto at = [t0](uint64_t offset_sec)
+    { return (t0 + offset_sec) * 1000; };
+
+    // Two tickers' current windows, btc's successor, one closing too soon, a duplicate
+    auto btc = make_window("btc", t0);
+    auto btc_next = make_window("btc", t0 + 900);
+    auto eth = make_window("eth", t0);
+    auto late = make_window("xrp", t0 - 900 + 60); // Closes in 60s
+    assert(lifecycle.add({btc, btc_next, eth, late, btc}, "15m", at(60)) == 3);
+    auto sol = make_window("sol", t0, "4h");
+    assert(lifecycle.add({sol}, "4h", at(60)) == 1);
+    assert(lifecycle.size() == 4 && lifecycle.counts().pending == 4);
+    assert(lifecycle.session(btc.condition_id)->expiry_ms == at(900));
+    assert(lifecycle.session(btc_next.condition_id)->start_ms == at(900));
+
+    // Advance 1: prefetch (sol fails); advance 2: one subscribe batch for the windows already
+    // open. btc's successor stays prefetched until 5 minutes before it starts.
+    lifecycle.advance(at(60));
+    assert(phase(btc) == MarketPhase::PREFETCHED && phase(sol) == MarketPhase::PENDING);
+    assert(lifecycle.session(btc.condition_id)->tick_size == "0.001");
+    assert(lifecycle.session(btc.condition_id)->order_yes.token_id == btc.token_yes);
+    lifecycle.advance(at(60));
+    assert(subscribe_batches == 1 && subscribed.size() == 2);
+    assert(subscribed.count(btc.condition_id) && subscribed.count(eth.condition_id));
+    assert(phase(btc_next) == MarketPhase::PREFETCHED && phase(sol) == MarketPhase::PREFETCHED);
+    assert(!lifecycle.tradable(btc.condition_id));
+
+    // Books arrive: the warm heads of their series start trading
+    warm.insert(btc.condition_id);
+    warm.insert(eth.condition_id);
+    lifecycle.advance(at(61));
+    assert(lifecycle.tradable(btc.condition_id) && lifecycle.tradable(eth.condition_id));
+    assert(subscribed.count(sol.condition_id)); // The retried prefetch got through
+    assert(discoveries.empty());
+
+    // 10 minutes before close, eth has no successor: discovery is asked for, then retried
+    lifecycle.advance(at(300));
+    assert(discoveries.size() == 1 && discoveries[0] == "15m");
+    lifecycle.advance(at(330));
+    assert(discoveries.size() == 2);
+    auto eth_next = make_window("eth", t0 + 900);
+    assert(lifecycle.add({eth_next}, "15m", at(331)) == 1);
+    lifecycle.advance(at(360));
+    lifecycle.advance(at(400));
+    assert(discoveries.size() == 2);
+
+    // 5 minutes before the successors start they are subscribed and warmed, on standby
+    lifecycle.advance(at(600));
+    assert(subscribed.count(btc_next.condition_id) && subscribed.count(eth_next.condition_id));
+    warm.insert(btc_next.condition_id);
+    warm.insert(eth_next.condition_id);
+    lifecycle.advance(at(601));
+    assert(phase(btc_next) == MarketPhase::WARM && !lifecycle.tradable(btc_next.condition_id));
+    assert(lifecycle.counts().warm == 2 && lifecycle.counts().trading == 2);
+
+    // Sessions come out ordered by expiry
+    auto sessions = lifecycle.sessions();
+    assert(sessions.front().expiry_ms == at(900) && sessions.back().market.symbol == "sol");
+
+    // 60s before the current windows close they are unsubscribed and the successors trade
+    // from the same advance
+    lifecycle.advance(at(839));
+    assert(lifecycle.tradable(btc.condition_id) && !lifecycle.tradable(btc_next.condition_id));
+    lifecycle.advance(at(840));
+    assert(!lifecycle.session(btc.condition_id) && !lifecycle.session(eth.condition_id));
+    assert(lifecycle.tradable(btc_next.condition_id) && lifecycle.tradable(eth_next.condition_id));
+    assert(!subscribed.count(btc.condition_id) && !subscribed.count(eth.condition_id));
+    auto counts = lifecycle.counts();
+    assert(counts.expired_total == 2 && counts.rollovers_total == 2 && lifecycle.size() == 3);
+
+    // Markets without a window never expire; everything else does, timers included
+    MarketState event_leg;
+    event_leg.condition_id = "0xevent";
+    event_leg.slug = "who-wins";
+    assert(lifecycle.add({event_leg}, "", at(840)) == 1);
+    warm.insert(event_leg.condition_id);
+    for (int i = 0; i < 3; i++)
+        lifecycle.advance(at(841)); // Prefetch, subscribe, warm
+    assert(lifecycle.tradable("0xevent"));
+    lifecycle.advance(at(86400));
+    assert(lifecycle.session("0xevent") && lifecycle.size() == 1 && lifecycle.pending_timers() == 0);
+
+    // Prefetch runs on a bounded pool: 12 windows of 50ms each, never more than 4 at once
+    {
+        Config pooled = config;
+        pooled.market_prefetch_workers = 4;
+        MarketLifecycle parallel(pooled);
+        std::atomic<int> running{0};
+        std::atomic<int> peak{0};
+        parallel.on_prefetch([&running, &peak](MarketSession &)
+                             {
+            int now = ++running;
+            int seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now))
+            {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            running--;
+            return true; });
+        std::set<std::string> batch;
+        parallel.on_subscribe([&batch](const std::vector<MarketState> &markets)
+                              {
+            for (const auto &m : markets)
+                batch.insert(m.condition_id); });
+
+        std::vector<MarketState> windows;
+        for (const char *symbol : {"btc", "eth", "sol", "xrp", "doge", "bnb"})
+        {
+            windows.push_back(make_window(symbol, t0));
+            windows.push_back(make_window(symbol, t0 + 900));
+        }
+        assert(parallel.add(windows, "15m", at(60)) == 12);
+
+        auto started = std::chrono::steady_clock::now();
+        parallel.start(at(60));
+        auto elapsed = std::chrono::steady_clock::now() - started;
+        assert(peak.load() == 4 && elapsed < std::chrono::milliseconds(400));
+        assert(parallel.counts().pending == 6 && batch.size() == 6); // The open windows, subscribed
+    }
+
+    std::cout << "test_market_lifecycle passed\n";
+    return 0;
+}
@@ -0,0 +1,101 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "market_table.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+
+using namespace polymarket;
+
+int main()
+{
+    {
+        // Ids are dense and reused; capacity pads to whole vectors
+        MarketTable table(5);
+        assert(table.capacity() == 8);
+        assert(table.assign("a") == 0 && table.assign("b") == 1 && table.assign("a") == 0);
+        table.release(0);
+        assert(table.condition_id(0).empty() && table.size() == 1);
+        assert(table.assign("c") == 0 && table.condition_id(0) == "c");
+        for (int i = 0; i < 6; i++)
+        {
+            assert(table.assign(std::to_string(i)) != MarketTable::INVALID_ID);
+        }
+        assert(table.assign("overflow") == MarketTable::INVALID_ID);
+    }
+
+    {
+        // Each filter on its own, through every kernel this CPU has
+        MarketTable table(16);
+        uint32_t cheap = table.assign("cheap");
+        uint32_t thin = table.assign("thin");
+        uint32_t old = table.assign("old");
+        uint32_t dear = table.assign("dear");
+        uint32_t half = table.assign("half"); // One leg never priced
+        table.store(cheap, true, 0.45, 50.0, 1000);
+        table.store(cheap, false, 0.50, 50.0, 1000);
+        table.store(thin, true, 0.45, 2.0, 1000);
+        table.store(thin, false, 0.50, 50.0, 1000);
+        table.store(old, true, 0.45, 50.0, 100);
+        table.store(old, false, 0.50, 50.0, 1000);
+        table.store(dear, true, 0.50, 50.0, 1000);
+        table.store(dear, false, 0.50, 50.0, 1000);
+        table.store(half, true, 0.10, 50.0, 1000);
+
+        MarketScanFilter filter;
+        filter.max_combined = 0.98;
+        filter.min_size = 5.0;
+        filter.max_age_ns = 500;
+        filter.now_ns = 1200;
+
+        for (auto kernel : {ScanKernel::SCALAR, ScanKernel::AVX2, ScanKernel::AVX512})
+        {
+            if (!MarketTable::kernel_supported(kernel))
+            {
+                continue;
+            }
+            std::vector<uint32_t> hits;
+            assert(table.scan(filter, hits, kernel) == 1 && hits[0] == cheap);
+
+            // Without the size and age filters the thin and old markets match too
+            MarketScanFilter loose{0.98, 0.0, 0, 0};
+            hits.clear();
+            assert(table.scan(loose, hits, kernel) == 3);
+            assert(hits[0] == cheap && hits[1] == thin && hits[2] == old);
+        }
+
+        // A cleared leg drops out
+        table.store(cheap, false, 0.0, 0.0, 1100);
+        std::vector<uint32_t> hits;
+        assert(table.scan(filter, hits) == 0);
+    }
+
+    {
+        // Kernels agree on random data
+        constexpr size_t MARKETS = 1000;
+        MarketTable table(MARKETS);
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> price(0.3, 0.7);
+        std::uniform_real_distribution<double> size(0.0, 100.0);
+        std::uniform_int_distribution<uint64_t> age(0, 2000);
+        for (size_t i = 0; i < MARKETS - 3; i++)
+        {
+            uint32_t id = table.assign(std::to_string(i));
+            table.store(id, true, price(rng), size(rng), 10000 - age(rng));
+            table.store(id, false, price(rng), size(rng), 10000 - age(rng));
+        }
+
+        MarketScanFilter filter{0.9, 20.0, 1000, 10000};
+        std::vector<uint32_t> expected;
+        table.scan(filter, expected, ScanKernel::SCALAR);
+        assert(!expected.empty());
+        for (auto kernel : {ScanKernel::AVX2, ScanKernel::AVX512, ScanKernel::AUTO})
+        {
+            std::vector<uint32_t> hits;
+            table.scan(filter, hits, kernel);
+            assert(hits == expected);
+        }
+    }
+
+    std::cout << "test_market_table passed (" << MarketTable::kernel_name(ScanKernel::AUTO) << ")\n";
+    return 0;
+}
@@ -0,0 +1,73 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "mpsc_queue.hpp"
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace polymarket;
+
+int main()
+{
+    {
+        // Capacity rounds up to a power of two; FIFO order; full ring refuses pushes
+        MpscQueue<int> queue(3);
+        assert(queue.capacity() == 4);
+        for (int i = 0; i < 4; i++)
+        {
+            assert(queue.try_push(int(i)));
+        }
+        assert(!queue.try_push(99));
+        assert(queue.size() == 4 && queue.high_water_mark() == 4);
+
+        int value = -1;
+        assert(queue.try_pop(value) && value == 0);
+        assert(queue.try_push(4));
+        for (int expected = 1; expected <= 4; expected++)
+        {
+            assert(queue.try_pop(value) && value == expected);
+        }
+        assert(!queue.try_pop(value) && queue.size() == 0);
+    }
+
+    {
+        // Concurrent producers: every event arrives once, each producer's events in order
+        constexpr int PRODUCERS = 4;
+        constexpr int COUNT = 50000;
+        MpscQueue<std::pair<int, int>> queue(32);
+        std::vector<std::thread> producers;
+        for (int p = 0; p < PRODUCERS; p++)
+        {
+            producers.emplace_back([&queue, p]()
+                                   {
+                for (int i = 0; i < COUNT; i++)
+                {
+                    while (!queue.try_push({p, i}))
+                    {
+                        std::this_thread::yield();
+                    }
+                } });
+        }
+
+        std::vector<int> next(PRODUCERS, 0);
+        std::pair<int, int> event;
+        for (int received = 0; received < PRODUCERS * COUNT;)
+        {
+            if (queue.try_pop(event))
+            {
+                assert(event.second == next[event.first]);
+                next[event.first]++;
+                received++;
+            }
+        }
+        for (auto &producer : producers)
+        {
+            producer.join();
+        }
+        assert(!queue.try_pop(event));
+    }
+
+    std::cout << "test_mpsc_queue passed\n";
+    return 0;
+}
@@ -0,0 +1,151 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "neg_risk_scanner.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+using namespace polymarket;
+
+namespace
+{
+    bool near(double a, double b) { return std::fabs(a - b) < 1e-9; }
+
+    MarketState make_market(const std::string &condition_id, const std::string &event_id, size_t outcomes)
+    {
+        MarketState market;
+        market.condition_id = condition_id;
+        market.token_yes = condition_id + "-yes";
+        market.token_no = condition_id + "-no";
+        market.neg_risk = true;
+        market.neg_risk_market_id = event_id;
+        market.neg_risk_outcomes = outcomes;
+        return market;
+    }
+
+    Orderbook make_book(double bid, double bid_size, double ask, double ask_size)
+    {
+        Orderbook book{};
+        if (bid > 0.0)
+            book.bids = {{bid - 0.01, 500.0}, {bid, bid_size}};
+        if (ask > 0.0)
+            book.asks = {{ask + 0.01, 500.0}, {ask, ask_size}};
+        return book;
+    }
+} // namespace
+
+int main()
+{
+    Config config;
+    config.neg_risk_min_edge = 0.01;
+    config.size_usdc = 0.0; // Size by depth only
+
+    NegRiskScanner scanner(config);
+    std::vector<BasketOpportunity> seen;
+    scanner.on_opportunity([&seen](const BasketOpportunity &opportunity)
+                           { seen.push_back(opportunity); });
+    scanner.enable_queue(8);
+
+    // Three-outcome event; a lone-outcome event and a binary market without an event are ignored
+    scanner.add_markets({make_market("a", "ev1", 3), make_market("b", "ev1", 3), make_market("c", "ev1", 3),
+                         make_market("lone", "ev2", 1), make_market("plain", "", 0)});
+    assert(scanner.event_count() == 1);
+    assert(!scanner.quote("ev2"));
+
+    // No opportunity until every leg has a price
+    scanner.on_book("a-yes", make_book(0.28, 40.0, 0.30, 100.0));
+    scanner.on_book("b-yes", make_book(0.28, 40.0, 0.30, 20.0));
+    scanner.on_book("unknown", make_book(0.10, 1.0, 0.12, 1.0));
+    auto quote = scanner.quote("ev1");
+    assert(quote && quote->outcomes == 3 && quote->expected_outcomes == 3);
+    assert(quote->missing_asks == 1 && near(quote->ask_sum, 0.60));
+    assert(seen.empty() && scanner.updates() == 2);
+
+    // Ask sum 0.90 < 0.99: buy every YES, sized by the thinnest leg
+    scanner.on_book("c-yes", make_book(0.28, 40.0, 0.30, 50.0));
+    assert(seen.size() == 1);
+    assert(seen[0].side == BasketSide::BUY_YES && seen[0].event_id == "ev1");
+    assert(near(seen[0].price_sum, 0.90) && near(seen[0].edge_per_share, 0.10));
+    assert(near(seen[0].shares, 20.0) && seen[0].legs.size() == 3);
+    assert(seen[0].legs[1].token_id == "b-yes" && near(seen[0].legs[1].size, 20.0));
+
+    // Still crossed: edge-triggered, no repeat
+    scanner.on_book("a-yes", make_book(0.28, 40.0, 0.31, 100.0));
+    assert(seen.size() == 1);
+
+    // Leaves the opportunity, then crosses again
+    scanner.on_book("a-yes", make_book(0.28, 40.0, 0.40, 100.0));
+    quote = scanner.quote("ev1");
+    assert(near(quote->ask_sum, 1.00));
+    scanner.on_book("a-yes", make_book(0.28, 40.0, 0.35, 100.0));
+    assert(seen.size() == 2 && near(seen[1].price_sum, 0.95));
+
+    // An emptied ask side takes the leg out of the sum and the basket
+    scanner.on_book("b-yes", make_book(0.28, 40.0, 0.0, 0.0));
+    quote = scanner.quote("ev1");
+    assert(quote->missing_asks == 1 && near(quote->ask_sum, 0.65));
+
+    // Bid sum 0.40 + 0.35 + 0.30 > 1.01: sell every YES
+    scanner.on_book("b-yes", make_book(0.35, 15.0, 0.40, 10.0));
+    scanner.on_book("c-yes", make_book(0.30, 25.0, 0.45, 50.0));
+    scanner.on_book("a-yes", make_book(0.40, 30.0, 0.42, 100.0));
+    assert(seen.size() == 3 && seen[2].side == BasketSide::SELL_YES);
+    assert(near(seen[2].price_sum, 1.05) && near(seen[2].edge_per_share, 0.05) && near(seen[2].shares, 15.0));
+
+    // Queue got the same opportunities
+    BasketOpportunity polled;
+    size_t polled_count = 0;
+    while (scanner.poll(polled))
+    {
+        assert(polled.side == seen[polled_count].side && near(polled.price_sum, seen[polled_count].price_sum));
+        polled_count++;
+    }
+    assert(polled_count == 3 && scanner.opportunities() == 3 && scanner.dropped() == 0);
+
+    // Running sums stay exact across many ticks and resyncs
+    for (int i = 0; i < 5000; i++)
+    {
+        double ask = 0.30 + 0.01 * (i % 7);
+        scanner.on_book(i % 2 ? "a-yes" : "c-yes", make_book(0.20, 10.0, ask, 10.0));
+    }
+    scanner.on_book("a-yes", make_book(0.20, 10.0, 0.33, 10.0));
+    scanner.on_book("c-yes", make_book(0.20, 10.0, 0.33, 10.0));
+    quote = scanner.quote("ev1");
+    assert(std::fabs(quote->ask_sum - 1.06) < 1e-9 && std::fabs(quote->bid_sum - 0.75) < 1e-9);
+
+    // Capped by size_usdc when set
+    config.size_usdc = 9.0;
+    NegRiskScanner capped(config);
+    capped.add_markets({make_market("x", "ev3", 2), make_market("y", "ev3", 2)});
+    BasketOpportunity last;
+    capped.on_opportunity([&last](const BasketOpportunity &opportunity)
+                          { last = opportunity; });
+    capped.on_book("x-yes", make_book(0.40, 10.0, 0.45, 100.0));
+    capped.on_book("y-yes", make_book(0.40, 10.0, 0.45, 100.0));
+    assert(capped.opportunities() == 1 && near(last.shares, 10.0));
+
+    // Partial events: two of three outcomes, or an unknown count, never buy the basket;
+    // selling YES on a subset still pays at most 1
+    NegRiskScanner partial(config);
+    partial.add_markets({make_market("p", "ev4", 3), make_market("q", "ev4", 3),
+                         make_market("u", "ev5", 0), make_market("v", "ev5", 0)});
+    std::vector<BasketOpportunity> partial_seen;
+    partial.on_opportunity([&partial_seen](const BasketOpportunity &opportunity)
+                           { partial_seen.push_back(opportunity); });
+    for (const char *token : {"p-yes", "q-yes", "u-yes", "v-yes"})
+    {
+        partial.on_book(token, make_book(0.30, 10.0, 0.40, 10.0));
+    }
+    assert(partial.quote("ev4")->missing_asks == 0 && near(partial.quote("ev4")->ask_sum, 0.80));
+    assert(partial_seen.empty());
+    partial.on_book("p-yes", make_book(0.72, 10.0, 0.75, 10.0));
+    assert(partial_seen.size() == 1 && partial_seen[0].side == BasketSide::SELL_YES && partial_seen[0].event_id == "ev4");
+
+    // The missing outcome arrives: the basket is complete and can be bought
+    partial.add_markets({make_market("r", "ev4", 3)});
+    partial.on_book("p-yes", make_book(0.30, 10.0, 0.40, 10.0));
+    partial.on_book("r-yes", make_book(0.10, 10.0, 0.15, 10.0));
+    assert(partial_seen.size() == 2 && partial_seen[1].side == BasketSide::BUY_YES && partial_seen[1].legs.size() == 3);
+
+    std::cout << "test_neg_risk_scanner passed\n";
+    return 0;
+}
@@ -0,0 +1,129 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "order_store.hpp"
+#include "user_channel.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+using namespace polymarket;
+
+namespace
+{
+    bool near(double a, double b) { return std::fabs(a - b) < 1e-9; }
+
+    SignedOrder make_order(const std::string &token_id, int side, const std::string &maker, const std::string &taker)
+    {
+        SignedOrder order{};
+        order.token_id = token_id;
+        order.side = side;
+        order.maker_amount = maker;
+        order.taker_amount = taker;
+        return order;
+    }
+
+    OrderResponse make_response(const std::string &id, const std::string &status)
+    {
+        OrderResponse response{};
+        response.success = true;
+        response.order_id = id;
+        response.status = status;
+        return response;
+    }
+} // namespace
+
+int main()
+{
+    OrderStore store;
+
+    // BUY 10 shares @ 0.47 (4.7 USDC for 10 shares) rests on the book
+    store.on_post(make_order("123", 0, "4700000", "10000000"), make_response("0xa", "live"));
+    auto order = store.get("0xa");
+    assert(order && order->state == OrderState::LIVE && order->side == OrderSide::BUY);
+    assert(near(order->price, 0.47) && near(order->original_size, 10.0));
+    assert(near(store.working_size("123", OrderSide::BUY), 10.0) && store.open_count() == 1);
+
+    // SELL 5 shares @ 0.60 on the same token
+    store.on_post(make_order("123", 1, "5000000", "3000000"), make_response("0xb", "live"));
+    assert(near(store.working_size("123", OrderSide::SELL), 5.0));
+    assert(near(store.get("0xb")->price, 0.6));
+
+    // Placement names the market; an update with its trade, then that trade's event, counts once
+    auto events = UserChannelClient::parse_events(R"([
+        {"event_type": "order", "type": "PLACEMENT", "id": "0xa", "market": "0xcond", "asset_id": "123",
+         "side": "BUY", "price": "0.47", "original_size": "10", "size_matched": "0"},
+        {"event_type": "order", "type": "UPDATE", "id": "0xa", "market": "0xcond", "asset_id": "123",
+         "side": "BUY", "price": "0.47", "original_size": "10", "size_matched": "4", "associate_trades": ["t1"]},
+        {"event_type": "trade", "id": "t1", "taker_order_id": "0xother", "market": "0xcond", "asset_id": "123",
+         "side": "SELL", "size": "4", "price": "0.47", "status": "MATCHED",
+         "maker_orders": [{"order_id": "0xa", "asset_id": "123", "matched_amount": "4", "price": "0.47"}]}
+    ])");
+    for (const auto &event : events)
+    {
+        if (const auto *o = std::get_if<UserOrderEvent>(&event))
+            store.on_user_order(*o);
+        else
+            store.on_user_trade(std::get<UserTradeEvent>(event));
+    }
+    order = store.get("0xa");
+    assert(order->state == OrderState::PARTIALLY_FILLED && near(order->size_matched, 4.0));
+    assert(near(store.working_size("123", OrderSide::BUY), 6.0));
+    assert(store.open_orders("0xcond").size() == 1);
+
+    // A trade seen before the order update is not double counted either
+    events = UserChannelClient::parse_events(R"([
+        {"event_type": "trade", "id": "t2", "taker_order_id": "0xother", "market": "0xcond", "asset_id": "123",
+         "side": "SELL", "size": "6", "price": "0.47", "status": "MATCHED",
+         "maker_orders": [{"order_id": "0xa", "asset_id": "123", "matched_amount": "6", "price": "0.47"}]},
+        {"event_type": "trade", "id": "t2", "taker_order_id": "0xother", "market": "0xcond", "asset_id": "123",
+         "side": "SELL", "size": "6", "price": "0.47", "status": "CONFIRMED",
+         "maker_orders": [{"order_id": "0xa", "asset_id": "123", "matched_amount": "6", "price": "0.47"}]},
+        {"event_type": "order", "type": "UPDATE", "id": "0xa", "market": "0xcond", "asset_id": "123",
+         "side": "BUY", "price": "0.47", "original_size": "10", "size_matched": "10", "associate_trades": ["t1", "t2"]}
+    ])");
+    for (const auto &event : events)
+    {
+        if (const auto *o = std::get_if<UserOrderEvent>(&event))
+            store.on_user_order(*o);
+        else
+            store.on_user_trade(std::get<UserTradeEvent>(event));
+    }
+    order = store.get("0xa");
+    assert(order->state == OrderState::FILLED && near(order->size_matched, 10.0));
+    assert(near(store.working_size("123", OrderSide::BUY), 0.0) && store.open_count() == 1);
+
+    // Cancel ack is terminal: a late "live" response does not reopen the order
+    store.on_cancel({"0xb"});
+    assert(store.get("0xb")->state == OrderState::CANCELED && store.open_count() == 0);
+    store.on_post(make_order("123", 1, "5000000", "3000000"), make_response("0xb", "live"));
+    assert(store.get("0xb")->state == OrderState::CANCELED);
+    assert(near(store.working_size("123", OrderSide::SELL), 0.0));
+
+    // FAK remainder is killed
+    store.on_post(make_order("456", 0, "5000000", "10000000"), [] {
+        auto response = make_response("0xc", "matched");
+        response.taking_amount = "3";
+        return response; }(), OrderType::FAK);
+    order = store.get("0xc");
+    assert(order->state == OrderState::CANCELED && near(order->size_matched, 3.0));
+
+    // Reconcile: snapshot values win, missing orders past the grace window close
+    store.on_post(make_order("789", 0, "2000000", "4000000"), make_response("0xd", "live"));
+    store.on_post(make_order("789", 0, "1000000", "2000000"), make_response("0xe", "live"));
+    OpenOrder open{};
+    open.id = "0xd";
+    open.market = "0xcond2";
+    open.asset_id = "789";
+    open.side = "BUY";
+    open.original_size = "4";
+    open.size_matched = "1";
+    open.price = "0.5";
+    store.reconcile({open}, "", std::chrono::milliseconds(0));
+    assert(store.get("0xd")->state == OrderState::PARTIALLY_FILLED);
+    assert(store.get("0xe")->state == OrderState::CLOSED);
+    assert(near(store.working_size("789", OrderSide::BUY), 3.0));
+    assert(store.exposure("789").open_orders == 1 && store.open_count() == 1);
+    assert(store.open_orders().size() == 1 && store.open_orders("0xcond2").size() == 1);
+
+    std::cout << "test_order_store passed\n";
+    return 0;
+}
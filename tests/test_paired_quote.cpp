@@ -0,0 +1,74 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "types.hpp"
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace polymarket;
+
+int main()
+{
+    {
+        // Leg stores land in one snapshot; zero update time keeps the previous one
+        PairedQuote quote;
+        quote.store(true, 0.45, 100.0, 1000);
+        quote.store(false, 0.52, 50.0);
+        auto snapshot = quote.load();
+        assert(snapshot.ask_yes == 0.45 && snapshot.ask_yes_size == 100.0);
+        assert(snapshot.ask_no == 0.52 && snapshot.ask_no_size == 50.0);
+        assert(snapshot.last_update_ns == 1000 && snapshot.version == 2);
+        assert(snapshot.complete() && snapshot.combined() == 0.45 + 0.52);
+        assert(alignof(LiveMarketState) == CACHE_LINE_SIZE);
+    }
+
+    {
+        // Writer stores YES = i then NO = i: a reader may see YES one ahead, never a torn or
+        // out-of-date pair, and version always counts exactly the legs it reflects
+        constexpr int COUNT = 200000;
+        PairedQuote quote;
+        std::thread writer([&quote]()
+                           {
+            for (int i = 1; i <= COUNT; i++)
+            {
+                quote.store(true, i, i * 2.0, i);
+                quote.store(false, i, i * 2.0, i);
+            } });
+
+        QuoteSnapshot snapshot;
+        do
+        {
+            snapshot = quote.load();
+            double lead = snapshot.ask_yes - snapshot.ask_no;
+            assert(lead == 0.0 || lead == 1.0);
+            assert(snapshot.ask_yes_size == snapshot.ask_yes * 2.0 && snapshot.ask_no_size == snapshot.ask_no * 2.0);
+            assert(snapshot.version == static_cast<uint64_t>(snapshot.ask_yes + snapshot.ask_no));
+        } while (snapshot.ask_no < COUNT);
+        writer.join();
+    }
+
+    {
+        // Two writers (arbitrated feeds) on different legs: no lost or torn leg updates
+        constexpr int COUNT = 100000;
+        PairedQuote quote;
+        std::vector<std::thread> writers;
+        for (bool yes_leg : {true, false})
+        {
+            writers.emplace_back([&quote, yes_leg]()
+                                 {
+                for (int i = 1; i <= COUNT; i++)
+                {
+                    quote.store(yes_leg, i, i * 2.0);
+                } });
+        }
+        for (auto &writer : writers)
+        {
+            writer.join();
+        }
+        auto snapshot = quote.load();
+        assert(snapshot.ask_yes == COUNT && snapshot.ask_no == COUNT && snapshot.version == 2 * COUNT);
+    }
+
+    std::cout << "test_paired_quote passed\n";
+    return 0;
+}
@@ -0,0 +1,106 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "spsc_queue.hpp"
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace polymarket;
+
+int main()
+{
+    {
+        // Capacity rounds up to a power of two; FIFO order; full ring refuses pushes
+        SpscQueue<int> queue(3);
+        assert(queue.capacity() == 4);
+        for (int i = 0; i < 4; i++)
+        {
+            assert(queue.try_push(int(i)));
+        }
+        assert(!queue.try_push(99));
+        assert(queue.size() == 4 && queue.high_water_mark() == 4);
+
+        int value = -1;
+        assert(queue.try_pop(value) && value == 0);
+        assert(queue.try_push(4));
+        for (int expected = 1; expected <= 4; expected++)
+        {
+            assert(queue.try_pop(value) && value == expected);
+        }
+        assert(!queue.try_pop(value));
+    }
+
+    {
+        // DROP_OLDEST keeps the newest events
+        SpscQueue<int> queue(4);
+        size_t dropped = 0;
+        for (int i = 0; i < 10; i++)
+        {
+            dropped += queue.push_drop_oldest(int(i));
+        }
+        assert(dropped == 6);
+        int value = -1;
+        for (int expected = 6; expected < 10; expected++)
+        {
+            assert(queue.try_pop(value) && value == expected);
+        }
+    }
+
+    {
+        // Producer and consumer threads: nothing lost, nothing reordered
+        constexpr int COUNT = 200000;
+        SpscQueue<std::vector<int>> queue(64);
+        std::thread producer([&]()
+                             {
+            for (int i = 0; i < COUNT; i++)
+            {
+                std::vector<int> event{i, i * 2};
+                while (!queue.try_push(std::move(event)))
+                {
+                    std::this_thread::yield();
+                }
+            } });
+
+        std::vector<int> event;
+        for (int expected = 0; expected < COUNT;)
+        {
+            if (queue.try_pop(event))
+            {
+                assert(event.size() == 2 && event[0] == expected && event[1] == expected * 2);
+                expected++;
+            }
+        }
+        producer.join();
+    }
+
+    {
+        // Concurrent DROP_OLDEST: consumer sees a strictly increasing subsequence ending at the last event
+        constexpr int COUNT = 200000;
+        SpscQueue<int> queue(16);
+        size_t dropped = 0;
+        std::thread producer([&]()
+                             {
+            for (int i = 0; i < COUNT; i++)
+            {
+                dropped += queue.push_drop_oldest(int(i));
+            } });
+
+        int last = -1;
+        size_t received = 0;
+        int value = -1;
+        while (last != COUNT - 1)
+        {
+            if (queue.try_pop(value))
+            {
+                assert(value > last);
+                last = value;
+                received++;
+            }
+        }
+        producer.join();
+        assert(received + dropped == static_cast<size_t>(COUNT));
+    }
+
+    std::cout << "test_spsc_queue passed\n";
+    return 0;
+}
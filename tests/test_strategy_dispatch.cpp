@@ -0,0 +1,82 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "orderbook_impl.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+using namespace polymarket;
+
+namespace
+{
+    bool near(double a, double b) { return std::fabs(a - b) < 1e-9; }
+
+    // Only overrides what it needs; the rest come from StrategyBase
+    struct RecordingStrategy : StrategyBase
+    {
+        int books = 0;
+        std::vector<QuoteSnapshot> tops;
+        std::vector<ArbSignal> arbs;
+
+        void on_book(const std::string &, const Orderbook &) { books++; }
+        void on_top_of_book_change(const std::string &, const QuoteSnapshot &top) { tops.push_back(top); }
+        void on_arb(const ArbSignal &signal) { arbs.push_back(signal); }
+    };
+
+    std::string book_message(const std::string &asset_id, const std::string &asks)
+    {
+        return R"({"event_type": "book", "market": "0xc", "asset_id": ")" + asset_id +
+               R"(", "bids": [], "asks": [)" + asks + "]}";
+    }
+} // namespace
+
+int main()
+{
+    Config config;
+    config.trigger_combined = 0.98;
+    config.size_usdc = 100.0;
+
+    MarketState market;
+    market.condition_id = "0xc";
+    market.slug = "test";
+    market.token_yes = "11";
+    market.token_no = "22";
+
+    BasicOrderbookManager<RecordingStrategy> manager(config);
+    manager.subscribe(market);
+    auto &strategy = manager.strategy();
+
+    // First leg: a book and a top change, no arb yet
+    manager.inject_message(FeedSource::CLOB, book_message("11", R"({"price": "0.45", "size": "10"})"));
+    assert(strategy.books == 1 && strategy.tops.size() == 1 && strategy.arbs.empty());
+    assert(near(strategy.tops[0].ask_yes, 0.45) && strategy.tops[0].ask_no == 0.0);
+
+    // Second leg clears the trigger
+    manager.inject_message(FeedSource::CLOB, book_message("22", R"({"price": "0.50", "size": "20"})"));
+    assert(strategy.books == 2 && strategy.tops.size() == 2 && strategy.arbs.size() == 1);
+    assert(near(strategy.tops[1].combined(), 0.95));
+    assert(strategy.arbs[0].condition_id == "0xc" && near(strategy.arbs[0].executable.shares, 10.0));
+
+    // Depth below the top changed, the top did not: book and arb, no top change
+    manager.inject_message(FeedSource::CLOB, book_message("22", R"({"price": "0.50", "size": "20"}, {"price": "0.60", "size": "5"})"));
+    assert(strategy.books == 3 && strategy.tops.size() == 2 && strategy.arbs.size() == 2);
+
+    // Unknown tokens never reach the strategy
+    manager.inject_message(FeedSource::CLOB, book_message("33", R"({"price": "0.10", "size": "1"})"));
+    assert(strategy.books == 3);
+
+    // The std::function manager takes the same hooks at runtime
+    OrderbookManager callbacks(config);
+    callbacks.subscribe(market);
+    int tops = 0;
+    int arbs = 0;
+    callbacks.on_top_of_book_change([&tops](const std::string &condition_id, const QuoteSnapshot &)
+                                    { tops += condition_id == "0xc"; });
+    callbacks.on_arb_opportunity([&arbs](const ArbSignal &)
+                                 { arbs++; });
+    callbacks.inject_message(FeedSource::CLOB, book_message("11", R"({"price": "0.45", "size": "10"})"));
+    callbacks.inject_message(FeedSource::CLOB, book_message("22", R"({"price": "0.50", "size": "20"})"));
+    assert(tops == 2 && arbs == 1 && callbacks.arb_opportunities() == 1);
+
+    std::cout << "test_strategy_dispatch passed\n";
+    return 0;
+}
@@ -0,0 +1,55 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "timer_wheel.hpp"
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+using namespace polymarket;
+
+int main()
+{
+    // 10ms ticks, 8 slots: one revolution is 80ms
+    TimerWheel<int> wheel(10, 8, 1000);
+    std::vector<int> fired;
+    auto record = [&fired](int payload)
+    { fired.push_back(payload); };
+
+    wheel.schedule(1025, 1);
+    wheel.schedule(1015, 2);
+    auto cancelled = wheel.schedule(1020, 3);
+    wheel.schedule(1500, 4); // Several revolutions out, shares a slot with nearer deadlines
+    wheel.schedule(900, 5);  // Already due
+    assert(wheel.size() == 5);
+
+    assert(wheel.cancel(cancelled) && !wheel.cancel(cancelled));
+    assert(wheel.advance(1000, record) == 1 && fired == std::vector<int>({5}));
+
+    // Due timers fire in deadline order; one in the current tick but later waits
+    assert(wheel.advance(1024, record) == 1 && fired.back() == 2);
+    assert(wheel.advance(1025, record) == 1 && fired.back() == 1);
+
+    // Passing 1500's slot on earlier revolutions does not fire it
+    assert(wheel.advance(1100, record) == 0 && wheel.advance(1420, record) == 0);
+    assert(wheel.size() == 1);
+
+    // A gap of many revolutions visits every slot once
+    wheel.schedule(1430, 6);
+    assert(wheel.advance(5000, record) == 2);
+    assert(fired[fired.size() - 2] == 6 && fired.back() == 4 && wheel.size() == 0);
+
+    // Callbacks may reschedule; the new timer fires on a later advance
+    int rearmed = 0;
+    wheel.schedule(5010, 7);
+    wheel.advance(5010, [&](int payload)
+                  {
+        rearmed++;
+        if (payload == 7)
+            wheel.schedule(5010, 8); });
+    assert(rearmed == 1 && wheel.size() == 1);
+    wheel.advance(5011, [&](int payload)
+                  { rearmed += payload == 8; });
+    assert(rearmed == 2 && wheel.size() == 0);
+
+    std::cout << "test_timer_wheel passed\n";
+    return 0;
+}
@@ -0,0 +1,55 @@
+#undef NDEBUG // keep asserts active in Release builds
+#include "user_channel.hpp"
+#include <cassert>
+#include <iostream>
+
+using namespace polymarket;
+
+int main()
+{
+    // Order placement, then a partial match
+    auto events = UserChannelClient::parse_events(R"([
+        {"event_type": "order", "type": "PLACEMENT", "id": "0xorder1", "market": "0xcond",
+         "asset_id": "123", "side": "BUY", "outcome": "Up", "price": "0.47",
+         "original_size": "10", "size_matched": "0", "associate_trades": null, "timestamp": "1767170700123"},
+        {"event_type": "order", "type": "UPDATE", "id": "0xorder1", "market": "0xcond",
+         "asset_id": "123", "side": "BUY", "price": "0.47", "original_size": "10",
+         "size_matched": "4", "associate_trades": ["trade-1"], "timestamp": "1767170700456"}
+    ])");
+    assert(events.size() == 2);
+
+    const auto &placement = std::get<UserOrderEvent>(events[0]);
+    assert(placement.type == UserOrderEventType::PLACEMENT);
+    assert(placement.id == "0xorder1" && placement.market == "0xcond" && placement.outcome == "Up");
+    assert(placement.price == 0.47 && placement.original_size == 10.0 && placement.size_matched == 0.0);
+    assert(placement.associate_trades.empty());
+    assert(placement.timestamp_ms == 1767170700123ULL && placement.received_ns > 0);
+
+    const auto &update = std::get<UserOrderEvent>(events[1]);
+    assert(update.type == UserOrderEventType::UPDATE && update.size_matched == 4.0);
+    assert(update.associate_trades.size() == 1 && update.associate_trades[0] == "trade-1");
+
+    // Trade with our maker fills
+    events = UserChannelClient::parse_events(R"({
+        "event_type": "trade", "id": "trade-1", "taker_order_id": "0xtaker", "market": "0xcond",
+        "asset_id": "123", "side": "BUY", "size": "4", "price": "0.47", "status": "MATCHED",
+        "outcome": "Up", "timestamp": "1767170700456",
+        "maker_orders": [{"order_id": "0xorder1", "asset_id": "123", "outcome": "Up",
+                          "matched_amount": "4", "price": "0.47"}]
+    })");
+    assert(events.size() == 1);
+    const auto &trade = std::get<UserTradeEvent>(events[0]);
+    assert(trade.status == TradeStatus::MATCHED && trade.id == "trade-1");
+    assert(trade.taker_order_id == "0xtaker" && trade.size == 4.0 && trade.price == 0.47);
+    assert(trade.maker_orders.size() == 1);
+    assert(trade.maker_orders[0].order_id == "0xorder1" && trade.maker_orders[0].matched_amount == 4.0);
+
+    // Cancellation and unknown event types
+    events = UserChannelClient::parse_events(R"([{"event_type": "order", "type": "CANCELLATION", "id": "0xorder2"},
+                                                 {"event_type": "last_trade_price"}])");
+    assert(events.size() == 1);
+    assert(std::get<UserOrderEvent>(events[0]).type == UserOrderEventType::CANCELLATION);
+
+    std::cout << "test_user_channel passed\n";
+    return 0;
+}